@@ -0,0 +1,238 @@
+#pragma once
+
+// ============================================================================
+// AcquisitionTask — deterministic sensor sampling off the SensESP loop
+// ============================================================================
+//
+// • FreeRTOS task pinned to APP_CPU (core 1, WiFi/lwIP live on core 0) at a
+//   priority above loopTask → a stalled Signal K websocket can delay the
+//   event loop, never the sampling
+// • Sources split their work:
+//     acquire()  task context   — touch hardware, compute, publish()
+//     deliver()  event loop     — emit into the SensESP transform graph
+// • publish() pushes a timestamped sample through a lock-free SPSC ring;
+//   the event loop drains it every DRAIN_INTERVAL_MS
+// • Without a task (nullptr) sources run acquire() from onRepeat and
+//   publish() delivers inline — same code path, used by simulators
+// • Sources may be added after start() (deferred boot stage): the slot is
+//   filled first, then published by the release store of the count
+// • Between passes the task blocks until the earliest source is due
+//   (≤ MAX_IDLE_MS), not for one tick → idle time the power manager can
+//   spend in light sleep
+// ============================================================================
+
+#include <Arduino.h>
+#include <esp_log.h>
+
+#include <atomic>
+
+#include "sensesp_app.h"
+
+#include "pipeline_profiler.h"
+#include "spsc_queue.h"
+
+using namespace sensesp;
+
+// FreeRTOS task name (also used by SystemDiagnostics for the stack watermark)
+static constexpr const char* ACQUISITION_TASK_NAME = "acquire";
+
+class AcquisitionTask;
+
+// ============================================================================
+// Source interface
+// ============================================================================
+class AcquisitionSource {
+ public:
+  virtual ~AcquisitionSource() {}
+
+  // Task context: sample hardware, call publish() for each result
+  virtual void acquire(uint32_t now_ms) = 0;
+
+  // Event loop context: hand one sample to the transform graph
+  virtual void deliver(uint16_t channel, float value, uint32_t t_ms) = 0;
+
+ protected:
+  inline void publish(uint16_t channel, float value, uint32_t t_ms);
+
+  // Register with the task, or run acquire() from the event loop
+  inline void schedule(AcquisitionTask* task, uint32_t period_ms);
+
+ private:
+  AcquisitionTask* task_ = nullptr;
+};
+
+// ============================================================================
+// Task
+// ============================================================================
+class AcquisitionTask {
+ public:
+  struct Sample {
+    AcquisitionSource* source;
+    uint16_t           channel;
+    uint32_t           t_ms;
+    float              value;
+  };
+
+  static constexpr size_t   MAX_SOURCES       = 8;
+  static constexpr size_t   QUEUE_LENGTH      = 128;   // ~0.5 s of all sources
+  static constexpr uint32_t DRAIN_INTERVAL_MS = 5;
+
+  // Event loop / setup context only (single writer)
+  bool add(AcquisitionSource* source, uint32_t period_ms) {
+    const size_t n = num_sources_.load(std::memory_order_relaxed);
+    if (n >= MAX_SOURCES) {
+      ESP_LOGE("Acq", "Cannot add acquisition source");
+      return false;
+    }
+
+    Slot& s     = sources_[n];
+    s.source    = source;
+    s.period_ms = (period_ms > 0) ? period_ms : 1;
+    s.next_ms   = millis() + s.period_ms;
+
+    num_sources_.store(n + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Call once, after every source has been registered
+  void start() {
+    if (started_) {
+      return;
+    }
+
+    perf_repeat("acq_drain", DRAIN_INTERVAL_MS, [this]() { this->drain(); });
+    start_task();
+  }
+
+  // Sampling task only: the caller runs drain() from its own loop
+  // (on-target perf suite, no SensESP app)
+  void start_task() {
+    if (started_) {
+      return;
+    }
+    started_ = true;
+
+    const uint32_t now = millis();
+    const size_t   n   = num_sources_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < n; i++) {
+      sources_[i].next_ms = now + sources_[i].period_ms;
+    }
+
+    xTaskCreatePinnedToCore(
+        &AcquisitionTask::task_entry,
+        ACQUISITION_TASK_NAME,
+        TASK_STACK_BYTES,
+        this,
+        TASK_PRIORITY,
+        nullptr,
+        TASK_CORE);
+
+    ESP_LOGI("Acq", "Acquisition task: %u sources on core %d",
+             static_cast<unsigned>(n), static_cast<int>(TASK_CORE));
+  }
+
+  // Producer side (acquisition task only)
+  void push(AcquisitionSource* source, uint16_t channel,
+            float value, uint32_t t_ms) {
+    Sample s = { source, channel, t_ms, value };
+    if (!queue_.push(s)) {
+      dropped_++;
+    }
+  }
+
+  uint32_t dropped() const { return dropped_; }
+
+  // Event loop: deliver everything queued so far
+  void drain() {
+    Sample s;
+    while (queue_.pop(s)) {
+      s.source->deliver(s.channel, s.value, s.t_ms);
+    }
+  }
+
+ private:
+  // --------------------------------------------------------------------------
+  // Constants
+  // --------------------------------------------------------------------------
+  static constexpr uint32_t    TASK_STACK_BYTES  = 4096;
+  static constexpr UBaseType_t TASK_PRIORITY     = 2;   // loopTask = 1
+  static constexpr BaseType_t  TASK_CORE         = 1;   // APP_CPU
+  static constexpr uint32_t    MAX_IDLE_MS       = 100;
+
+  struct Slot {
+    AcquisitionSource* source    = nullptr;
+    uint32_t           period_ms = 1;
+    uint32_t           next_ms   = 0;
+  };
+
+  Slot                sources_[MAX_SOURCES];
+  std::atomic<size_t> num_sources_{0};
+  bool                started_ = false;
+
+  SpscQueue<Sample, QUEUE_LENGTH> queue_;
+  volatile uint32_t               dropped_ = 0;
+
+  static void task_entry(void* arg) {
+    static_cast<AcquisitionTask*>(arg)->run();
+  }
+
+  // -------------------------------------------------------------------------
+  // Fixed-rate scheduler: each source at its own period, sleep until the
+  // next one is due
+  // -------------------------------------------------------------------------
+  void run() {
+    for (;;) {
+      const uint32_t now = millis();
+      const size_t   n   = num_sources_.load(std::memory_order_acquire);
+
+      for (size_t i = 0; i < n; i++) {
+        Slot& s = sources_[i];
+        if (static_cast<int32_t>(now - s.next_ms) < 0) {
+          continue;
+        }
+
+        s.next_ms += s.period_ms;
+        if (static_cast<int32_t>(now - s.next_ms) >= 0) {
+          s.next_ms = now + s.period_ms;  // overrun: re-phase, don't burst
+        }
+
+        s.source->acquire(now);
+      }
+
+      vTaskDelay(pdMS_TO_TICKS(idle_ms(millis(), n)));
+    }
+  }
+
+  // Time until the earliest source is due (at least one tick)
+  uint32_t idle_ms(uint32_t now, size_t n) const {
+    uint32_t wait = MAX_IDLE_MS;
+    for (size_t i = 0; i < n; i++) {
+      const int32_t due = static_cast<int32_t>(sources_[i].next_ms - now);
+      if (due <= 0) return 1;
+      if (static_cast<uint32_t>(due) < wait) wait = static_cast<uint32_t>(due);
+    }
+    return wait;
+  }
+};
+
+// ----------------------------------------------------------------------------
+inline void AcquisitionSource::publish(uint16_t channel, float value,
+                                       uint32_t t_ms) {
+  if (task_) {
+    task_->push(this, channel, value, t_ms);
+  } else {
+    deliver(channel, value, t_ms);
+  }
+}
+
+inline void AcquisitionSource::schedule(AcquisitionTask* task,
+                                        uint32_t period_ms) {
+  if (task && task->add(this, period_ms)) {
+    task_ = task;
+    return;
+  }
+
+  sensesp_app->get_event_loop()->onRepeat(
+      period_ms,
+      [this]() { this->acquire(millis()); });
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+// ============================================================================
+// AdcScanEngine — continuous DMA multi-channel ADC1 sampling
+// ============================================================================
+//
+// • ADC1 digital controller scans every registered channel in continuous
+//   (I2S DMA) mode at kHz rates — no blocking one-shot reads on the loop
+// • The driver's DMA ring (max_store_buf_size) double-buffers conversions;
+//   the AcquisitionTask (or the event loop) drains it in fixed-size frames
+//   without waiting; decimated codes are delivered on the event loop
+// • Per channel: an OversampleDecimator folds every conversion (outlier
+//   gate + min/max trim, single pass) into one fractional raw code
+//   (0..4095) per output interval → oversampled resolution, low latency
+// • Each channel delivers to one lightweight sink (CalibratedAnalogInput)
+// • Burst mode (set_burst_period(), engine off): the controller is stopped
+//   between short BURST_LENGTH_MS conversion bursts — the DMA no longer
+//   holds the APB frequency / keeps the chip awake; every channel emits
+//   once at the end of each burst
+//
+// NOTE: once started, ADC1 belongs to the DMA controller. Do not mix with
+// adc1_get_raw() / analogRead() on ADC1 pins.
+// ============================================================================
+
+#include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_log.h>
+
+#include <functional>
+
+#include "sensesp_app.h"
+
+#include "acquisition_task.h"
+#include "oversample_decimator.h"
+
+using namespace sensesp;
+
+class AdcScanEngine : public AcquisitionSource {
+ public:
+  // Receives the decimated (mean) raw code for one channel
+  typedef std::function<void(float raw_code)> Sink;
+
+  explicit AdcScanEngine(uint32_t sample_rate_hz = DEFAULT_SAMPLE_RATE_HZ)
+      : sample_rate_hz_(sample_rate_hz) {}
+
+  // -------------------------------------------------------------------------
+  // Register a channel (before start()). Returns false when full/duplicate.
+  // reject_codes: outlier gate around the previous output (<= 0 → trim only)
+  // -------------------------------------------------------------------------
+  bool add_channel(adc1_channel_t channel,
+                   uint32_t output_interval_ms,
+                   Sink sink,
+                   float reject_codes = OversampleDecimator::DEFAULT_REJECT_CODES) {
+    if (started_ || num_channels_ >= MAX_CHANNELS) {
+      ESP_LOGE("AdcScan", "Cannot add ADC1 channel %d", static_cast<int>(channel));
+      return false;
+    }
+    if (find(channel) != nullptr) {
+      ESP_LOGE("AdcScan", "ADC1 channel %d already registered", static_cast<int>(channel));
+      return false;
+    }
+
+    Channel& c = channels_[num_channels_++];
+    c.channel     = channel;
+    c.interval_ms = (output_interval_ms > 0) ? output_interval_ms : 1;
+    c.sink        = sink;
+    c.decimator.set_reject_threshold(reject_codes);
+    return true;
+  }
+
+  // -------------------------------------------------------------------------
+  // Configure the digital controller and start DMA conversions
+  // acq == nullptr → DMA drained from the event loop
+  // -------------------------------------------------------------------------
+  bool start(AcquisitionTask* acq = nullptr) {
+    if (started_ || num_channels_ == 0) {
+      return started_;
+    }
+
+    uint32_t mask = 0;
+    adc_digi_pattern_config_t pattern[MAX_CHANNELS] = {};
+    for (size_t i = 0; i < num_channels_; i++) {
+      mask |= (1u << channels_[i].channel);
+      pattern[i].atten     = ADC_ATTEN_DB_11;   // matches CalibratedAnalogInput
+      pattern[i].channel   = static_cast<uint8_t>(channels_[i].channel);
+      pattern[i].unit      = 0;                  // ADC1
+      pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = DMA_STORE_BYTES;
+    init.conv_num_each_intr = FRAME_BYTES;
+    init.adc1_chan_mask     = mask;
+    init.adc2_chan_mask     = 0;
+
+    if (adc_digi_initialize(&init) != ESP_OK) {
+      ESP_LOGE("AdcScan", "adc_digi_initialize failed");
+      return false;
+    }
+
+    adc_digi_configuration_t cfg = {};
+    cfg.conv_limit_en  = 1;      // required on ESP32
+    cfg.conv_limit_num = 250;
+    cfg.pattern_num    = num_channels_;
+    cfg.adc_pattern    = pattern;
+    cfg.sample_freq_hz = sample_rate_hz_;
+    cfg.conv_mode      = ADC_CONV_SINGLE_UNIT_1;
+    cfg.format         = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+
+    if (adc_digi_controller_configure(&cfg) != ESP_OK ||
+        adc_digi_start() != ESP_OK) {
+      ESP_LOGE("AdcScan", "ADC DMA configure/start failed");
+      adc_digi_deinitialize();
+      return false;
+    }
+
+    const uint32_t now = millis();
+    for (size_t i = 0; i < num_channels_; i++) {
+      channels_[i].last_emit_ms = now;
+    }
+
+    started_    = true;
+    converting_ = true;
+
+    schedule(acq, POLL_INTERVAL_MS);
+
+    ESP_LOGI("AdcScan", "ADC1 DMA scan: %u channels @ %u Hz",
+             static_cast<unsigned>(num_channels_),
+             static_cast<unsigned>(sample_rate_hz_));
+    return true;
+  }
+
+  // 0 → continuous scan; else one burst every period_ms (any context,
+  // applied by the next acquire())
+  void set_burst_period(uint32_t period_ms) { requested_burst_ms_ = period_ms; }
+
+ private:
+  // --------------------------------------------------------------------------
+  // Constants
+  // --------------------------------------------------------------------------
+  static constexpr uint32_t DEFAULT_SAMPLE_RATE_HZ = 20000;  // ESP32 DMA minimum
+  static constexpr size_t   MAX_CHANNELS           = 8;      // ADC1 has 8
+  static constexpr uint32_t FRAME_BYTES            = 256;    // 128 conversions
+  static constexpr uint32_t DMA_STORE_BYTES        = 4096;   // ~100 ms @ 20 kHz
+  static constexpr uint32_t POLL_INTERVAL_MS       = 10;
+  static constexpr uint32_t BURST_LENGTH_MS        = 100;    // one DMA store
+
+  struct Channel {
+    adc1_channel_t channel      = ADC1_CHANNEL_0;
+    uint32_t       interval_ms  = 1000;
+    uint32_t       last_emit_ms = 0;
+    OversampleDecimator decimator;
+    Sink           sink;
+  };
+
+  uint32_t sample_rate_hz_;
+  Channel  channels_[MAX_CHANNELS];
+  size_t   num_channels_ = 0;
+  bool     started_      = false;
+
+  // Burst mode (task context, except the request)
+  volatile uint32_t requested_burst_ms_ = 0;
+  uint32_t burst_ms_       = 0;
+  bool     converting_     = false;
+  uint32_t burst_start_ms_ = 0;
+
+  uint8_t frame_[FRAME_BYTES];
+
+  Channel* find(adc1_channel_t channel) {
+    for (size_t i = 0; i < num_channels_; i++) {
+      if (channels_[i].channel == channel) return &channels_[i];
+    }
+    return nullptr;
+  }
+
+  // -------------------------------------------------------------------------
+  // Drain everything the DMA has produced (non-blocking), then decimate
+  // -------------------------------------------------------------------------
+  void acquire(uint32_t now) override {
+    if (requested_burst_ms_ != burst_ms_) {
+      set_mode(requested_burst_ms_, now);
+    }
+
+    if (burst_ms_ == 0) {
+      drain();
+      emit(now, false);
+      return;
+    }
+
+    // Burst: idle → convert BURST_LENGTH_MS → emit → stop
+    if (!converting_) {
+      if ((now - burst_start_ms_) >= burst_ms_ && adc_digi_start() == ESP_OK) {
+        converting_     = true;
+        burst_start_ms_ = now;
+      }
+      return;
+    }
+
+    drain();
+    if ((now - burst_start_ms_) >= BURST_LENGTH_MS) {
+      emit(now, true);
+      adc_digi_stop();
+      converting_ = false;
+    }
+  }
+
+  void set_mode(uint32_t burst_ms, uint32_t now) {
+    burst_ms_ = burst_ms;
+
+    if (burst_ms_ == 0 && !converting_) {
+      converting_ = (adc_digi_start() == ESP_OK);
+      for (size_t i = 0; i < num_channels_; i++) {
+        channels_[i].last_emit_ms = now;
+      }
+    } else if (burst_ms_ != 0) {
+      burst_start_ms_ = now;     // the current scan counts as the first burst
+    }
+
+    ESP_LOGI("AdcScan", "ADC1 DMA scan: %s",
+             burst_ms_ ? "burst" : "continuous");
+  }
+
+  void drain() {
+    uint32_t got = 0;
+
+    while (adc_digi_read_bytes(frame_, FRAME_BYTES, &got, 0) == ESP_OK &&
+           got > 0) {
+      accumulate(frame_, got);
+      if (got < FRAME_BYTES) break;
+    }
+  }
+
+  // force → every channel with data, regardless of its output interval
+  void emit(uint32_t now, bool force) {
+    for (size_t i = 0; i < num_channels_; i++) {
+      Channel& c = channels_[i];
+      if (c.decimator.count() == 0 ||
+          (!force && (now - c.last_emit_ms) < c.interval_ms)) {
+        continue;
+      }
+
+      const float code = c.decimator.decimate();
+      c.last_emit_ms = now;
+
+      publish(static_cast<uint16_t>(i), code, now);
+    }
+  }
+
+  void deliver(uint16_t channel, float code, uint32_t) override {
+    if (channel < num_channels_ && channels_[channel].sink) {
+      channels_[channel].sink(code);
+    }
+  }
+
+  void accumulate(const uint8_t* buf, uint32_t len) {
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len;
+         i += SOC_ADC_DIGI_RESULT_BYTES) {
+      const auto* d = reinterpret_cast<const adc_digi_output_data_t*>(&buf[i]);
+
+      Channel* c = find(static_cast<adc1_channel_t>(d->type1.channel));
+      if (c) {
+        c->decimator.add(static_cast<uint16_t>(d->type1.data));
+      }
+    }
+  }
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+// ============================================================================
+// BootCache — NVS records for state that is slow to rediscover at boot
+// ============================================================================
+//
+// • One Preferences blob per key: magic, payload size, firmware build id
+//   (first bytes of the app ELF SHA-256), payload, CRC-32
+// • A record only loads for the firmware that wrote it — payloads may hold
+//   values that are only meaningful for one image (e.g. the ADC
+//   characterization's pointers to the calibration curve tables)
+// • Used for: ADC1 characterization (CalibratedAnalogInput) and the ROM
+//   IDs found on each OneWire bus (OneWireScheduler)
+// • A missing, stale or corrupt record just means "rediscover and store"
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "crc32.h"
+
+// ============================================================================
+// Record framing (no SensESP dependency)
+// ============================================================================
+static constexpr size_t BOOT_CACHE_BUILD_ID_BYTES = 8;
+
+template <typename T>
+struct BootCacheRecord {
+  static constexpr uint32_t MAGIC = 0x42434331u;   // "BCC1"
+
+  uint32_t magic = 0;
+  uint32_t size  = 0;
+  uint8_t  build_id[BOOT_CACHE_BUILD_ID_BYTES] = {};
+  T        payload;
+  uint32_t crc   = 0;
+
+  void seal(const uint8_t* id) {
+    magic = MAGIC;
+    size  = sizeof(T);
+    memcpy(build_id, id, BOOT_CACHE_BUILD_ID_BYTES);
+    crc   = checksum();
+  }
+
+  bool valid(const uint8_t* id) const {
+    return magic == MAGIC && size == sizeof(T) &&
+           memcmp(build_id, id, BOOT_CACHE_BUILD_ID_BYTES) == 0 &&
+           crc == checksum();
+  }
+
+ private:
+  uint32_t checksum() const {
+    return crc32_ieee(this, offsetof(BootCacheRecord, crc));
+  }
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_log.h>
+#include <esp_ota_ops.h>
+
+class BootCache {
+ public:
+  static constexpr const char* NVS_NAMESPACE = "boot_cache";
+
+  // NVS keys: ≤ 15 characters
+  template <typename T>
+  static bool load(const char* key, T& out) {
+    BootCacheRecord<T> r;
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) return false;
+    const size_t got = prefs.getBytes(key, &r, sizeof(r));
+    prefs.end();
+
+    if (got != sizeof(r) || !r.valid(build_id())) return false;
+    out = r.payload;
+    return true;
+  }
+
+  template <typename T>
+  static void store(const char* key, const T& value) {
+    BootCacheRecord<T> r;
+    r.payload = value;
+    r.seal(build_id());
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) return;
+    if (prefs.putBytes(key, &r, sizeof(r)) != sizeof(r)) {
+      ESP_LOGW("BootCache", "Could not store '%s'", key);
+    }
+    prefs.end();
+  }
+
+ private:
+  static const uint8_t* build_id() {
+    return esp_ota_get_app_description()->app_elf_sha256;
+  }
+};
+
+#endif  // ARDUINO
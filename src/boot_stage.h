@@ -0,0 +1,155 @@
+#pragma once
+
+// ============================================================================
+// BootStager — staged startup: critical pipelines first, the rest deferred
+// ============================================================================
+//
+// • setup() builds only what must publish right after a reset (RPM, oil
+//   pressure, coolant, engine hours, N2K, data log) and returns — the
+//   event loop and the acquisition task are running within ~300 ms
+// • Everything else is queued with defer(name, fn) and built from the
+//   event loop once WiFi is up (or after NETWORK_TIMEOUT_MS without it):
+//   OneWire discovery, fuel / load models, debug outputs, replay, profiler
+// • One deferred step per STEP_INTERVAL_MS, so the loop keeps serving the
+//   critical pipelines between them; each step is a SystemDiagnostics
+//   setup stage
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// ============================================================================
+// Deferred step queue (no SensESP dependency)
+// ============================================================================
+class DeferredBootQueue {
+ public:
+  typedef std::function<void()> Step;
+
+  static constexpr size_t MAX_STEPS = 16;
+
+  explicit DeferredBootQueue(uint32_t network_timeout_ms)
+      : network_timeout_ms_(network_timeout_ms) {}
+
+  bool add(const char* name, Step fn) {
+    if (num_steps_ >= MAX_STEPS) return false;
+    steps_[num_steps_].name = name;
+    steps_[num_steps_].fn   = fn;
+    num_steps_++;
+    return true;
+  }
+
+  // Runs at most one step; returns its name (nullptr → nothing ran)
+  const char* poll(uint32_t now_ms, bool network_up) {
+    if (!released_) {
+      if (!network_up && now_ms < network_timeout_ms_) return nullptr;
+      released_     = true;
+      released_ms_  = now_ms;
+    }
+    if (next_ >= num_steps_) return nullptr;
+
+    Entry& e = steps_[next_++];
+    e.fn();
+    e.fn = nullptr;   // release captures
+    return e.name;
+  }
+
+  bool released() const { return released_; }
+  bool done() const { return released_ && next_ >= num_steps_; }
+  uint32_t released_ms() const { return released_ms_; }
+  size_t size() const { return num_steps_; }
+
+ private:
+  struct Entry {
+    const char* name = "";
+    Step        fn;
+  };
+
+  uint32_t network_timeout_ms_;
+  Entry    steps_[MAX_STEPS];
+  size_t   num_steps_   = 0;
+  size_t   next_        = 0;
+  bool     released_    = false;
+  uint32_t released_ms_ = 0;
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_log.h>
+
+#include "sensesp_app.h"
+
+#include "system_diagnostics.h"
+
+using namespace sensesp;
+
+extern SystemDiagnostics* g_diag;
+
+class BootStager {
+ public:
+  static constexpr uint32_t NETWORK_TIMEOUT_MS = 10000;   // since reset
+  static constexpr uint32_t STEP_INTERVAL_MS   = 20;
+
+  BootStager() : queue_(NETWORK_TIMEOUT_MS) {}
+
+  // fn runs on the event loop, in defer() order
+  void defer(const char* name, DeferredBootQueue::Step fn) {
+    if (!queue_.add(name, fn)) {
+      ESP_LOGE("Boot", "Deferred step table full, running '%s' now", name);
+      fn();
+    }
+  }
+
+  // End of setup(): the fast stage is complete
+  void start() {
+    ESP_LOGI("Boot", "Critical pipelines up at %u ms, %u step(s) deferred",
+             static_cast<unsigned>(millis()),
+             static_cast<unsigned>(queue_.size()));
+
+    sensesp_app->get_event_loop()->onRepeat(
+        STEP_INTERVAL_MS,
+        [this]() { this->step(); });
+  }
+
+  bool done() const { return done_; }
+
+ private:
+  DeferredBootQueue queue_;
+  bool              done_ = false;
+
+  void step() {
+    const bool was_released = queue_.released();
+    const char* name = queue_.poll(millis(), WiFi.status() == WL_CONNECTED);
+
+    if (!was_released && queue_.released()) {
+      ESP_LOGI("Boot", "Deferred stage at %u ms (%s)",
+               static_cast<unsigned>(queue_.released_ms()),
+               (WiFi.status() == WL_CONNECTED) ? "network up" : "timeout");
+    }
+
+    if (name && g_diag) {
+      g_diag->mark_setup(name);
+    }
+
+    if (!done_ && queue_.done()) {
+      done_ = true;
+      ESP_LOGI("Boot", "Startup complete at %u ms",
+               static_cast<unsigned>(millis()));
+    }
+  }
+};
+
+extern BootStager* g_boot;   // main.cpp
+
+// Setup helpers: defer non-critical construction (inline without a stager)
+inline void boot_defer(const char* name, DeferredBootQueue::Step fn) {
+  if (g_boot) {
+    g_boot->defer(name, fn);
+  } else {
+    fn();
+  }
+}
+
+#endif  // ARDUINO
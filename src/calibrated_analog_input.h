@@ -8,15 +8,28 @@
 #include <esp_adc_cal.h>
 #include <esp_log.h>
 
+#include <cmath>
+
+#include "adc_scan_engine.h"
+#include "boot_cache.h"
+#include "flat_curve.h"
+#include "pipeline_profiler.h"
+
 using namespace sensesp;
 
 // ============================================================================
 // CalibratedAnalogInput — SensESP v3.1.1 compatible
 //
 // • Uses ESP32 ADC1 directly (bypasses Arduino analogRead)
+// • Two sources: one-shot adc1_get_raw() on a timer, or decimated
+//   (oversampled, fractional) raw codes from an AdcScanEngine DMA channel
 // • Applies Espressif ADC calibration if present (Two-Point or eFuse Vref)
 // • Falls back to internal reference (1100 mV) if no eFuse data
+// • Characterization runs once per firmware image: cached in NVS
+//   (BootCache) and shared by every input in RAM
 // • Emits calibrated ADC-pin voltage (Volts)
+// • Optional raw-code LUT: 4096-entry table built at boot maps each 12-bit
+//   code straight to the final value (volts, or curve(volts) + offset)
 // • Publishes calibration mode to Signal K (debug, static)
 // ============================================================================
 
@@ -28,7 +41,156 @@ class CalibratedAnalogInput : public Sensor<float> {
       : Sensor<float>(config_path),
         pin_(pin),
         read_rate_hz_(read_rate_hz) {
+    init_adc();
+  }
+
+  // Scan-backed: samples come from the DMA engine, no one-shot reads
+  CalibratedAnalogInput(int pin,
+                        AdcScanEngine* scan,
+                        float output_rate_hz,
+                        const String& config_path = "")
+      : Sensor<float>(config_path),
+        pin_(pin),
+        read_rate_hz_(output_rate_hz),
+        scan_(scan) {
+    init_adc();
+  }
+
+  // Scan-backed: decimator outlier gate (before enable(); <= 0 → trim only)
+  void set_scan_reject_codes(float codes) { reject_codes_ = codes; }
+
+  // Profiler stage for the scan callback (before enable(); must outlive it)
+  void set_perf_name(const char* name) { perf_name_ = name; }
+
+  // -------------------------------------------------------------------------
+  // Must be called explicitly (custom Sensor subclasses are not auto-enabled)
+  // Scan-backed inputs must be enabled before AdcScanEngine::start().
+  // -------------------------------------------------------------------------
+  void enable() {
+    float rate = (read_rate_hz_ > 0.1f) ? read_rate_hz_ : 0.1f;
+    uint32_t interval_ms = static_cast<uint32_t>(1000.0f / rate);
 
+    if (scan_) {
+      scan_->add_channel(
+          channel_,
+          interval_ms,
+          perf_timed(perf_name_,
+                     [this](float raw) { this->on_scan_raw(raw); }),
+          reject_codes_);
+      return;
+    }
+
+    perf_repeat("adc_read", interval_ms, [this]() { this->read(); });
+  }
+
+  // -------------------------------------------------------------------------
+  // Raw-code output LUT (one indexed load per sample instead of
+  // esp_adc_cal_raw_to_voltage + curve + offset stages)
+  //
+  //   curve == nullptr → calibrated volts
+  //   otherwise        → curve(volts) + offset
+  //   volts outside [valid_min_v, valid_max_v] → NAN
+  //
+  // Rebuilt only when the calibration or the curve parameters change.
+  // -------------------------------------------------------------------------
+  void set_output_lut(const FlatCurve* curve,
+                      float offset = 0.0f,
+                      float valid_min_v = -INFINITY,
+                      float valid_max_v = INFINITY) {
+    LutKey key;
+    key.coeff_a     = adc_chars_.coeff_a;
+    key.coeff_b     = adc_chars_.coeff_b;
+    key.vref        = adc_chars_.vref;
+    key.curve       = curve;
+    key.offset      = offset;
+    key.valid_min_v = valid_min_v;
+    key.valid_max_v = valid_max_v;
+
+    if (lut_ && key == lut_key_) {
+      return;  // unchanged — keep existing table
+    }
+
+    if (!lut_) {
+      lut_ = new UniformCurveLut<ADC_CODES>();  // 16 KB, allocated once
+    }
+
+    const esp_adc_cal_characteristics_t* chars = &adc_chars_;
+    lut_->build_keyed([=](size_t code) -> float {
+      const float v =
+          esp_adc_cal_raw_to_voltage(static_cast<uint32_t>(code), chars) / 1000.0f;
+      if (v < valid_min_v || v > valid_max_v) return NAN;
+      return curve ? (curve->interpolate(v) + offset) : v;
+    });
+
+    lut_key_ = key;
+    ESP_LOGI("CalADC", "GPIO%d raw-code LUT built (%u entries)",
+             pin_, static_cast<unsigned>(ADC_CODES));
+  }
+
+  // Last raw code (fractional when oversampled) and its calibrated voltage
+  // (on demand, not per sample)
+  float last_raw() const { return last_raw_; }
+  float last_volts() const { return raw_to_volts(last_raw_); }
+
+  // Fractional codes interpolate between neighbouring calibrated codes
+  float raw_to_volts(float raw) const {
+    if (!(raw >= 0.0f)) return NAN;
+
+    const uint32_t i = static_cast<uint32_t>(raw);
+    const float    u = raw - static_cast<float>(i);
+    const float   v0 = esp_adc_cal_raw_to_voltage(i, &adc_chars_);
+    if (u <= 0.0f) return v0 / 1000.0f;
+
+    const float   v1 = esp_adc_cal_raw_to_voltage(i + 1, &adc_chars_);
+    return (v0 + (v1 - v0) * u) / 1000.0f;
+  }
+
+  // -------------------------------------------------------------------------
+  // Publish calibration mode to Signal K (static string)
+  // -------------------------------------------------------------------------
+void publish_calibration_mode(const char* sk_path) {
+  auto* sk = new SKOutputString(sk_path);
+  auto* value = new ObservableValue<String>(calibration_mode_);
+  value->connect_to(sk);
+}
+
+ private:
+  static constexpr size_t ADC_CODES = 4096;   // 12-bit
+
+  // Everything the LUT contents depend on
+  struct LutKey {
+    uint32_t         coeff_a     = 0;
+    uint32_t         coeff_b     = 0;
+    uint32_t         vref        = 0;
+    const FlatCurve* curve       = nullptr;
+    float            offset      = 0.0f;
+    float            valid_min_v = 0.0f;
+    float            valid_max_v = 0.0f;
+
+    bool operator==(const LutKey& o) const {
+      return coeff_a == o.coeff_a && coeff_b == o.coeff_b && vref == o.vref &&
+             curve == o.curve && offset == o.offset &&
+             valid_min_v == o.valid_min_v && valid_max_v == o.valid_max_v;
+    }
+  };
+
+  int pin_;
+  float read_rate_hz_;
+  AdcScanEngine* scan_ = nullptr;
+  float reject_codes_ = OversampleDecimator::DEFAULT_REJECT_CODES;
+  const char* perf_name_ = "adc_scan_read";
+  adc1_channel_t channel_;
+  esp_adc_cal_characteristics_t adc_chars_;
+  String calibration_mode_;
+
+  UniformCurveLut<ADC_CODES>* lut_ = nullptr;
+  LutKey lut_key_;
+  float  last_raw_ = -1.0f;
+
+  // -------------------------------------------------------------------------
+  // ADC1 channel setup + calibration characterization
+  // -------------------------------------------------------------------------
+  void init_adc() {
     channel_ = adc1_channel_for_pin(pin_);
 
     // -----------------------------------------------------------------------
@@ -40,12 +202,7 @@ class CalibratedAnalogInput : public Sensor<float> {
     // -----------------------------------------------------------------------
     // Characterize ADC (factory calibration if present)
     // -----------------------------------------------------------------------
-    esp_adc_cal_value_t cal_type = esp_adc_cal_characterize(
-        ADC_UNIT_1,
-        ADC_ATTEN_DB_11,
-        ADC_WIDTH_BIT_12,
-        1100,   // fallback Vref (used only if no eFuse data)
-        &adc_chars_);
+    const esp_adc_cal_value_t cal_type = characterize(adc_chars_);
 
     switch (cal_type) {
       case ESP_ADC_CAL_VAL_EFUSE_TP:
@@ -71,43 +228,69 @@ class CalibratedAnalogInput : public Sensor<float> {
   }
 
   // -------------------------------------------------------------------------
-  // Must be called explicitly (custom Sensor subclasses are not auto-enabled)
+  // ADC1 / 11 dB / 12-bit characterization: RAM → NVS → eFuse
   // -------------------------------------------------------------------------
-  void enable() {
-    float rate = (read_rate_hz_ > 0.1f) ? read_rate_hz_ : 0.1f;
-    uint32_t interval_ms = static_cast<uint32_t>(1000.0f / rate);
+  struct AdcCalRecord {
+    esp_adc_cal_characteristics_t chars;
+    uint32_t                      cal_type;
+  };
 
-    sensesp_app->get_event_loop()->onRepeat(
-        interval_ms,
-        [this]() { this->read(); });
-  }
+  static esp_adc_cal_value_t characterize(esp_adc_cal_characteristics_t& out) {
+    static AdcCalRecord cached;
+    static bool         have = false;
 
-  // -------------------------------------------------------------------------
-  // Publish calibration mode to Signal K (static string)
-  // -------------------------------------------------------------------------
-void publish_calibration_mode(const char* sk_path) {
-  auto* sk = new SKOutputString(sk_path);
-  auto* value = new ObservableValue<String>(calibration_mode_);
-  value->connect_to(sk);
-}
+    if (!have && BootCache::load("adc1_11db", cached)) {
+      have = true;
+      ESP_LOGI("CalADC", "ADC characterization from NVS cache");
+    }
 
- private:
-  int pin_;
-  float read_rate_hz_;
-  adc1_channel_t channel_;
-  esp_adc_cal_characteristics_t adc_chars_;
-  String calibration_mode_;
+    if (!have) {
+      cached.cal_type = static_cast<uint32_t>(esp_adc_cal_characterize(
+          ADC_UNIT_1,
+          ADC_ATTEN_DB_11,
+          ADC_WIDTH_BIT_12,
+          1100,   // fallback Vref (used only if no eFuse data)
+          &cached.chars));
+      have = true;
+      BootCache::store("adc1_11db", cached);
+    }
+
+    out = cached.chars;
+    return static_cast<esp_adc_cal_value_t>(cached.cal_type);
+  }
 
   // -------------------------------------------------------------------------
-  // Perform calibrated ADC read and emit volts at ADC pin
+  // Perform ADC read; emit LUT value, or calibrated volts at ADC pin
   // -------------------------------------------------------------------------
   void read() {
     int raw = adc1_get_raw(channel_);
+    if (raw < 0) {
+      return;  // driver error
+    }
+    last_raw_ = static_cast<float>(raw);
+
+    if (lut_) {
+      emit(lut_->at(static_cast<size_t>(raw)));
+      return;
+    }
+
     uint32_t millivolts =
         esp_adc_cal_raw_to_voltage(raw, &adc_chars_);
     emit(millivolts / 1000.0f);
   }
 
+  // -------------------------------------------------------------------------
+  // Decimated raw code from the scan engine (already averaged)
+  // -------------------------------------------------------------------------
+  void on_scan_raw(float raw) {
+    if (!(raw >= 0.0f)) {
+      return;
+    }
+    last_raw_ = raw;
+
+    emit(lut_ ? lut_->at_fractional(raw) : raw_to_volts(raw));
+  }
+
   // -------------------------------------------------------------------------
   // Map GPIO → ADC1 channel (ESP32)
   // -------------------------------------------------------------------------
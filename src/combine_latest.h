@@ -0,0 +1,138 @@
+#pragma once
+
+// ============================================================================
+// CombineLatest<N> — N-input join with hold timeouts, one pass per tick
+// ============================================================================
+//
+// • Each input is a ValueConsumer<float> (input(i)); any input may change
+//   the result, not only a designated "trigger" stream
+// • Per input: last finite value + timestamp. NaN does not overwrite a held
+//   value; a value older than its hold_ms reads as the input's expire value
+//   (NaN, or 0 for e.g. RPM) — stale side inputs cannot linger forever
+// • Inputs only mark the join dirty; the combined LatestValues<N> is emitted
+//   at most once per event-loop tick, however many inputs changed
+// • Replaces the per-pipeline latch state structs (latch_with_hold) and the
+//   get() cross-reads of side inputs
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// Values / slots (no SensESP dependency)
+// ============================================================================
+template <size_t N>
+struct LatestValues {
+  float v[N];
+
+  LatestValues() {
+    for (size_t i = 0; i < N; i++) v[i] = NAN;
+  }
+
+  float  operator[](size_t i) const { return v[i]; }
+  float& operator[](size_t i) { return v[i]; }
+};
+
+template <size_t N>
+class LatestSlots {
+ public:
+  // hold_ms = 0 → the value never goes stale
+  void configure(size_t i, uint32_t hold_ms, float expire_value = NAN) {
+    if (i >= N) return;
+    slots_[i].hold_ms      = hold_ms;
+    slots_[i].expire_value = expire_value;
+  }
+
+  void update(size_t i, float value, uint32_t now_ms) {
+    if (i >= N || !std::isfinite(value)) return;
+    slots_[i].value   = value;
+    slots_[i].ts_ms   = now_ms;
+    slots_[i].has     = true;
+  }
+
+  float value(size_t i, uint32_t now_ms) const {
+    if (i >= N) return NAN;
+    const Slot& s = slots_[i];
+    if (!s.has) return s.expire_value;
+    if (s.hold_ms != 0 && (now_ms - s.ts_ms) > s.hold_ms) return s.expire_value;
+    return s.value;
+  }
+
+  LatestValues<N> snapshot(uint32_t now_ms) const {
+    LatestValues<N> out;
+    for (size_t i = 0; i < N; i++) out[i] = value(i, now_ms);
+    return out;
+  }
+
+ private:
+  struct Slot {
+    float    value        = NAN;
+    float    expire_value = NAN;
+    uint32_t ts_ms        = 0;
+    uint32_t hold_ms      = 0;
+    bool     has          = false;
+  };
+
+  Slot slots_[N];
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+
+#include <sensesp/system/valueconsumer.h>
+#include <sensesp/system/valueproducer.h>
+
+#include "sensesp_app.h"
+
+using namespace sensesp;
+
+template <size_t N>
+class CombineLatest : public ValueProducer<LatestValues<N>> {
+ public:
+  class Input : public ValueConsumer<float> {
+   public:
+    void set(const float& value) override {
+      parent_->slots_.update(index_, value, millis());
+      parent_->dirty_ = true;
+    }
+
+   private:
+    friend class CombineLatest;
+
+    CombineLatest* parent_ = nullptr;
+    size_t         index_  = 0;
+  };
+
+  CombineLatest() {
+    for (size_t i = 0; i < N; i++) {
+      inputs_[i].parent_ = this;
+      inputs_[i].index_  = i;
+    }
+
+    // Registered once — the per-tick cost is one flag test
+    sensesp_app->get_event_loop()->onTick([this]() { this->flush(); });
+  }
+
+  Input* input(size_t i) { return (i < N) ? &inputs_[i] : nullptr; }
+
+  CombineLatest* configure(size_t i, uint32_t hold_ms, float expire_value = NAN) {
+    slots_.configure(i, hold_ms, expire_value);
+    return this;
+  }
+
+  // Emit once if any input changed since the last tick
+  void flush() {
+    if (!dirty_) return;
+    dirty_ = false;
+    this->emit(slots_.snapshot(millis()));
+  }
+
+ private:
+  Input          inputs_[N];
+  LatestSlots<N> slots_;
+  bool           dirty_ = false;
+};
+
+#endif  // ARDUINO
@@ -5,8 +5,11 @@
 // (SensESP v3.1.x compatible)
 //
 // Policy:
-//   • ADC volts → temperature via empirical table
-//   • Median filter + 5 s moving average
+//   • ADC raw code → Kelvin via one LUT load (calibration + empirical table
+//     precomputed at boot in CalibratedAnalogInput)
+//   • Oversampled via AdcScanEngine: each output is the outlier-gated,
+//     trimmed mean of every DMA conversion since the last one
+//     (replaces Median(5) + 5 s moving average → ~0.5 s lag instead of ~7 s)
 //   • Output emitted at 2 Hz regardless of value change
 //   • Momentary ADC NaN / out-of-range is ignored
 //   • Last valid temperature is frozen and continues to emit
@@ -14,183 +17,169 @@
 // ============================================================================
 
 #include <cmath>
-#include <set>
 
-#include <sensesp/transforms/linear.h>
-#include <sensesp/transforms/median.h>
-#include <sensesp/transforms/moving_average.h>
-#include <sensesp/transforms/curveinterpolator.h>
 #include <sensesp/transforms/lambda_transform.h>
+#include <sensesp/transforms/transform.h>
 #include <sensesp/signalk/signalk_output.h>
 #include <sensesp/ui/config_item.h>
 
+#include "boot_stage.h"
 #include "calibrated_analog_input.h"
+#include "data_logger.h"
+#include "engine_instance.h"
+#include "n2k_engine_output.h"
+#include "pipeline_profiler.h"
+#include "power_profile.h"
+#include "sender_curves.h"
+#include "sk_output_batcher.h"
+#include "sk_replay.h"
+#include "thermal_anomaly.h"
 
 using namespace sensesp;
 
 // -----------------------------------------------------------------------------
 // Externals from main.cpp
 // -----------------------------------------------------------------------------
-extern const uint8_t PIN_ADC_COOLANT;
 extern const float   ADC_SAMPLE_RATE_HZ;
+extern AdcScanEngine* g_adc_scan;
+extern SkOutputBatcher* g_sk_batcher;
 
 // -----------------------------------------------------------------------------
-// ADC validity domain (used only to qualify updates)
+// Last valid value: nothing is emitted until the first valid (non-NaN)
+// sample, then NaN / out-of-range samples re-emit the held value
 // -----------------------------------------------------------------------------
-constexpr float ADC_MIN_VALID_V = 0.257f;   // ≈121 °C
-constexpr float ADC_MAX_VALID_V = 1.392f;   // ≈10 °C
+class HoldLastValid : public Transform<float, float> {
+ public:
+  explicit HoldLastValid(const String& config_path = "")
+      : Transform<float, float>(config_path) {}
+
+  void set(const float& value) override {
+    if (!std::isnan(value)) {
+      last_valid_ = value;
+    }
+    if (!std::isnan(last_valid_)) {
+      emit(last_valid_);
+    }
+  }
+
+  // NaN until the first valid sample (get() is the producer's default then)
+  float last_valid() const { return last_valid_; }
+
+ private:
+  float last_valid_ = NAN;
+};
 
 // -----------------------------------------------------------------------------
 // Engine coolant temperature
 // -----------------------------------------------------------------------------
-inline void setup_coolant_sender() {
+inline void setup_coolant_sender(EngineInstance& e) {
 
   // ---------------------------------------------------------------------------
-  // ADC tracking
-  // ---------------------------------------------------------------------------
-  static float last_adc_v = NAN;
-  static float last_valid_temp_K = NAN;
-
-  // ---------------------------------------------------------------------------
-  // STEP 1 — Calibrated ADC input
+  // STEP 1 — Calibrated ADC input, raw code → Kelvin in one LUT load
+  //          (calibration + curve + °C→K folded in; NAN outside ADC validity)
+  //          Fed by the DMA scan engine (oversampled + decimated, so no
+  //          further median / moving-average stage is needed)
   // ---------------------------------------------------------------------------
   auto* adc_raw = new CalibratedAnalogInput(
-      PIN_ADC_COOLANT,
+      e.config().pin_adc_coolant,
+      g_adc_scan,
       ADC_SAMPLE_RATE_HZ,
-      "/config/sensors/coolant/adc_raw"
-  );
-  adc_raw->enable();
-
-  adc_raw->publish_calibration_mode(
-      "debug.coolant.adc_calibration"
-  );
-
-  // Track raw ADC value (side-channel only)
-  adc_raw->connect_to(
-      new LambdaTransform<float, float>(
-          [](float v) {
-            last_adc_v = v;
-            return v;
-          }
-      )
-  );
-
-  // ---------------------------------------------------------------------------
-  // STEP 2 — Median filter
-  // ---------------------------------------------------------------------------
-  auto* adc_v_smooth = adc_raw->connect_to(
-      new Median(
-          5,
-          "/config/sensors/coolant/adc_v_smooth"
-      )
+      e.config_path("/config/sensors/coolant/adc_raw")
   );
 
-  // ---------------------------------------------------------------------------
-  // STEP 3 — ADC volts → temperature (°C)
-  // ---------------------------------------------------------------------------
-  static std::set<CurveInterpolator::Sample> adc_to_temp = {
-
-      { 0.257f, 121.0f },   // 250 °F, ~30 Ω
-
-      { 0.762f,  80.6f },   // 177 °F
-      { 0.766f,  80.0f },   // 176 °F
-      { 0.786f,  79.4f },   // 175 °F
-      { 0.814f,  78.3f },   // 173 °F
-      { 0.843f,  76.7f },   // 170 °F
-      { 0.898f,  71.1f },   // 160 °F
-      { 0.925f,  67.8f },   // 154 °F
-      { 0.941f,  66.7f },   // 152 °F
-      { 0.943f,  66.1f },   // 151 °F
-      { 1.040f,  60.0f },   // 140 °F
-      { 1.136f,  52.2f },   // 126 °F
-      { 1.212f,  48.9f },   // 120 °F
-      { 1.309f,  40.6f },   // 105 °F
-      { 1.392f,  10.0f }    // 50 °F
-  };
-
-  auto* temp_C = adc_v_smooth->connect_to(
-      new CurveInterpolator(
-          &adc_to_temp,
-          "/config/sensors/coolant/temp_C"
-      )
+  adc_raw->set_output_lut(
+      &coolant_adc_to_temp,
+      273.15f,
+      ADC_MIN_VALID_V,
+      ADC_MAX_VALID_V
   );
+  adc_raw->set_perf_name(e.perf_name("adc_scan_read"));
+  adc_raw->enable();
 
-  // ---------------------------------------------------------------------------
-  // STEP 4 — Ignore NaN (do not poison pipeline)
-  // ---------------------------------------------------------------------------
-  auto* temp_C_safe = temp_C->connect_to(
-      new LambdaTransform<float, float>(
-          [](float c) {
-            return std::isnan(c) ? 0.0f : c;
-          },
-          "/config/sensors/coolant/temp_C_safe"
-      )
-  );
-
-  // ---------------------------------------------------------------------------
-  // STEP 5 — Moving average (5 seconds)
-  // ---------------------------------------------------------------------------
-  const int MA_WINDOW =
-      (ADC_SAMPLE_RATE_HZ * 5.0f < 1.0f)
-          ? 1
-          : static_cast<int>(ADC_SAMPLE_RATE_HZ * 5.0f);
-
-  auto* temp_C_avg = temp_C_safe->connect_to(
-      new MovingAverage(MA_WINDOW)
+  adc_raw->publish_calibration_mode(
+      e.debug_path("coolant.adc_calibration").c_str()
   );
 
   // ---------------------------------------------------------------------------
-  // STEP 6 — °C → Kelvin
+  // STEP 2 — Ignore NaN / out-of-range (do not poison pipeline): no NaN
+  //          ever reaches the consumers, even before the first valid
+  //          sample (cold start below the LUT window, open sender)
   // ---------------------------------------------------------------------------
-  auto* temp_K = temp_C_avg->connect_to(
-      new Linear(
-          1.0f,
-          273.15f,
-          "/config/sensors/coolant/temp_K"
-      )
+  auto* temp_K_safe = adc_raw->connect_to(
+      new HoldLastValid(e.config_path("/config/sensors/coolant/temp_K_safe"))
   );
 
   // ---------------------------------------------------------------------------
-  // STEP 7 — Signal K output (direct periodic emission)
+  // STEP 3 — Signal K output (direct periodic emission)
   // ---------------------------------------------------------------------------
   auto* sk_coolant = new SKOutputFloat(
-      "propulsion.engine.temperature",
-      "/config/outputs/sk/coolant_temp"
+      e.sk_path("temperature"),
+      e.config_path("/config/outputs/sk/coolant_temp")
   );
 
   ConfigItem(sk_coolant)
-      ->set_title("Coolant Temperature (Engine)")
-      ->set_sort_order(750);
+      ->set_title(e.ui_title("Coolant Temperature (Engine)"))
+      ->set_sort_order(e.sort_order(750));
 
-  // Periodic emitter (2 Hz, freeze last valid)
-  sensesp_app->get_event_loop()->onRepeat(
-      500,
-      [temp_K, sk_coolant]() {
+  // Batched: ≥ 0.1 K change to send, otherwise keep-alive only
+  auto* coolant_out = batched(g_sk_batcher, sk_coolant, 500, 0.1f);
 
-        float v = temp_K->get();
+  // Periodic emitter (2 Hz, freeze last valid; keep-alive when engine off)
+  uint32_t last_emit_ms = 0;
+  perf_repeat(
+      e.perf_name("coolant_emit"),
+      500,
+      [temp_K_safe, coolant_out, last_emit_ms]() mutable {
+        if (power_throttled(last_emit_ms, ENGINE_OFF_EMIT_MS)) return;
 
-        // Accept new value only if ADC is sane and value is valid
-        if (!std::isnan(v) &&
-            last_adc_v >= ADC_MIN_VALID_V &&
-            last_adc_v <= ADC_MAX_VALID_V) {
-          last_valid_temp_K = v;
-        }
+        // Out-of-range samples are held in STEP 2
+        float v = temp_K_safe->last_valid();
 
         // Emit last valid value if we have one
-        if (!std::isnan(last_valid_temp_K)) {
-          sk_coolant->emit(last_valid_temp_K);
+        if (!std::isnan(v)) {
+          coolant_out->set(v);
         }
       }
   );
 
+  // Direct NMEA 2000 PGN 127489 (held last valid value, K)
+  if (e.n2k) {
+    temp_K_safe->connect_to(e.n2k->coolant_temp());
+  }
+
+  if (e.datalog()) {
+    temp_K_safe->connect_to(e.datalog()->coolant_temp());
+  }
+
+  if (e.sk_replay()) {
+    e.sk_replay()->bind(REPLAY_COOLANT, sk_coolant);
+  }
+
+  // Learned per-RPM/load baseline → notification (deferred boot stage)
+  boot_defer("coolant anomaly", [&e, temp_K_safe]() {
+    setup_thermal_anomaly(
+        e, temp_K_safe, "Coolant", "coolant", "coolantTemperature", 751);
+  });
+
   // ---------------------------------------------------------------------------
-  // STEP 8 — Debug outputs
+  // STEP 4 — Debug outputs (deferred boot stage)
   // ---------------------------------------------------------------------------
 #if ENABLE_DEBUG_OUTPUTS
-  adc_raw->connect_to(new SKOutputFloat("debug.coolant.adc_input_V"));
-  adc_v_smooth->connect_to(new SKOutputFloat("debug.coolant.adc_filtered_V"));
-  temp_C->connect_to(new SKOutputFloat("debug.coolant.temperature_C_raw"));
-  temp_C_avg->connect_to(new SKOutputFloat("debug.coolant.temperature_C"));
-  temp_K->connect_to(new SKOutputFloat("debug.coolant.temperature_K_raw"));
+  boot_defer("coolant debug", [&e, adc_raw, temp_K_safe]() {
+    adc_raw->connect_to(
+        new LambdaTransform<float, float>([adc_raw](float) {
+          return adc_raw->last_volts();
+        })
+    )->connect_to(batched(g_sk_batcher,
+        new SKOutputFloat(e.debug_path("coolant.adc_input_V")),
+        SK_DEBUG_MIN_INTERVAL_MS));
+
+    adc_raw->connect_to(batched(g_sk_batcher,
+        new SKOutputFloat(e.debug_path("coolant.temperature_K_lut")),
+        SK_DEBUG_MIN_INTERVAL_MS));
+    temp_K_safe->connect_to(batched(g_sk_batcher,
+        new SKOutputFloat(e.debug_path("coolant.temperature_K_raw")),
+        SK_DEBUG_MIN_INTERVAL_MS));
+  });
 #endif
 }
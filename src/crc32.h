@@ -0,0 +1,24 @@
+#pragma once
+
+// ============================================================================
+// CRC-32 (IEEE 802.3, reflected, init/xorout 0xFFFFFFFF)
+// ============================================================================
+//
+// • Bitwise, no table — used for small flash records a few times a second
+// • crc32_ieee("123456789") == 0xCBF43926
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+
+inline uint32_t crc32_ieee(const void* data, size_t len) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= p[i];
+    for (int b = 0; b < 8; b++) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
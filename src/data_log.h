@@ -0,0 +1,373 @@
+#pragma once
+
+// ============================================================================
+// Engine data ring log — fixed 32-byte records in raw flash
+// ============================================================================
+//
+// • LogRecord: timestamp + 8 engine channels as scaled uint16 (0xFFFF = n/a)
+//     rev/s     0.01 rev/s      coolant   0.01 K      oil     100 Pa
+//     temp[3]   0.01 K          fuel      0.01 L/h    load    0.0001
+// • Each 4 KB sector: slot 0 = header { magic, sequence }, slots 1..127 =
+//   records. Records are buffered in RAM and programmed one 256-byte page
+//   at a time (page aligned, 8 records) or on flush()
+// • Ring: the oldest sector is erased when the write position enters it;
+//   boot resumes after the last programmed slot of the newest sector
+// • Reader walks sectors oldest → newest and yields CRC-valid records only
+//   (torn writes and erased slots are skipped); mark() / range() select
+//   the records written between two points (store-and-forward replay)
+// • Storage is a JournalFlash (hours_journal.h) — same raw partition
+//   backend as the hours journal, RAM backend in the unit tests
+// ============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "crc32.h"
+#include "hours_journal.h"
+
+// ============================================================================
+// Record
+// ============================================================================
+struct LogRecord {
+  static constexpr uint16_t NA          = 0xFFFF;
+  static constexpr uint16_t CLOCK_VALID = 0x0001;   // time_s is Unix time
+  static constexpr size_t   NUM_TEMPS   = 3;
+
+  uint32_t time_s;        // Unix seconds, or uptime seconds without a clock
+  uint16_t time_ms;
+  uint16_t flags;
+  uint16_t rev_s;         // 0.01 rev/s
+  uint16_t coolant_K;     // 0.01 K
+  uint16_t oil_hPa;       // 100 Pa
+  uint16_t temp_K[NUM_TEMPS];   // 0.01 K (engine room, exhaust, alternator)
+  uint16_t fuel_lph;      // 0.01 L/h
+  uint16_t load;          // 0.0001 (ratio)
+  uint16_t reserved[3];   // NA — room for future channels
+  uint16_t crc;           // low 16 bits of CRC-32 over the bytes above
+
+  static uint16_t scale(float value, float resolution) {
+    if (!std::isfinite(value)) return NA;
+    const float raw = std::round(value / resolution);
+    if (raw < 0.0f || raw >= 65535.0f) return NA;
+    return static_cast<uint16_t>(raw);
+  }
+
+  static float unscale(uint16_t raw, float resolution) {
+    return (raw == NA) ? NAN : raw * resolution;
+  }
+
+  void seal() {
+    crc = static_cast<uint16_t>(crc32_ieee(this, offsetof(LogRecord, crc)));
+  }
+
+  bool valid() const {
+    return crc == static_cast<uint16_t>(crc32_ieee(this, offsetof(LogRecord, crc)));
+  }
+};
+
+static_assert(sizeof(LogRecord) == 32, "log record must be 32 bytes");
+
+// Channel resolutions (also written into the download header)
+static constexpr float LOG_RES_REV_S = 0.01f;
+static constexpr float LOG_RES_TEMP  = 0.01f;
+static constexpr float LOG_RES_OIL   = 100.0f;
+static constexpr float LOG_RES_FUEL  = 0.01f;
+static constexpr float LOG_RES_LOAD  = 0.0001f;
+
+// First 16 bytes of the /api/datalog download, followed by LogRecords
+// oldest → newest (read back on the host by tools/log_eval)
+static constexpr uint16_t LOG_FILE_VERSION = 1;
+
+struct LogFileHeader {
+  uint32_t magic;           // RingLog::MAGIC
+  uint16_t version;         // LOG_FILE_VERSION
+  uint16_t record_bytes;
+  uint32_t capacity;        // records
+  uint32_t reserved;
+};
+
+static_assert(sizeof(LogFileHeader) == 16, "log file header must be 16 bytes");
+
+// ============================================================================
+// Ring log
+// ============================================================================
+class RingLog {
+ public:
+  static constexpr size_t   RECORD_BYTES      = sizeof(LogRecord);
+  static constexpr size_t   PAGE_BYTES        = 256;
+  static constexpr size_t   RECORDS_PER_PAGE  = PAGE_BYTES / RECORD_BYTES;
+  static constexpr size_t   SLOTS_PER_SECTOR  =
+      JournalFlash::SECTOR_BYTES / RECORD_BYTES;               // 128
+  static constexpr size_t   RECORDS_PER_SECTOR = SLOTS_PER_SECTOR - 1;
+  static constexpr uint32_t MAGIC             = 0x594C4F47;    // "YLOG"
+
+  // Write position (next slot to be appended)
+  struct Mark {
+    size_t   sector = 0;
+    size_t   slot   = 1;
+    uint32_t seq    = 0;
+  };
+
+  // Position of a reader; sectors outside [min_seq, max_seq] are skipped,
+  // the max_seq sector is read up to end_slot
+  struct Cursor {
+    size_t   first    = 0;   // first sector
+    uint32_t min_seq  = 0;
+    uint32_t max_seq  = 0;
+    size_t   end_slot = 0;
+    size_t   step     = 0;   // sectors visited, 0..sectors()
+    size_t   slot     = 1;   // next slot in the current sector
+  };
+
+  explicit RingLog(JournalFlash* flash) : flash_(flash) {}
+
+  // -------------------------------------------------------------------------
+  // Locate the newest sector and resume after its last programmed slot
+  // -------------------------------------------------------------------------
+  bool begin() {
+    ready_     = false;
+    buffered_  = 0;
+    if (!flash_ || flash_->size() < 2 * JournalFlash::SECTOR_BYTES) {
+      return false;
+    }
+
+    num_sectors_ = flash_->size() / JournalFlash::SECTOR_BYTES;
+
+    bool found = false;
+    for (size_t s = 0; s < num_sectors_; s++) {
+      uint32_t seq;
+      if (read_header(s, seq) && (!found || seq > sequence_)) {
+        found     = true;
+        sequence_ = seq;
+        sector_   = s;
+      }
+    }
+
+    if (!found) {
+      sequence_  = 0;
+      sector_    = num_sectors_ - 1;
+      next_slot_ = SLOTS_PER_SECTOR;     // first append opens sector 0
+    } else {
+      next_slot_ = SLOTS_PER_SECTOR;
+      for (size_t slot = SLOTS_PER_SECTOR - 1; slot >= 1; slot--) {
+        if (!slot_erased(sector_, slot)) break;
+        next_slot_ = slot;
+      }
+    }
+
+    ready_ = true;
+    return true;
+  }
+
+  // -------------------------------------------------------------------------
+  // Buffer one record; programs a page when it fills
+  // -------------------------------------------------------------------------
+  bool append(const LogRecord& record) {
+    if (!ready_) {
+      return false;
+    }
+
+    if (buffered_ == 0 && next_slot_ >= SLOTS_PER_SECTOR && !open_next_sector()) {
+      return false;
+    }
+
+    if (buffered_ == 0) {
+      buffer_slot_ = next_slot_;
+    }
+
+    buffer_[buffered_] = record;
+    buffer_[buffered_].seal();
+    buffered_++;
+    next_slot_++;
+    count_++;
+
+    if (next_slot_ % RECORDS_PER_PAGE == 0) {
+      return flush();   // page boundary (or sector end)
+    }
+    return true;
+  }
+
+  // Program the buffered records (partial page)
+  bool flush() {
+    if (buffered_ == 0) {
+      return true;
+    }
+
+    const size_t off = sector_offset(sector_) + buffer_slot_ * RECORD_BYTES;
+    const bool ok = flash_->write(off, buffer_, buffered_ * RECORD_BYTES);
+    buffered_ = 0;
+    return ok;
+  }
+
+  // -------------------------------------------------------------------------
+  // Reader — up to max valid records, in order; 0 when done
+  // (call flush() first to include buffered records; sectors overwritten
+  // while reading are skipped)
+  // -------------------------------------------------------------------------
+  Cursor oldest() const {
+    Cursor c;
+    c.first    = ready_ ? (sector_ + 1) % num_sectors_ : 0;
+    c.max_seq  = sequence_;
+    c.end_slot = SLOTS_PER_SECTOR;
+    return c;
+  }
+
+  // Everything appended after `from`, up to `to` (both from mark())
+  Cursor range(const Mark& from, const Mark& to) const {
+    Cursor c;
+    c.first    = from.sector;
+    c.slot     = from.slot;
+    c.min_seq  = from.seq;
+    c.max_seq  = to.seq;
+    c.end_slot = to.slot;
+    return c;
+  }
+
+  // Everything appended up to `to` (from mark()), oldest first
+  Cursor until(const Mark& to) const {
+    Cursor c   = oldest();
+    c.max_seq  = to.seq;
+    c.end_slot = to.slot;
+    return c;
+  }
+
+  Mark mark() const {
+    Mark m;
+    m.sector = sector_;
+    m.slot   = next_slot_;
+    m.seq    = sequence_;
+    return m;
+  }
+
+  size_t read(Cursor& cursor, LogRecord* out, size_t max) {
+    if (!ready_) {
+      return 0;
+    }
+
+    size_t n = 0;
+    while (n < max && cursor.step < num_sectors_) {
+      const size_t s = (cursor.first + cursor.step) % num_sectors_;
+
+      uint32_t seq = 0;
+      const bool in_range = read_header(s, seq) &&
+                            seq >= cursor.min_seq && seq <= cursor.max_seq;
+      const bool last     = in_range && seq == cursor.max_seq;
+      const size_t limit  = (last && cursor.end_slot < SLOTS_PER_SECTOR)
+                                ? cursor.end_slot : SLOTS_PER_SECTOR;
+
+      if (!in_range || cursor.slot >= limit) {
+        cursor.step = last ? num_sectors_ : cursor.step + 1;   // newest: done
+        cursor.slot = 1;
+        continue;
+      }
+
+      // One flash read for as many slots as fit, then keep the valid ones
+      const size_t want = std::min(max - n, limit - cursor.slot);
+      const size_t off  = sector_offset(s) + cursor.slot * RECORD_BYTES;
+      if (!flash_->read(off, out + n, want * RECORD_BYTES)) {
+        cursor.slot = limit;
+        continue;
+      }
+
+      size_t kept = 0;
+      for (size_t i = 0; i < want; i++) {
+        const LogRecord& r = out[n + i];
+        if (erased(&r)) {
+          cursor.slot = limit;   // rest of the sector is empty
+          break;
+        }
+        cursor.slot++;
+        if (r.valid()) {
+          out[n + kept++] = r;   // compact in place (kept ≤ i)
+        }
+      }
+      n += kept;
+    }
+    return n;
+  }
+
+  bool     ready() const    { return ready_; }
+  size_t   sectors() const  { return num_sectors_; }
+  uint32_t sequence() const { return sequence_; }
+  uint32_t appended() const { return count_; }
+  size_t   capacity() const { return num_sectors_ * RECORDS_PER_SECTOR; }
+
+ private:
+  struct Header {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t record_bytes;
+    uint32_t reserved[4];
+    uint32_t crc;
+  };
+
+  static_assert(sizeof(Header) == sizeof(LogRecord), "header fills slot 0");
+
+  JournalFlash* flash_;
+  bool      ready_       = false;
+  size_t    num_sectors_ = 0;
+  size_t    sector_      = 0;
+  uint32_t  sequence_    = 0;
+  size_t    next_slot_   = 1;
+  uint32_t  count_       = 0;
+
+  LogRecord buffer_[RECORDS_PER_PAGE];
+  size_t    buffer_slot_ = 1;
+  size_t    buffered_    = 0;
+
+  static size_t sector_offset(size_t s) {
+    return s * JournalFlash::SECTOR_BYTES;
+  }
+
+  // Erase the oldest sector (~30 ms, once per 127 records) and stamp it
+  bool open_next_sector() {
+    const size_t s = (sector_ + 1) % num_sectors_;
+    if (!flash_->erase_sector(sector_offset(s))) {
+      return false;
+    }
+
+    Header h;
+    memset(&h, 0xFF, sizeof(h));
+    h.magic        = MAGIC;
+    h.sequence     = sequence_ + 1;
+    h.record_bytes = RECORD_BYTES;
+    h.crc          = crc32_ieee(&h, offsetof(Header, crc));
+
+    if (!flash_->write(sector_offset(s), &h, sizeof(h))) {
+      return false;
+    }
+
+    sector_    = s;
+    sequence_  = h.sequence;
+    next_slot_ = 1;
+    return true;
+  }
+
+  bool read_header(size_t s, uint32_t& seq) {
+    Header h;
+    if (!flash_->read(sector_offset(s), &h, sizeof(h)) ||
+        h.magic != MAGIC || h.record_bytes != RECORD_BYTES ||
+        h.crc != crc32_ieee(&h, offsetof(Header, crc))) {
+      return false;
+    }
+    seq = h.sequence;
+    return true;
+  }
+
+  bool slot_erased(size_t s, size_t slot) {
+    LogRecord r;
+    return flash_->read(sector_offset(s) + slot * RECORD_BYTES, &r, sizeof(r)) &&
+           erased(&r);
+  }
+
+  static bool erased(const LogRecord* r) {
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(r);
+    for (size_t i = 0; i < sizeof(LogRecord); i++) {
+      if (p[i] != 0xFF) return false;
+    }
+    return true;
+  }
+};
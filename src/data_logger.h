@@ -0,0 +1,273 @@
+#pragma once
+
+// ============================================================================
+// DataLogger — on-device engine time series + streaming HTTP download
+// ============================================================================
+//
+// • Samples every channel sink each interval_ms (UI, 100 ms – 60 s) into a
+//   32-byte LogRecord and appends it to a RingLog on the "datalog" flash
+//   partition (16 MB table: 3.9 MB ≈ 35 h at 1 Hz, ≈ 3.5 h at 10 Hz)
+// • Flash is programmed one 256-byte page at a time; buffered records are
+//   flushed at least every FLUSH_INTERVAL_MS (bounded loss on power cut)
+// • GET /api/datalog streams the ring oldest → newest with chunked
+//   transfer encoding: a 16-byte file header, then raw LogRecords, read
+//   1 KB at a time — the file is never held in RAM
+// • Keeps recording while Signal K is unreachable (no network dependency);
+//   mark() / range() / read() give SkReplay the records of an outage,
+//   recorded() the bench simulator a snapshot of the whole log
+// • Emits the number of records written since boot
+// ============================================================================
+
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <esp_log.h>
+#include <sys/time.h>
+
+#include "sensesp/net/http_server.h"
+#include "sensesp/sensors/sensor.h"
+#include "sensesp_app.h"
+
+#include "data_log.h"
+#include "journal_partition.h"
+#include "latest_value.h"
+
+using namespace sensesp;
+
+// Raw data partition holding the RingLog (partitions_16MB.csv)
+static constexpr const char* DATALOG_PARTITION = "datalog";
+
+class DataLogger : public Sensor<float> {
+ public:
+  static constexpr uint32_t MIN_INTERVAL_MS     = 100;     // 10 Hz
+  static constexpr uint32_t MAX_INTERVAL_MS     = 60000;
+  static constexpr uint32_t FLUSH_INTERVAL_MS   = 5000;
+  static constexpr size_t   CHUNK_RECORDS       = 32;      // 1 KB per chunk
+  static constexpr uint16_t FILE_FORMAT_VERSION = LOG_FILE_VERSION;
+
+  typedef LogFileHeader FileHeader;   // data_log.h
+
+  explicit DataLogger(const String& config_path = "")
+      : Sensor<float>(config_path), log_(nullptr) {
+    this->load();
+  }
+
+  // Channel sinks (connect producers here)
+  LatestValue* revolutions() { return &rev_s_; }          // rev/s
+  LatestValue* coolant_temp() { return &coolant_K_; }     // K
+  LatestValue* oil_pressure() { return &oil_Pa_; }        // Pa
+  LatestValue* temperature(size_t i) {                    // K
+    return &temp_K_[i < LogRecord::NUM_TEMPS ? i : 0];
+  }
+  LatestValue* fuel_rate() { return &fuel_lph_; }         // L/h
+  LatestValue* engine_load() { return &load_; }           // 0..1
+
+  // -------------------------------------------------------------------------
+  // Open the partition, resume the ring, start sampling, register HTTP
+  // -------------------------------------------------------------------------
+  void start() {
+    flash_ = PartitionJournalFlash::open(DATALOG_PARTITION);
+    log_   = RingLog(flash_);
+
+    if (!log_.begin()) {
+      ESP_LOGW("DataLog", "No '%s' partition, logging disabled",
+               DATALOG_PARTITION);
+      return;
+    }
+
+    mutex_ = xSemaphoreCreateMutex();
+
+    ESP_LOGI("DataLog", "%u sectors (%u records), every %u ms",
+             static_cast<unsigned>(log_.sectors()),
+             static_cast<unsigned>(log_.capacity()),
+             static_cast<unsigned>(interval_ms_));
+
+    auto* loop = sensesp_app->get_event_loop();
+    loop->onRepeat(MIN_INTERVAL_MS, [this]() { this->sample(); });
+    loop->onRepeat(FLUSH_INTERVAL_MS, [this]() {
+      xSemaphoreTake(mutex_, portMAX_DELAY);
+      log_.flush();
+      xSemaphoreGive(mutex_);
+    });
+
+    auto handler = std::make_shared<HTTPRequestHandler>(
+        1 << HTTP_GET, "/api/datalog",
+        [this](httpd_req_t* req) -> esp_err_t { return this->stream(req); });
+    sensesp_app->get_http_server()->add_handler(handler);
+  }
+
+  // -------------------------------------------------------------------------
+  // Ring access for other consumers (store-and-forward replay)
+  // -------------------------------------------------------------------------
+  bool ready() const { return mutex_ != nullptr; }
+
+  // Current write position; buffered records are programmed first so a
+  // range ending here is complete
+  RingLog::Mark mark() {
+    xSemaphoreTake(mutex_, portMAX_DELAY);
+    log_.flush();
+    const RingLog::Mark m = log_.mark();
+    xSemaphoreGive(mutex_);
+    return m;
+  }
+
+  RingLog::Cursor range(const RingLog::Mark& from,
+                        const RingLog::Mark& to) const {
+    return log_.range(from, to);
+  }
+
+  // Everything recorded so far (not what is appended while reading)
+  RingLog::Cursor recorded() {
+    return log_.until(mark());
+  }
+
+  size_t read(RingLog::Cursor& cursor, LogRecord* out, size_t max) {
+    xSemaphoreTake(mutex_, portMAX_DELAY);
+    const size_t n = log_.read(cursor, out, max);
+    xSemaphoreGive(mutex_);
+    return n;
+  }
+
+  bool to_json(JsonObject& json) override {
+    json["enabled"]     = enabled_;
+    json["interval_ms"] = interval_ms_;
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    if (json["enabled"].is<bool>()) {
+      enabled_ = json["enabled"];
+    }
+    if (json["interval_ms"].is<int>()) {
+      const int ms = json["interval_ms"];
+      interval_ms_ = static_cast<uint32_t>(
+          constrain(ms, static_cast<int>(MIN_INTERVAL_MS),
+                    static_cast<int>(MAX_INTERVAL_MS)));
+    }
+    return true;
+  }
+
+ private:
+  bool     enabled_     = true;
+  uint32_t interval_ms_ = 1000;
+
+  PartitionJournalFlash* flash_ = nullptr;
+  RingLog                log_;
+  SemaphoreHandle_t      mutex_ = nullptr;
+  uint32_t               last_sample_ms_ = 0;
+
+  LatestValue rev_s_;
+  LatestValue coolant_K_;
+  LatestValue oil_Pa_;
+  LatestValue temp_K_[LogRecord::NUM_TEMPS];
+  LatestValue fuel_lph_;
+  LatestValue load_;
+
+  // -------------------------------------------------------------------------
+  // Event loop: one record per interval
+  // -------------------------------------------------------------------------
+  void sample() {
+    const uint32_t now = millis();
+    if (!enabled_ || (now - last_sample_ms_) < interval_ms_) {
+      return;
+    }
+    last_sample_ms_ = now;
+
+    LogRecord r;
+    memset(&r, 0xFF, sizeof(r));
+    stamp(r, now);
+
+    r.rev_s     = LogRecord::scale(rev_s_.get(now), LOG_RES_REV_S);
+    r.coolant_K = LogRecord::scale(coolant_K_.get(now), LOG_RES_TEMP);
+    r.oil_hPa   = LogRecord::scale(oil_Pa_.get(now), LOG_RES_OIL);
+    for (size_t i = 0; i < LogRecord::NUM_TEMPS; i++) {
+      r.temp_K[i] = LogRecord::scale(temp_K_[i].get(now), LOG_RES_TEMP);
+    }
+    r.fuel_lph  = LogRecord::scale(fuel_lph_.get(now), LOG_RES_FUEL);
+    r.load      = LogRecord::scale(load_.get(now), LOG_RES_LOAD);
+
+    xSemaphoreTake(mutex_, portMAX_DELAY);
+    log_.append(r);
+    const uint32_t count = log_.appended();
+    xSemaphoreGive(mutex_);
+
+    emit(static_cast<float>(count));
+  }
+
+  static void stamp(LogRecord& r, uint32_t now_ms) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    if (tv.tv_sec >= 1577836800) {   // 2020-01-01: clock has been set
+      r.time_s  = static_cast<uint32_t>(tv.tv_sec);
+      r.time_ms = static_cast<uint16_t>(tv.tv_usec / 1000);
+      r.flags   = LogRecord::CLOCK_VALID;
+    } else {
+      r.time_s  = now_ms / 1000;
+      r.time_ms = static_cast<uint16_t>(now_ms % 1000);
+      r.flags   = 0;
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // HTTP task: chunked download, 1 KB at a time
+  // -------------------------------------------------------------------------
+  esp_err_t stream(httpd_req_t* req) {
+    static LogRecord chunk[CHUNK_RECORDS];   // httpd serves one request at a time
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition",
+                       "attachment; filename=\"engine_log.bin\"");
+
+    FileHeader h;
+    h.magic        = RingLog::MAGIC;
+    h.version      = FILE_FORMAT_VERSION;
+    h.record_bytes = RingLog::RECORD_BYTES;
+    h.capacity     = static_cast<uint32_t>(log_.capacity());
+    h.reserved     = 0;
+
+    if (httpd_resp_send_chunk(req, reinterpret_cast<const char*>(&h),
+                              sizeof(h)) != ESP_OK) {
+      return ESP_FAIL;
+    }
+
+    xSemaphoreTake(mutex_, portMAX_DELAY);
+    log_.flush();
+    RingLog::Cursor cursor = log_.oldest();
+    xSemaphoreGive(mutex_);
+
+    for (;;) {
+      xSemaphoreTake(mutex_, portMAX_DELAY);
+      const size_t n = log_.read(cursor, chunk, CHUNK_RECORDS);
+      xSemaphoreGive(mutex_);
+
+      if (n == 0) break;
+
+      if (httpd_resp_send_chunk(req, reinterpret_cast<const char*>(chunk),
+                                n * sizeof(LogRecord)) != ESP_OK) {
+        return ESP_FAIL;   // client went away
+      }
+    }
+
+    return httpd_resp_send_chunk(req, nullptr, 0);
+  }
+};
+
+inline String ConfigSchema(const DataLogger&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "enabled": {
+        "title": "Enabled",
+        "type": "boolean",
+        "description": "Record engine data to flash (download: /api/datalog)"
+      },
+      "interval_ms": {
+        "title": "Interval (ms)",
+        "type": "integer",
+        "minimum": 100,
+        "maximum": 60000,
+        "description": "Time between records (100 ms = 10 Hz)"
+      }
+    }
+  })JSON";
+}
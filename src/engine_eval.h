@@ -0,0 +1,585 @@
+// engine_eval.h
+#pragma once
+
+/*
+ * ============================================================================
+ * ENGINE EVAL — FUEL / LOAD MODEL AS ONE PURE FUNCTION
+ * ============================================================================
+ *
+ * PURPOSE
+ * -------
+ *  • The math behind EngineModel (engine_model.h) and engine_load.h, with
+ *    no SensESP / Arduino dependency, so the firmware, the unit tests and
+ *    the host log evaluator (tools/log_eval) run the same code
+ *  • engine_eval()        one sample (ESP32 path, EngineModel::set):
+ *                         early outs, libm cosf / sinf / powf
+ *  • engine_eval_batch()  structure-of-arrays batch (host: re-fitting the
+ *                         curves / wind coefficients against logged data):
+ *                         the branchless form below, same results
+ *
+ * SHARED RPM AXIS (EngineCurveTable)
+ * ----------------------------------
+ *  • The breakpoints of all curves are merged into one axis and every curve
+ *    is resampled onto it (exact — curves are piecewise linear)
+ *  • Fixed-size storage (no heap); unused axis slots hold +inf
+ *  • Single sample: binary search for the segment; batch: number of axis
+ *    points below RPM, counted over all slots (no data-dependent branch)
+ *  • Outside a curve's own range the old CurveInterpolator behaviour is kept:
+ *      below first sample → interpolate from (0, 0)
+ *      above last sample  → hold last value
+ *
+ * BRANCHLESS FORM (engine_eval_batch only)
+ * ----------------------------------------
+ *  • Every case (engine off, docked, STW correction, wind, caps) is computed
+ *    and selected, never returned early; NaN inputs fail every comparison,
+ *    which is exactly the "unavailable" path of the original checks
+ *  • cos / sin / x^0.6 are inline polynomials / Newton steps (float
+ *    precision) instead of libm calls
+ *  • Result: the batch vectorizes on the host with
+ *    g++ -O3 -fno-trapping-math (SSE2 / AVX2, -fopt-info-vec to check);
+ *    IEEE NaN semantics are kept, no -ffast-math
+ *  • On the ESP32 (scalar FPU) evaluating every case costs more than the
+ *    branches it removes — hence the separate single-sample path
+ *  • fuel_lph is NEVER NAN (engine off → 0.0, engine on → finite ≥ idle)
+ *  • Load is NEVER NAN (0.0 when off or max power unknown)
+ * ============================================================================
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "flat_curve.h"
+
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+constexpr float DOCK_SPEED_KTS     = 0.20f;
+constexpr float ENGINE_RUNNING_RPM = 500.0f;
+constexpr float MS_TO_KTS          = 1.94384449f;
+
+constexpr float BSFC_G_PER_KWH        = 240.0f;
+constexpr float FUEL_DENSITY_KG_PER_L = 0.84f;
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+template <typename T>
+static inline T clamp_val(T v, T lo, T hi) {
+  return (v < lo) ? lo : (v > hi) ? hi : v;
+}
+
+static inline bool engine_running(float rpm) {
+  return rpm >= ENGINE_RUNNING_RPM;   // false for NaN
+}
+
+// ============================================================================
+// CURVES (constexpr flat arrays → flash)
+// ============================================================================
+
+// Baseline STW vs RPM
+static constexpr CurvePoint kBaselineStwCurve[] = {
+  {500,0.0f},{1000,1.0f},{1800,2.9f},{2000,4.5f},
+  {2250,5.5f},{2500,6.4f},{3200,7.2f},
+  {3600,7.45f},{3800,7.45f},{3900,7.45f}
+};
+
+// Smoothed baseline fuel curve (anchors preserved)
+static constexpr CurvePoint kBaselineFuelCurve[] = {
+  {  500, 0.60f },
+  { 1000, 0.75f },
+  { 1800, 1.10f },
+
+  { 2000, 1.50f },   // fixed
+  { 2200, 1.85f },
+  { 2400, 2.25f },
+  { 2500, 2.60f },   // fixed
+
+  { 2800, 3.60f },
+  { 3000, 4.40f },
+  { 3200, 5.30f },
+
+  { 3600, 6.90f },   // fixed
+  { 3800, 7.60f },
+  { 3900, 9.60f }
+};
+
+// Rated fuel curve (caps only)
+static constexpr CurvePoint kRatedFuelCurve[] = {
+  {500,0.9f},{1800,1.4f},{2000,1.8f},{2400,2.45f},
+  {2800,3.8f},{3200,5.25f},{3600,7.8f},{3900,9.6f}
+};
+
+// Idle fuel curve
+static constexpr CurvePoint kIdleFuelCurve[] = {
+  { 800,  0.6f },
+  { 3600, 1.4f }
+};
+
+// Max power curve (kW) — Yanmar 3JH3E EPA
+static constexpr CurvePoint kMaxPowerCurve[] = {
+  {1800, 17.9f},
+  {2000, 20.9f},
+  {2400, 24.6f},
+  {2800, 26.8f},
+  {3200, 28.3f},
+  {3600, 29.5f},
+  {3800, 29.83f}
+};
+
+static_assert(flat_curve_sorted(kBaselineStwCurve),  "STW curve must be sorted by RPM");
+static_assert(flat_curve_sorted(kBaselineFuelCurve), "fuel curve must be sorted by RPM");
+static_assert(flat_curve_sorted(kRatedFuelCurve),    "rated curve must be sorted by RPM");
+static_assert(flat_curve_sorted(kIdleFuelCurve),     "idle curve must be sorted by RPM");
+static_assert(flat_curve_sorted(kMaxPowerCurve),     "power curve must be sorted by RPM");
+
+static constexpr FlatCurve baseline_stw_curve(kBaselineStwCurve);
+static constexpr FlatCurve baseline_fuel_curve(kBaselineFuelCurve);
+static constexpr FlatCurve rated_fuel_curve(kRatedFuelCurve);
+static constexpr FlatCurve idle_fuel_curve(kIdleFuelCurve);
+static constexpr FlatCurve max_power_curve(kMaxPowerCurve);
+
+// ============================================================================
+// STW SANITY CHECK
+// ============================================================================
+static inline bool stw_invalid(float rpm, float stw_kts) {
+  if (rpm > 3000 && stw_kts < 4.0f) return true;
+  if (rpm > 2500 && stw_kts < 3.5f) return true;
+  if (rpm > 1000 && stw_kts < 1.0f) return true;
+  return false;
+}
+
+// ============================================================================
+// WIND LOAD MULTIPLIER
+// ============================================================================
+struct WindLoadCoeffs {
+  float min_kts = 7.0f;    // below: no correction
+  float max_kts = 30.0f;   // full strength
+  float head    = 0.30f;   // × cos(AWA), wind forward of the beam
+  float tail    = 0.12f;   // × cos(AWA), wind aft of the beam (helps)
+  float cross   = 0.18f;   // × sin(AWA)
+  float min_factor = 0.90f;
+  float max_factor = 1.45f;
+};
+
+static inline float wind_load_factor(float aws_kts, float awa_rad,
+                                     const WindLoadCoeffs& k) {
+  if (std::isnan(aws_kts) || std::isnan(awa_rad) || aws_kts < k.min_kts) {
+    return 1.0f;
+  }
+
+  constexpr float PI_F = 3.14159265f;
+
+  float angle = clamp_val(fabsf(awa_rad), 0.0f, PI_F);
+  float aws_c = clamp_val(aws_kts, k.min_kts, k.max_kts);
+
+  float head  = cosf(angle);
+  float cross = sinf(angle);
+
+  float strength = (aws_c - k.min_kts) / (k.max_kts - k.min_kts);
+  float penalty = 0.0f;
+
+  if (head > 0.0f) penalty += strength * head * k.head;
+  else             penalty += strength * head * k.tail;
+
+  penalty += strength * cross * k.cross;
+
+  return clamp_val(1.0f + penalty, k.min_factor, k.max_factor);
+}
+
+static inline float wind_load_factor(float aws_kts, float awa_rad) {
+  return wind_load_factor(aws_kts, awa_rad, WindLoadCoeffs());
+}
+
+// ============================================================================
+// MODEL OUTPUT (one struct per evaluation)
+// ============================================================================
+struct EngineModelOutput {
+  float rpm              = 0.0f;   // latched engine speed used for this pass
+  float fuel_lph         = 0.0f;   // NEVER NAN
+  float expected_stw_kts = NAN;    // baseline STW at this RPM
+  float max_kW           = NAN;    // max power available at this RPM
+};
+
+// ============================================================================
+// LOAD FRACTION (0.0–1.0), NEVER NAN
+//   kW   = (L/h * kg/L * 1000 g/kg) / (g/kWh)
+//   load = kW / max_kW(RPM)
+// ============================================================================
+static inline float engine_load_fraction(const EngineModelOutput& o) {
+  // Engine not running / RPM unknown → load = 0
+  if (!engine_running(o.rpm)) {
+    return 0.0f;
+  }
+
+  // Max power unknown/unavailable → load = 0
+  if (!std::isfinite(o.max_kW) || o.max_kW <= 0.0f) {
+    return 0.0f;
+  }
+
+  if (!std::isfinite(o.fuel_lph) || o.fuel_lph <= 0.0f) {
+    return 0.0f;
+  }
+
+  const float kW =
+    (o.fuel_lph * FUEL_DENSITY_KG_PER_L * 1000.0f) / BSFC_G_PER_KWH;
+
+  return clamp_val(kW / o.max_kW, 0.0f, 1.0f);
+}
+
+// ============================================================================
+// Shared-axis curve table
+// ============================================================================
+class EngineCurveTable {
+ public:
+  enum Column { COL_STW = 0, COL_FUEL, COL_RATED, COL_IDLE, COL_MAX_KW, NUM_COLS };
+
+  static constexpr size_t MAX_AXIS_POINTS = 32;
+
+  EngineCurveTable() { clear(); }
+
+  // Merge the breakpoints of the five curves (setup-time). false when the
+  // axis is full (points dropped — see dropped()) or has < 2 points.
+  bool build(const FlatCurve& stw, const FlatCurve& fuel,
+             const FlatCurve& rated, const FlatCurve& idle,
+             const FlatCurve& max_kw) {
+    const FlatCurve* curves[NUM_COLS] = { &stw, &fuel, &rated, &idle, &max_kw };
+
+    clear();
+
+    // Origin included: curves interpolate from (0, 0)
+    insert_axis_point(0.0f);
+    for (auto* c : curves) {
+      for (size_t i = 0; i < c->size(); i++) insert_axis_point((*c)[i].x);
+    }
+
+    for (size_t i = 0; i < MAX_AXIS_POINTS; i++) {
+      const float x = axis_[(i < n_) ? i : (n_ - 1)];   // pad: hold last
+      for (int c = 0; c < NUM_COLS; c++) {
+        cols_[c][i] = curves[c]->interpolate(x);
+      }
+    }
+
+    last_ = (n_ >= 2) ? static_cast<int32_t>(n_) - 1 : 1;
+    return dropped_ == 0 && n_ >= 2;
+  }
+
+  bool build_default() {
+    return build(baseline_stw_curve, baseline_fuel_curve, rated_fuel_curve,
+                 idle_fuel_curve, max_power_curve);
+  }
+
+  size_t size() const    { return n_; }
+  size_t dropped() const { return dropped_; }
+
+  // Every column at rpm (≥ 0): binary search, early outs at the ends
+  void lookup(float rpm, float out[NUM_COLS]) const {
+    if (!(rpm > axis_[0])) {
+      for (int c = 0; c < NUM_COLS; c++) out[c] = cols_[c][0];
+      return;
+    }
+
+    const float* hi = std::lower_bound(axis_, axis_ + n_, rpm);
+    if (hi >= axis_ + n_) {
+      for (int c = 0; c < NUM_COLS; c++) out[c] = cols_[c][last_];
+      return;
+    }
+
+    const size_t i1 = hi - axis_;
+    const size_t i0 = i1 - 1;
+    const float  u  = (rpm - axis_[i0]) / (axis_[i1] - axis_[i0]);
+
+    for (int c = 0; c < NUM_COLS; c++) {
+      out[c] = cols_[c][i0] + (cols_[c][i1] - cols_[c][i0]) * u;
+    }
+  }
+
+  // Same, without a data-dependent branch (batch)
+  void lookup_branchless(float rpm, float out[NUM_COLS]) const {
+    int32_t below = 0;
+#pragma GCC unroll 32
+    for (size_t k = 0; k < MAX_AXIS_POINTS; k++) {
+      below += (axis_[k] < rpm) ? 1 : 0;
+    }
+
+    // i1 = clamp(below, 1, n - 1), as two selects (vectorizes)
+    int32_t i1 = (below < 1) ? 1 : below;
+    i1 = (i1 > last_) ? last_ : i1;
+    const int32_t i0 = i1 - 1;
+
+    const float u = clamp_val((rpm - axis_[i0]) / (axis_[i1] - axis_[i0]),
+                              0.0f, 1.0f);
+
+    for (int c = 0; c < NUM_COLS; c++) {
+      out[c] = cols_[c][i0] + (cols_[c][i1] - cols_[c][i0]) * u;
+    }
+  }
+
+ private:
+  float  axis_[MAX_AXIS_POINTS];
+  float  cols_[NUM_COLS][MAX_AXIS_POINTS];
+  size_t  n_       = 0;
+  size_t  dropped_ = 0;
+  int32_t last_    = 1;   // top segment index, max(n - 1, 1)
+
+  void clear() {
+    n_       = 0;
+    dropped_ = 0;
+    last_    = 1;
+    for (size_t i = 0; i < MAX_AXIS_POINTS; i++) {
+      axis_[i] = INFINITY;
+      for (int c = 0; c < NUM_COLS; c++) cols_[c][i] = NAN;
+    }
+  }
+
+  // Insert x into the sorted, de-duplicated axis
+  void insert_axis_point(float x) {
+    size_t i = 0;
+    while (i < n_ && axis_[i] < x) i++;
+    if (i < n_ && axis_[i] == x) return;
+
+    if (n_ >= MAX_AXIS_POINTS) {
+      dropped_++;
+      return;
+    }
+
+    for (size_t j = n_; j > i; j--) axis_[j] = axis_[j - 1];
+    axis_[i] = x;
+    n_++;
+  }
+};
+
+// ============================================================================
+// Single sample
+// ============================================================================
+struct EngineEvalConfig {
+  bool           use_stw = true;   // UI "use STW"; false → SOG only
+  WindLoadCoeffs wind;
+};
+
+// RPM ≥ 0 (NaN → off), STW / SOG / AWS in kts, AWA in rad (NaN = n/a)
+static inline EngineModelOutput engine_eval(const EngineCurveTable& t,
+                                            const EngineEvalConfig& cfg,
+                                            float rpm, float stw_kts,
+                                            float sog_kts, float aws_kts,
+                                            float awa_rad) {
+  const float r = (rpm > 0.0f) ? rpm : 0.0f;   // NaN → off
+
+  EngineModelOutput o;
+  o.rpm = r;
+
+  float curve[EngineCurveTable::NUM_COLS];
+  t.lookup(r, curve);
+
+  o.expected_stw_kts = curve[EngineCurveTable::COL_STW];
+  o.max_kW           = curve[EngineCurveTable::COL_MAX_KW];
+
+  // Engine off → zero fuel
+  if (!engine_running(r)) {
+    o.fuel_lph = 0.0f;
+    return o;
+  }
+
+  const bool stw_valid = !std::isnan(stw_kts);
+  const bool sog_valid = !std::isnan(sog_kts);
+
+  // Dock / idle
+  if ((cfg.use_stw && stw_valid && stw_kts <= DOCK_SPEED_KTS) ||
+      (sog_valid && sog_kts <= DOCK_SPEED_KTS)) {
+    float idle = curve[EngineCurveTable::COL_IDLE];
+    if (std::isnan(idle) || idle <= 0.0f) idle = 0.6f;
+    o.fuel_lph = idle;
+    return o;
+  }
+
+  // Underway
+  const float base_fuel = curve[EngineCurveTable::COL_FUEL];
+  const float base_stw  = curve[EngineCurveTable::COL_STW];
+  const float fuel_max  = curve[EngineCurveTable::COL_RATED];
+
+  if (std::isnan(base_fuel) || base_fuel <= 0.0f) {
+    o.fuel_lph = 0.6f;
+    return o;
+  }
+
+  float stw_factor = 1.0f;
+  if (cfg.use_stw && stw_valid && !stw_invalid(r, stw_kts) &&
+      !std::isnan(base_stw) && base_stw > DOCK_SPEED_KTS) {
+
+    const float ratio = base_stw / stw_kts;
+    if (ratio >= 1.05f) {
+      stw_factor = clamp_val(powf(ratio, 0.6f), 1.0f, 2.0f);
+    }
+  }
+
+  const float wind_factor = wind_load_factor(aws_kts, awa_rad, cfg.wind);
+
+  float fuel = base_fuel * stw_factor * wind_factor;
+  if (!std::isnan(fuel_max) && fuel > fuel_max) fuel = fuel_max;
+
+  o.fuel_lph = clamp_val(fuel, 0.0f, 14.0f);
+  return o;
+}
+
+// ============================================================================
+// Batch (structure of arrays)
+// ============================================================================
+struct EngineBatchInputs {
+  const float* rpm;
+  const float* stw_kts;
+  const float* sog_kts;
+  const float* aws_kts;
+  const float* awa_rad;
+};
+
+struct EngineBatchOutputs {
+  float* fuel_lph;
+  float* load;
+};
+
+// cos / sin of x in [0, π] (Taylor series around π/2, error < 2e-7).
+// libm cosf / sinf / powf are calls the host compiler cannot vectorize
+// without -ffast-math, which would also drop the NaN checks below
+static inline void cos_sin_half_turn(float x, float& c, float& s) {
+  const float t  = x - 1.57079633f;
+  const float t2 = t * t;
+
+  c = -t * (1.0f + t2 * (-1.0f / 6.0f + t2 * (1.0f / 120.0f +
+          t2 * (-1.0f / 5040.0f + t2 * (1.0f / 362880.0f +
+          t2 * (-1.0f / 39916800.0f))))));
+  s = 1.0f + t2 * (-0.5f + t2 * (1.0f / 24.0f + t2 * (-1.0f / 720.0f +
+          t2 * (1.0f / 40320.0f + t2 * (-1.0f / 3628800.0f +
+          t2 * (1.0f / 479001600.0f))))));
+}
+
+// x^0.6 for x in [1, 3.2] (clamped): Newton on y^5 = x^3, error < 3e-7
+static inline float pow_0_6(float x) {
+  const float r = clamp_val(x, 1.0f, 3.2f);
+  const float d = r - 1.0f;
+  const float c = r * r * r;
+
+  float y = 1.0f + 0.6f * d - 0.045f * d * d;
+  for (int k = 0; k < 3; k++) {
+    const float y4 = (y * y) * (y * y);
+    y -= (y4 * y - c) / (5.0f * y4);
+  }
+  return y;
+}
+
+static inline bool stw_invalid_mask(float rpm, float stw_kts) {
+  return ((rpm > 3000) & (stw_kts < 4.0f)) |
+         ((rpm > 2500) & (stw_kts < 3.5f)) |
+         ((rpm > 1000) & (stw_kts < 1.0f));
+}
+
+static inline float wind_load_factor_branchless(float aws_kts, float awa_rad,
+                                                const WindLoadCoeffs& k) {
+  constexpr float PI_F = 3.14159265f;
+
+  const float angle = clamp_val(fabsf(awa_rad), 0.0f, PI_F);
+  const float aws_c = clamp_val(aws_kts, k.min_kts, k.max_kts);
+
+  float head, cross;
+  cos_sin_half_turn(angle, head, cross);
+
+  const float strength = (aws_c - k.min_kts) / (k.max_kts - k.min_kts);
+  const float k_head   = (head > 0.0f) ? k.head : k.tail;
+  const float penalty  = strength * head * k_head + strength * cross * k.cross;
+
+  const float factor = clamp_val(1.0f + penalty, k.min_factor, k.max_factor);
+
+  // NaN AWS / AWA or light wind → no correction
+  return ((aws_kts >= k.min_kts) & (awa_rad == awa_rad)) ? factor : 1.0f;
+}
+
+// engine_load_fraction() without the running check (fuel is 0 when off)
+static inline float engine_load_from_fuel(float fuel_lph, float max_kW) {
+  const float kW   = (fuel_lph * FUEL_DENSITY_KG_PER_L * 1000.0f) / BSFC_G_PER_KWH;
+  const float load = clamp_val(kW / max_kW, 0.0f, 1.0f);
+
+  // Max power or fuel unknown / ≤ 0 → 0
+  const bool valid = (max_kW > 0.0f) & (max_kW < INFINITY) &
+                     (fuel_lph > 0.0f) & (fuel_lph < INFINITY);
+  return valid ? load : 0.0f;
+}
+
+// engine_eval() as selects: fuel L/h, max power left in max_kw
+static inline float engine_fuel_branchless(const EngineCurveTable& t,
+                                           const EngineEvalConfig& cfg,
+                                           float rpm, float stw_kts,
+                                           float sog_kts, float aws_kts,
+                                           float awa_rad, float& max_kw) {
+  const float r = (rpm > 0.0f) ? rpm : 0.0f;   // NaN → off
+
+  float curve[EngineCurveTable::NUM_COLS];
+  t.lookup_branchless(r, curve);
+
+  const float base_stw  = curve[EngineCurveTable::COL_STW];
+  const float base_fuel = curve[EngineCurveTable::COL_FUEL];
+  const float fuel_max  = curve[EngineCurveTable::COL_RATED];
+  const float idle      = curve[EngineCurveTable::COL_IDLE];
+
+  // Dock / idle (NaN speeds never count as docked)
+  const bool docked = (cfg.use_stw & (stw_kts <= DOCK_SPEED_KTS)) |
+                      (sog_kts <= DOCK_SPEED_KTS);
+  const float idle_fuel = (idle > 0.0f) ? idle : 0.6f;
+
+  // Underway: STW shortfall vs. baseline → more fuel
+  const float ratio  = base_stw / stw_kts;
+  const bool  stw_ok = cfg.use_stw & (stw_kts == stw_kts) &
+                       !stw_invalid_mask(rpm, stw_kts) &   // same as r: NaN / ≤ 0 pass
+                       (base_stw > DOCK_SPEED_KTS) & (ratio >= 1.05f);
+  const float stw_factor =
+      stw_ok ? clamp_val(pow_0_6(ratio), 1.0f, 2.0f) : 1.0f;
+
+  const float wind_factor = wind_load_factor_branchless(aws_kts, awa_rad, cfg.wind);
+
+  float fuel = base_fuel * stw_factor * wind_factor;
+  fuel = (fuel > fuel_max) ? fuel_max : fuel;   // NaN cap → uncapped
+  fuel = clamp_val(fuel, 0.0f, 14.0f);
+
+  // Select: engine off → 0, docked → idle, no base fuel → 0.6, else fuel
+  float out = (base_fuel > 0.0f) ? fuel : 0.6f;
+  out = docked ? idle_fuel : out;
+  out = engine_running(r) ? out : 0.0f;
+
+  max_kw = curve[EngineCurveTable::COL_MAX_KW];
+  return out;
+}
+
+// n samples; input and output arrays must not overlap. Same results as
+// engine_eval() + engine_load_fraction() per sample. Two passes, each of
+// which vectorizes (one fused loop does not with GCC 12): the model
+// leaves max_kW in load[], then load[] is converted in place
+static inline void engine_eval_batch(const EngineCurveTable& table,
+                                     const EngineEvalConfig& config,
+                                     const float* __restrict rpm,
+                                     const float* __restrict stw_kts,
+                                     const float* __restrict sog_kts,
+                                     const float* __restrict aws_kts,
+                                     const float* __restrict awa_rad,
+                                     float* __restrict fuel_lph,
+                                     float* __restrict load, size_t n) {
+  // Stack copies (~800 bytes): the stores provably never alias them
+  const EngineCurveTable t   = table;
+  const EngineEvalConfig cfg = config;
+
+  for (size_t i = 0; i < n; i++) {
+    fuel_lph[i] = engine_fuel_branchless(t, cfg, rpm[i], stw_kts[i], sog_kts[i],
+                                         aws_kts[i], awa_rad[i], load[i]);
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    load[i] = engine_load_from_fuel(fuel_lph[i], load[i]);
+  }
+}
+
+static inline void engine_eval_batch(const EngineCurveTable& t,
+                                     const EngineEvalConfig& cfg,
+                                     const EngineBatchInputs& in,
+                                     const EngineBatchOutputs& out,
+                                     size_t n) {
+  engine_eval_batch(t, cfg, in.rpm, in.stw_kts, in.sog_kts, in.aws_kts,
+                    in.awa_rad, out.fuel_lph, out.load, n);
+}
@@ -25,8 +25,15 @@
  *
  * PERSISTENCE
  * -----------
- *  - Stored in ESP32 NVS (Preferences)
- *  - Periodic writes to limit flash wear
+ *  - Integer seconds (no float drift at high hours; ms remainder in RAM)
+ *  - Append-only HoursJournal in the "hours" flash partition: one 16-byte
+ *    record per SAVE_INTERVAL_MS while running, CRC + sequence numbered,
+ *    one sector erase per 256 records (no NVS key rewrite)
+ *  - Legacy NVS value ("engine_hours", float) migrated on first boot
+ *  - No partition (old table, OTA-only update, or not engine 0) → NVS
+ *    integer seconds, written every PREFS_SAVE_INTERVAL_MS
+ *  - One accumulator per engine: NVS namespace and debug paths per
+ *    EngineInstance, the partition belongs to engine 0
  * ============================================================================
  */
 
@@ -38,28 +45,45 @@
 #include <sensesp/transforms/transform.h>
 #include <sensesp/signalk/signalk_output.h>
 
+#include "engine_instance.h"
+#include "hours_journal.h"
+#include "journal_partition.h"
+#include "pipeline_profiler.h"
+#include "sk_output_batcher.h"
+
+extern SkOutputBatcher* g_sk_batcher;
+
 namespace sensesp {
 
+// Raw data partition holding the HoursJournal ring (partitions_*.csv)
+static constexpr const char* ENGINE_HOURS_PARTITION = "hours";
+
 class EngineHours : public Transform<float, float> {
  public:
-  explicit EngineHours(const String& config_path = "")
+  explicit EngineHours(const EngineInstance& e, const String& config_path = "")
       : Transform<float, float>(config_path) {
 
     // ------------------------------------------------------------------------
     // Persistent storage
     // ------------------------------------------------------------------------
-    prefs_.begin("engine_runtime", false);
+    prefs_.begin(e.nvs_name("engine_runtime").c_str(), false);
+    journal_flash_ = e.primary()
+        ? PartitionJournalFlash::open(ENGINE_HOURS_PARTITION) : nullptr;
+    journal_       = HoursJournal(journal_flash_);
     load_hours();
 
 #if ENABLE_DEBUG_OUTPUTS
-    debug_hours_   = new SKOutputFloat("debug.engine.hours");
-    debug_rps_     = new SKOutputFloat("debug.engine.revolutions_hz");  // rev/s
+    debug_hours_   = batched(g_sk_batcher,
+        new SKOutputFloat(e.debug_path("engine.hours")), SK_DEBUG_MIN_INTERVAL_MS);
+    debug_rps_     = batched(g_sk_batcher,
+        new SKOutputFloat(e.debug_path("engine.revolutions_hz")),  // rev/s
+        SK_DEBUG_MIN_INTERVAL_MS);
 #endif
 
     // ------------------------------------------------------------------------
     // Authoritative 1 Hz wall-clock timer (SensESP-managed)
     // ------------------------------------------------------------------------
-    event_loop()->onRepeat(TICK_INTERVAL_MS, [this]() {
+    perf_repeat(e.perf_name("hours_tick"), TICK_INTERVAL_MS, [this]() {
       const unsigned long now = millis();
 
       // First tick establishes timebase only
@@ -78,20 +102,25 @@ class EngineHours : public Transform<float, float> {
       // If last_rev_s_ is NaN: keep previous engine_running_ (ignore sample)
 
       if (engine_running_) {
-        hours_ += (now - last_tick_ms_) / 3600000.0f;
+        pending_ms_ += now - last_tick_ms_;
+        seconds_    += pending_ms_ / 1000;
+        pending_ms_ %= 1000;
       }
 
       last_tick_ms_ = now;
 
       // Emit RAW hours (rounding belongs downstream)
-      emit(hours_);
+      emit(hours());
 
 #if ENABLE_DEBUG_OUTPUTS
-      debug_hours_->set(hours_);
+      debug_hours_->set(hours());
       debug_rps_->set(last_rev_s_);
 #endif
 
-      if (now - last_save_ms_ >= SAVE_INTERVAL_MS) {
+      const uint32_t interval =
+          journal_flash_ ? SAVE_INTERVAL_MS : PREFS_SAVE_INTERVAL_MS;
+
+      if (now - last_save_ms_ >= interval) {
         save_hours();
         last_save_ms_ = now;
       }
@@ -103,6 +132,9 @@ class EngineHours : public Transform<float, float> {
     prefs_.end();
   }
 
+  float hours() const { return seconds_ / 3600.0f; }
+  uint32_t seconds() const { return seconds_; }
+
   // --------------------------------------------------------------------------
   // rev/s input — state only (latched)
   // --------------------------------------------------------------------------
@@ -118,13 +150,15 @@ class EngineHours : public Transform<float, float> {
   // SensESP configuration persistence
   // --------------------------------------------------------------------------
   bool to_json(JsonObject& json) override {
-    json["hours"] = hours_;
+    json["hours"] = hours();
     return true;
   }
 
   bool from_json(const JsonObject& json) override {
     if (json["hours"].is<float>()) {
-      hours_ = json["hours"].as<float>();
+      const float h = json["hours"].as<float>();
+      seconds_    = (h > 0.0f) ? static_cast<uint32_t>(lroundf(h * 3600.0f)) : 0;
+      pending_ms_ = 0;
       save_hours();
     }
     return true;
@@ -137,12 +171,15 @@ class EngineHours : public Transform<float, float> {
   static constexpr float RPM_RUNNING_THRESHOLD     = 500.0f;
   static constexpr float REV_S_RUNNING_THRESHOLD   = RPM_RUNNING_THRESHOLD / 60.0f; // 8.33333...
   static constexpr unsigned long TICK_INTERVAL_MS  = 1000;   // 1 Hz
-  static constexpr unsigned long SAVE_INTERVAL_MS  = 10000;  // flash protection
+  static constexpr unsigned long SAVE_INTERVAL_MS  = 10000;  // journal append
+  static constexpr unsigned long PREFS_SAVE_INTERVAL_MS = 60000;  // NVS fallback
 
   // --------------------------------------------------------------------------
   // State
   // --------------------------------------------------------------------------
-  float hours_ = 0.0f;
+  uint32_t seconds_       = 0;
+  uint32_t pending_ms_    = 0;   // running time not yet a full second
+  uint32_t saved_seconds_ = UINT32_MAX;
 
   float last_rev_s_ = NAN;   // latched rev/s (canonical input)
   bool  engine_running_ = false;
@@ -150,22 +187,58 @@ class EngineHours : public Transform<float, float> {
   unsigned long last_tick_ms_ = 0;
   unsigned long last_save_ms_ = 0;
 
-  Preferences prefs_;
+  Preferences            prefs_;
+  PartitionJournalFlash* journal_flash_ = nullptr;
+  HoursJournal           journal_{nullptr};
 
 #if ENABLE_DEBUG_OUTPUTS
-  SKOutputFloat* debug_hours_   = nullptr;
-  SKOutputFloat* debug_rps_     = nullptr;
+  ValueConsumer<float>* debug_hours_ = nullptr;
+  ValueConsumer<float>* debug_rps_   = nullptr;
 #endif
 
   // --------------------------------------------------------------------------
   // Persistence helpers
   // --------------------------------------------------------------------------
   void load_hours() {
-    hours_ = prefs_.getFloat("engine_hours", 0.0f);
+    if (journal_.begin() && journal_.has_record()) {
+      seconds_       = journal_.seconds();
+      saved_seconds_ = seconds_;
+      ESP_LOGI("EngineHours", "Journal: %u s (record %u)",
+               static_cast<unsigned>(seconds_),
+               static_cast<unsigned>(journal_.sequence()));
+      return;
+    }
+
+    // NVS: integer seconds (fallback store) or the legacy float hours
+    if (prefs_.isKey("engine_secs")) {
+      seconds_ = prefs_.getUInt("engine_secs", 0);
+    } else {
+      const float h = prefs_.getFloat("engine_hours", 0.0f);
+      seconds_ = (h > 0.0f) ? static_cast<uint32_t>(lroundf(h * 3600.0f)) : 0;
+    }
+
+    if (journal_flash_ == nullptr) {
+      ESP_LOGW("EngineHours", "No '%s' partition, using NVS",
+               ENGINE_HOURS_PARTITION);
+      saved_seconds_ = seconds_;
+      return;
+    }
+
+    // First boot with the journal: seed it from NVS
+    save_hours();
   }
 
+  // Only when the count changed — an idle engine never writes flash
   void save_hours() {
-    prefs_.putFloat("engine_hours", hours_);
+    if (seconds_ == saved_seconds_) {
+      return;
+    }
+
+    const bool ok = journal_flash_ ? journal_.append(seconds_)
+                                   : prefs_.putUInt("engine_secs", seconds_) > 0;
+    if (ok) {
+      saved_seconds_ = seconds_;
+    }
   }
 };
 
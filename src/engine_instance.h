@@ -0,0 +1,247 @@
+#pragma once
+
+// ============================================================================
+// EngineInstance — one engine's signals, hardware units and naming
+// ============================================================================
+//
+// • One object per engine on the board (up to MAX_ENGINES, one row each in
+//   main.cpp ENGINES[]): RPM pickup, coolant and oil senders, hours, fuel
+//   and load pipelines are built per instance and publish its signals
+//   (rev/s, load) as members instead of globals
+// • Shared between engines: acquisition task, ADC1 DMA scan (one channel
+//   per sender), SK batcher, NMEA 2000 bus (one engine instance field per
+//   engine), power manager (engine-off only when every engine is off)
+// • Hardware units by index: PCNT_UNIT_<index>, MCPWM_UNIT_<index>
+// • Signal K: propulsion.<id>.* / notifications.propulsion.<id>.* — the
+//   default id "engine" gives exactly the single-engine paths
+// • Engine 0 keeps the original config paths, NVS names and flash
+//   partitions (an upgraded board keeps its calibration, hours and fuel
+//   totals); further engines use /config/<id>/..., NVS names with the
+//   index appended, and NVS for hours / fuel totals
+// • Data log and outage replay cover engine 0 (fixed record layout);
+//   OneWire temperatures (exhaust elbow) belong to engine 0
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+static constexpr size_t      MAX_ENGINES       = 2;          // MCPWM capture units
+static constexpr size_t      ENGINE_ID_MAX_LEN = 16;
+static constexpr size_t      NVS_NAME_MAX_LEN  = 15;         // keys and namespaces
+static constexpr size_t      PERF_NAME_MAX_LEN = 40;         // profiler stage names
+static constexpr size_t      MAX_PERF_NAMES    = 12;         // per engine
+static constexpr int         ENGINE_SORT_STRIDE = 1000;      // config UI order
+static constexpr const char* LEGACY_ENGINE_ID  = "engine";   // single-engine paths
+
+// ----------------------------------------------------------------------------
+// One engine on this board (main.cpp ENGINES[])
+// ----------------------------------------------------------------------------
+struct EngineConfig {
+  const char* id;                // Signal K key: propulsion.<id>
+  uint8_t     n2k_instance;      // PGN 127488 / 127489 engine instance
+  uint8_t     pin_rpm;           // magnetic pickup (PCNT / MCPWM capture)
+  uint8_t     pin_adc_coolant;   // coolant sender (ADC1)
+  uint8_t     pin_adc_oil;       // oil pressure transducer (ADC1)
+  float       rpm_teeth;         // flywheel teeth per revolution
+};
+
+// Signal K key segment: 1..ENGINE_ID_MAX_LEN of [A-Za-z0-9_-]
+inline bool engine_id_valid(const char* id) {
+  if (!id || !id[0]) return false;
+  size_t n = 0;
+  for (const char* c = id; *c; c++, n++) {
+    const bool ok = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') ||
+                    (*c >= '0' && *c <= '9') || *c == '_' || *c == '-';
+    if (!ok || n >= ENGINE_ID_MAX_LEN) return false;
+  }
+  return true;
+}
+
+// ============================================================================
+// Path / key naming (no SensESP dependency)
+//
+// Every writer has snprintf semantics and returns false when `out` was too
+// small (the truncated string is still terminated).
+// ============================================================================
+class EngineNaming {
+ public:
+  EngineNaming(const char* id, uint8_t index) : id_(id), index_(index) {}
+
+  const char* id() const { return id_; }
+  uint8_t index() const { return index_; }
+
+  // Engine 0: original config paths, NVS names, partitions, UI titles
+  bool primary() const { return index_ == 0; }
+
+  // "engine": the non-standard single-engine paths (e.g. oil pressure on
+  // environment.engine.oilPressure) are kept as they were
+  bool legacy_paths() const { return strcmp(id_, LEGACY_ENGINE_ID) == 0; }
+
+  // propulsion.<id>.<leaf>
+  bool sk(char* out, size_t n, const char* leaf) const {
+    return fits(snprintf(out, n, "propulsion.%s.%s", id_, leaf), n);
+  }
+
+  // notifications.propulsion.<id>.<leaf>
+  bool notification(char* out, size_t n, const char* leaf) const {
+    return fits(snprintf(out, n, "notifications.propulsion.%s.%s", id_, leaf), n);
+  }
+
+  // Engine 0: debug.<leaf>; others debug.<id>.<leaf>
+  bool debug(char* out, size_t n, const char* leaf) const {
+    return primary() ? fits(snprintf(out, n, "debug.%s", leaf), n)
+                     : fits(snprintf(out, n, "debug.%s.%s", id_, leaf), n);
+  }
+
+  // Engine 0: as given; others /config/<id>/<rest of the path>
+  bool config(char* out, size_t n, const char* path) const {
+    if (primary()) return fits(snprintf(out, n, "%s", path), n);
+
+    static const char kPrefix[] = "/config";
+    const size_t plen = sizeof(kPrefix) - 1;
+    const char* rest = (strncmp(path, kPrefix, plen) == 0) ? path + plen : path;
+    return fits(snprintf(out, n, "%s/%s%s", kPrefix, id_, rest), n);
+  }
+
+  // Engine 0: as given; others <name><index> (≤ NVS_NAME_MAX_LEN)
+  bool nvs(char* out, size_t n, const char* name) const {
+    const int len = primary() ? snprintf(out, n, "%s", name)
+                              : snprintf(out, n, "%s%u", name,
+                                         static_cast<unsigned>(index_));
+    return fits(len, n) && static_cast<size_t>(len) <= NVS_NAME_MAX_LEN;
+  }
+
+  // Engine 0: as given; others "<id>: <title>"
+  bool title(char* out, size_t n, const char* t) const {
+    return primary() ? fits(snprintf(out, n, "%s", t), n)
+                     : fits(snprintf(out, n, "%s: %s", id_, t), n);
+  }
+
+  // Profiler stage: engine 0 as given; others <id>.<stage>
+  // (debug.perf.<id>.<stage>, like the debug paths)
+  bool perf(char* out, size_t n, const char* stage) const {
+    return primary() ? fits(snprintf(out, n, "%s", stage), n)
+                     : fits(snprintf(out, n, "%s.%s", id_, stage), n);
+  }
+
+  // Config UI: each engine's items in their own block
+  int sort_order(int order) const {
+    return order + static_cast<int>(index_) * ENGINE_SORT_STRIDE;
+  }
+
+ private:
+  const char* id_;
+  uint8_t     index_;
+
+  static bool fits(int len, size_t n) {
+    return len >= 0 && static_cast<size_t>(len) < n;
+  }
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <driver/mcpwm.h>
+#include <driver/pcnt.h>
+#include <esp_log.h>
+
+#include <sensesp/system/valueproducer.h>
+
+#include "data_logger.h"
+#include "n2k_engine_output.h"
+#include "sk_replay.h"
+
+using namespace sensesp;
+
+extern N2kEngineOutput* g_n2k;       // NMEA 2000 (optional)
+extern DataLogger*      g_datalog;   // flash ring log
+extern SkReplay*        g_sk_replay; // outage replay
+
+class EngineInstance : public EngineNaming {
+ public:
+  EngineInstance(const EngineConfig& config, uint8_t index)
+      : EngineNaming(config.id, index), config_(config) {
+    if (!engine_id_valid(config.id)) {
+      ESP_LOGE("Engine", "Invalid engine id '%s' (Signal K key)", config.id);
+    }
+    if (g_n2k) {
+      n2k = g_n2k->add_engine(config.n2k_instance);
+    }
+  }
+
+  const EngineConfig& config() const { return config_; }
+
+  pcnt_unit_t pcnt_unit() const {
+    return static_cast<pcnt_unit_t>(PCNT_UNIT_0 + index());
+  }
+
+  mcpwm_unit_t mcpwm_unit() const {
+    return static_cast<mcpwm_unit_t>(MCPWM_UNIT_0 + index());
+  }
+
+  // Engine 0 only (nullptr for the others)
+  DataLogger* datalog() const { return primary() ? g_datalog : nullptr; }
+  SkReplay* sk_replay() const { return primary() ? g_sk_replay : nullptr; }
+
+  // String forms of the EngineNaming writers
+  String sk_path(const char* leaf) const { return str(&EngineNaming::sk, leaf); }
+  String notification_path(const char* leaf) const {
+    return str(&EngineNaming::notification, leaf);
+  }
+  String debug_path(const char* leaf) const { return str(&EngineNaming::debug, leaf); }
+  String config_path(const char* path) const { return str(&EngineNaming::config, path); }
+  String nvs_name(const char* name) const { return str(&EngineNaming::nvs, name); }
+  String ui_title(const char* t) const { return str(&EngineNaming::title, t); }
+
+  // Stage name for perf_stage() / perf_timed() / perf_repeat(): the
+  // profiler keeps the pointer and merges equal names, so each engine's
+  // qualified copy lives here (engine 0: the literal itself)
+  const char* perf_name(const char* stage) const {
+    if (primary()) return stage;
+
+    char buf[PERF_NAME_MAX_LEN];
+    if (!perf(buf, sizeof(buf), stage)) {
+      ESP_LOGW("Engine", "%s: name too long for '%s'", id(), stage);
+    }
+    for (size_t i = 0; i < num_perf_names_; i++) {
+      if (strcmp(perf_names_[i], buf) == 0) return perf_names_[i];
+    }
+    if (num_perf_names_ >= MAX_PERF_NAMES) {
+      ESP_LOGW("Engine", "%s: perf name table full, '%s' shared", id(), stage);
+      return stage;
+    }
+    char* name = perf_names_[num_perf_names_++];
+    memcpy(name, buf, sizeof(buf));
+    return name;
+  }
+
+  // ---------------------------------------------------------------------------
+  // Signals (set as the pipelines are built; nullptr until then)
+  // ---------------------------------------------------------------------------
+  ValueProducer<float>* frequency    = nullptr;   // rev/s (raw)
+  ValueProducer<float>* rev_s_smooth = nullptr;   // rev/s (CANONICAL)
+  ValueProducer<float>* rad_s        = nullptr;   // rad/s (derived)
+  ValueProducer<float>* load         = nullptr;   // 0..1 (deferred stage)
+
+  N2kEngineOutput::Engine* n2k = nullptr;         // PGN field sinks (optional)
+
+ private:
+  typedef bool (EngineNaming::*Writer)(char*, size_t, const char*) const;
+
+  EngineConfig config_;
+
+  mutable char   perf_names_[MAX_PERF_NAMES][PERF_NAME_MAX_LEN];
+  mutable size_t num_perf_names_ = 0;
+
+  String str(Writer w, const char* arg) const {
+    char buf[128];
+    if (!(this->*w)(buf, sizeof(buf), arg)) {
+      ESP_LOGW("Engine", "%s: name too long for '%s'", id(), arg);
+    }
+    return String(buf);
+  }
+};
+
+#endif  // ARDUINO
@@ -0,0 +1,102 @@
+// engine_model.h
+#pragma once
+
+/*
+ * ============================================================================
+ * ENGINE MODEL — FUSED SINGLE-PASS CURVE EVALUATION (AUTHORITATIVE)
+ * ============================================================================
+ *
+ * PURPOSE
+ * -------
+ *  • One transform evaluates every RPM-keyed engine curve in a single pass
+ *  • Outputs fuel (L/h), expected STW (kts) and max power (kW) together,
+ *    so engine_fuel.h and engine_load.h never re-derive RPM or re-walk curves
+ *
+ * SHARED RPM AXIS / MATH
+ * -----------------------
+ *  • Source curves are constexpr FlatCurve tables in flash (flat_curve.h)
+ *  • The curves, the merged-axis EngineCurveTable and the fuel / load math
+ *    live in engine_eval.h (pure, shared with the host log evaluator);
+ *    this transform only binds them to the SensESP graph
+ *  • The fused table is fixed-size member storage (no heap), built once
+ *
+ * CONTRACT
+ * --------
+ *  • Input: EngineInputs from the CombineLatest join in engine_fuel.h —
+ *    RPM (held, ≥ 0; 0 = engine off), STW/SOG/AWS in kts, AWA in rad
+ *    (NaN when unavailable or stale). Recomputed when any input changes
+ *  • fuel_lph is NEVER NAN (engine off → 0.0, engine on → finite ≥ idle)
+ *  • engine_load_fraction(output) (engine_eval.h) is the load published by
+ *    engine_load.h, so it can be timed and tested without the SensESP graph
+ * ============================================================================
+ */
+
+#include <Arduino.h>
+#include <cmath>
+
+#include <esp_log.h>
+
+#include <sensesp/system/valueproducer.h>
+#include <sensesp/transforms/linear.h>
+#include <sensesp/transforms/transform.h>
+
+#include "combine_latest.h"
+#include "engine_eval.h"
+#include "pipeline_profiler.h"
+
+using namespace sensesp;
+
+// ============================================================================
+// MODEL INPUTS (one CombineLatest slot each)
+// ============================================================================
+enum EngineInput : size_t {
+  IN_RPM = 0,
+  IN_STW_KTS,
+  IN_SOG_KTS,
+  IN_AWS_KTS,
+  IN_AWA_RAD,
+  ENGINE_NUM_INPUTS
+};
+
+typedef LatestValues<ENGINE_NUM_INPUTS> EngineInputs;
+
+// ============================================================================
+// EngineModel transform
+// ============================================================================
+class EngineModel : public Transform<EngineInputs, EngineModelOutput> {
+ public:
+  // perf_name: profiler stage (EngineInstance::perf_name() per engine)
+  explicit EngineModel(Linear* use_stw_cfg,
+                       const char* perf_name = "engine_model",
+                       const String& config_path = "")
+      : Transform<EngineInputs, EngineModelOutput>(config_path),
+        use_stw_cfg_(use_stw_cfg),
+        perf_id_(perf_stage(perf_name)) {
+    if (!table_.build_default()) {
+      ESP_LOGE("EngineModel", "Curve axis exceeds %u points, %u dropped",
+               static_cast<unsigned>(EngineCurveTable::MAX_AXIS_POINTS),
+               static_cast<unsigned>(table_.dropped()));
+    }
+  }
+
+  void set(const EngineInputs& in) override {
+    EngineModelOutput o;
+    {
+      PerfScope perf(perf_id_);   // model pass only, not the consumers
+      o = evaluate(in);
+    }
+    emit(o);
+  }
+
+ private:
+  EngineCurveTable table_;
+  EngineEvalConfig cfg_;
+  Linear*          use_stw_cfg_;
+  int              perf_id_;
+
+  EngineModelOutput evaluate(const EngineInputs& in) {
+    cfg_.use_stw = use_stw_cfg_ ? (use_stw_cfg_->get() >= 0.5f) : true;
+    return engine_eval(table_, cfg_, in[IN_RPM], in[IN_STW_KTS],
+                       in[IN_SOG_KTS], in[IN_AWS_KTS], in[IN_AWA_RAD]);
+  }
+};
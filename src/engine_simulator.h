@@ -0,0 +1,511 @@
+#pragma once
+
+// ============================================================================
+// EngineSimulator — bench hardware-in-the-loop source for the whole engine
+// ============================================================================
+//
+// • Replaces the separate RPM (hw_timer ISR) and coolant (DAC sweep)
+//   simulators: tooth pulses, coolant and oil sender run together
+//     tooth pulses  LEDC square wave, GPIO27      → RPM input (GPIO25)
+//     coolant       DAC2, GPIO26                  → coolant ADC (GPIO39)
+//     oil pressure  LEDC PWM + RC (10k / 1 µF),   → oil ADC (GPIO36)
+//                   GPIO13 (DAC1 is the RPM input pin)
+// • Sender voltages come from the pipelines' own curves (sender_curves.h,
+//   FlatCurve::inverse), so the device reads back the commanded values
+// • Profiles (config UI "Engine Simulator"):
+//     sweep           1000 → 2500 RPM / 10 s, coolant 12 → 95 °C / 30 s
+//     max RPM         tooth rate SIM_MAX_EDGE_HZ (7 kHz), held
+//     throttle steps  800 ↔ 3000 RPM every 3 s
+//     log replay      the on-device ring log (data_log.h records), in
+//                     real time, looped; gaps capped at 2 s
+// • Measured against engine 0 every REPORT_INTERVAL_MS (serial log and the
+//   status page): step settle time of the smoothed rev/s (within 2 % of the
+//   command) and missed tooth edges (commanded − counted); per-stage
+//   latency comes from the pipeline profiler (ENABLE_PIPELINE_PROFILER=1)
+// • Compiled in with -DENGINE_SIMULATOR=1 (platformio.ini); bench use only
+//   — the simulated values are logged and published like real ones
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "data_log.h"
+#include "pipeline_profiler.h"
+
+static constexpr float    SIM_MAX_EDGE_HZ    = 7000.0f;   // stress profile
+static constexpr float    SIM_SWEEP_MIN_RPM  = 1000.0f;
+static constexpr float    SIM_SWEEP_MAX_RPM  = 2500.0f;
+static constexpr uint32_t SIM_SWEEP_MS       = 10000;
+static constexpr float    SIM_COOLANT_MIN_C  = 12.0f;
+static constexpr float    SIM_COOLANT_MAX_C  = 95.0f;
+static constexpr uint32_t SIM_COOLANT_SWEEP_MS = 30000;
+static constexpr float    SIM_HOT_COOLANT_C  = 80.0f;     // steady profiles
+static constexpr float    SIM_STEP_LOW_RPM   = 800.0f;
+static constexpr float    SIM_STEP_HIGH_RPM  = 3000.0f;
+static constexpr uint32_t SIM_STEP_PERIOD_MS = 3000;      // per level
+static constexpr float    SIM_KELVIN         = 273.15f;
+
+enum SimProfile : uint8_t {
+  SIM_SWEEP = 0,
+  SIM_MAX_RPM,
+  SIM_THROTTLE_STEPS,
+  SIM_LOG_REPLAY,
+  SIM_NUM_PROFILES
+};
+
+inline const char* sim_profile_name(SimProfile p) {
+  switch (p) {
+    case SIM_SWEEP:          return "sweep";
+    case SIM_MAX_RPM:        return "max RPM";
+    case SIM_THROTTLE_STEPS: return "throttle steps";
+    case SIM_LOG_REPLAY:     return "log replay";
+    default:                 return "?";
+  }
+}
+
+// Commanded engine state (non-finite rev_s = stopped, no pulses)
+struct SimTarget {
+  float rev_s     = NAN;
+  float coolant_K = NAN;
+  float oil_Pa    = NAN;
+};
+
+// Oil pressure following engine speed: 150 kPa at idle, +100 kPa / 1000 RPM
+inline float sim_oil_pa(float rev_s) {
+  if (!(rev_s > 0.0f)) return 0.0f;
+  const float pa = 150000.0f + rev_s * 60.0f * 100.0f;
+  return (pa < 450000.0f) ? pa : 450000.0f;
+}
+
+// Sawtooth 0..1 with period_ms
+inline float sim_ramp(uint32_t t_ms, uint32_t period_ms) {
+  return static_cast<float>(t_ms % period_ms) / static_cast<float>(period_ms);
+}
+
+// -----------------------------------------------------------------------------
+// Synthetic profiles; t_ms since the profile started
+// -----------------------------------------------------------------------------
+inline SimTarget sim_profile_target(SimProfile p, uint32_t t_ms, float teeth) {
+  SimTarget t;
+  float rpm = NAN;
+
+  switch (p) {
+    case SIM_SWEEP:
+      rpm = SIM_SWEEP_MIN_RPM +
+            sim_ramp(t_ms, SIM_SWEEP_MS) * (SIM_SWEEP_MAX_RPM - SIM_SWEEP_MIN_RPM);
+      t.coolant_K = SIM_KELVIN + SIM_COOLANT_MIN_C +
+                    sim_ramp(t_ms, SIM_COOLANT_SWEEP_MS) *
+                        (SIM_COOLANT_MAX_C - SIM_COOLANT_MIN_C);
+      break;
+
+    case SIM_MAX_RPM:
+      rpm = (teeth > 0.0f) ? SIM_MAX_EDGE_HZ * 60.0f / teeth : NAN;
+      t.coolant_K = SIM_KELVIN + SIM_HOT_COOLANT_C;
+      break;
+
+    case SIM_THROTTLE_STEPS:
+      rpm = ((t_ms / SIM_STEP_PERIOD_MS) % 2) ? SIM_STEP_HIGH_RPM
+                                              : SIM_STEP_LOW_RPM;
+      t.coolant_K = SIM_KELVIN + SIM_HOT_COOLANT_C;
+      break;
+
+    default:
+      return t;
+  }
+
+  t.rev_s  = rpm / 60.0f;
+  t.oil_Pa = sim_oil_pa(t.rev_s);
+  return t;
+}
+
+// -----------------------------------------------------------------------------
+// Log replay: record → command, record spacing (ms) with gaps, reboots and
+// clock changes capped at max_gap_ms
+// -----------------------------------------------------------------------------
+inline SimTarget sim_record_target(const LogRecord& r) {
+  SimTarget t;
+  t.rev_s     = LogRecord::unscale(r.rev_s, LOG_RES_REV_S);
+  t.coolant_K = LogRecord::unscale(r.coolant_K, LOG_RES_TEMP);
+  t.oil_Pa    = LogRecord::unscale(r.oil_hPa, LOG_RES_OIL);
+  return t;
+}
+
+inline uint32_t sim_record_gap_ms(const LogRecord& prev, const LogRecord& next,
+                                  uint32_t max_gap_ms) {
+  const int64_t a = static_cast<int64_t>(prev.time_s) * 1000 + prev.time_ms;
+  const int64_t b = static_cast<int64_t>(next.time_s) * 1000 + next.time_ms;
+  const int64_t d = b - a;
+  if (d < 0 || d > static_cast<int64_t>(max_gap_ms)) return max_gap_ms;
+  return static_cast<uint32_t>(d);
+}
+
+// -----------------------------------------------------------------------------
+// Output codes over 0..3.3 V (DAC: 8 bit, PWM: `bits`)
+// -----------------------------------------------------------------------------
+inline uint32_t sim_volts_code(float volts, uint8_t bits) {
+  const float full = static_cast<float>((1u << bits) - 1);
+  if (!(volts > 0.0f)) return 0;
+  const float code = volts / 3.3f * full + 0.5f;
+  return (code >= full) ? static_cast<uint32_t>(full)
+                        : static_cast<uint32_t>(code);
+}
+
+// ============================================================================
+// StepResponse — settle time after each commanded speed change
+// ============================================================================
+class StepResponse {
+ public:
+  StepResponse(float tolerance, uint32_t timeout_ms)
+      : tolerance_(tolerance), timeout_ms_(timeout_ms) {}
+
+  // A change beyond the tolerance starts a new step
+  void command(float target, uint32_t now_ms) {
+    if (!std::isfinite(target) || target <= 0.0f) {
+      target_ = NAN;
+      armed_  = false;
+      return;
+    }
+    if (std::isfinite(target_) &&
+        std::fabs(target - target_) <= tolerance_ * target_) {
+      return;
+    }
+    if (armed_) unsettled_++;   // previous step never settled
+
+    target_  = target;
+    step_ms_ = now_ms;
+    armed_   = true;
+  }
+
+  void measure(float value, uint32_t now_ms) {
+    if (!armed_) return;
+
+    if (std::isfinite(value) &&
+        std::fabs(value - target_) <= tolerance_ * target_) {
+      stats_.record(now_ms - step_ms_);
+      armed_ = false;
+    } else if (now_ms - step_ms_ > timeout_ms_) {
+      unsettled_++;
+      armed_ = false;
+    }
+  }
+
+  const PerfStats& stats() const { return stats_; }   // ms
+  uint32_t unsettled() const { return unsettled_; }
+
+  // Next report interval (a pending step keeps running)
+  void reset() {
+    stats_.reset();
+    unsettled_ = 0;
+  }
+
+ private:
+  float     tolerance_;
+  uint32_t  timeout_ms_;
+  float     target_    = NAN;
+  uint32_t  step_ms_   = 0;
+  bool      armed_     = false;
+  PerfStats stats_;
+  uint32_t  unsettled_ = 0;
+};
+
+// ============================================================================
+// EdgeAudit — commanded vs counted tooth edges (each rate held until the
+// next update, integrated over the report interval)
+// ============================================================================
+class EdgeAudit {
+ public:
+  void command(float edge_hz, uint32_t now_ms) {
+    advance(now_ms);
+    cmd_hz_ = (std::isfinite(edge_hz) && edge_hz > 0.0f) ? edge_hz : 0.0f;
+  }
+
+  void measure(float edge_hz, uint32_t now_ms) {
+    advance(now_ms);
+    seen_hz_ = (std::isfinite(edge_hz) && edge_hz > 0.0f) ? edge_hz : 0.0f;
+  }
+
+  // Integrate up to now_ms (call before reading)
+  void advance(uint32_t now_ms) {
+    if (started_) {
+      const float dt = static_cast<float>(now_ms - last_ms_) / 1000.0f;
+      commanded_ += cmd_hz_ * dt;
+      counted_   += seen_hz_ * dt;
+    }
+    started_ = true;
+    last_ms_ = now_ms;
+  }
+
+  float commanded() const { return commanded_; }
+  float counted() const { return counted_; }
+
+  // ≥ 0; the sensor window lag shows up as a transient after steps
+  int32_t missed() const {
+    const float d = commanded_ - counted_;
+    return (d > 0.0f) ? static_cast<int32_t>(d + 0.5f) : 0;
+  }
+
+  void reset() {
+    commanded_ = 0.0f;
+    counted_   = 0.0f;
+  }
+
+ private:
+  bool     started_   = false;
+  uint32_t last_ms_   = 0;
+  float    cmd_hz_    = 0.0f;
+  float    seen_hz_   = 0.0f;
+  float    commanded_ = 0.0f;
+  float    counted_   = 0.0f;
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <esp_log.h>
+
+#include <sensesp/system/lambda_consumer.h>
+#include <sensesp/ui/status_page_item.h>
+
+#include "sensesp/sensors/sensor.h"
+#include "sensesp_app.h"
+
+#include "data_logger.h"
+#include "engine_instance.h"
+#include "sender_curves.h"
+
+using namespace sensesp;
+
+static constexpr uint8_t SIM_TOOTH_PIN       = 27;   // → PIN_RPM (GPIO25)
+static constexpr uint8_t SIM_COOLANT_DAC_PIN = 26;   // DAC2 → GPIO39
+static constexpr uint8_t SIM_OIL_PWM_PIN     = 13;   // RC → GPIO36
+
+class EngineSimulator : public Sensor<float> {
+ public:
+  static constexpr uint32_t UPDATE_MS          = 20;
+  static constexpr uint32_t REPORT_INTERVAL_MS = 10000;
+  static constexpr uint32_t MAX_REPLAY_GAP_MS  = 2000;
+  static constexpr size_t   REPLAY_BATCH       = 8;
+  static constexpr float    SETTLE_TOLERANCE   = 0.02f;
+  static constexpr uint32_t SETTLE_TIMEOUT_MS  = 5000;
+
+  // LEDC: channels 0 / 2 sit on separate timers (independent frequencies)
+  static constexpr uint8_t  TOOTH_CHANNEL = 0;
+  static constexpr uint8_t  OIL_CHANNEL   = 2;
+  static constexpr uint32_t OIL_PWM_HZ    = 20000;
+  static constexpr uint8_t  OIL_PWM_BITS  = 10;
+
+  // Emits the commanded rev/s
+  EngineSimulator(EngineInstance* engine, DataLogger* log,
+                  const String& config_path = "")
+      : Sensor<float>(config_path),
+        engine_(engine),
+        log_(log),
+        step_(SETTLE_TOLERANCE, SETTLE_TIMEOUT_MS) {
+    this->load();
+  }
+
+  // After the engine's RPM pipeline and the data logger are started
+  void start() {
+    ledcSetup(TOOTH_CHANNEL, 1000, 10);
+    ledcAttachPin(SIM_TOOTH_PIN, TOOTH_CHANNEL);
+    ledcWriteTone(TOOTH_CHANNEL, 0);
+
+    ledcSetup(OIL_CHANNEL, OIL_PWM_HZ, OIL_PWM_BITS);
+    ledcAttachPin(SIM_OIL_PWM_PIN, OIL_CHANNEL);
+    ledcWrite(OIL_CHANNEL, 0);
+
+    dacWrite(SIM_COOLANT_DAC_PIN, 0);
+
+    // Measured: raw counted rev/s and the canonical smoothed rev/s
+    const float teeth = engine_->config().rpm_teeth;
+    if (engine_->frequency) {
+      engine_->frequency->connect_to(new LambdaConsumer<float>(
+          [this, teeth](float rps) { edges_.measure(rps * teeth, millis()); }));
+    }
+    if (engine_->rev_s_smooth) {
+      engine_->rev_s_smooth->connect_to(new LambdaConsumer<float>(
+          [this](float rps) { step_.measure(rps, millis()); }));
+    }
+
+    ui_profile_ = new StatusPageItem<String>("Profile", "", "Engine Simulator", 10);
+    ui_settle_  = new StatusPageItem<String>("Step settle (ms)", "",
+                                             "Engine Simulator", 20);
+    ui_edges_   = new StatusPageItem<String>("Missed tooth edges", "",
+                                             "Engine Simulator", 30);
+
+    restart(millis());
+
+    auto* loop = sensesp_app->get_event_loop();
+    loop->onRepeat(UPDATE_MS, [this]() { this->update(); });
+    loop->onRepeat(REPORT_INTERVAL_MS, [this]() { this->report(); });
+
+    ESP_LOGI("Sim", "Engine simulator: %s (tooth GPIO%u, coolant GPIO%u, "
+             "oil GPIO%u)", sim_profile_name(profile_),
+             static_cast<unsigned>(SIM_TOOTH_PIN),
+             static_cast<unsigned>(SIM_COOLANT_DAC_PIN),
+             static_cast<unsigned>(SIM_OIL_PWM_PIN));
+  }
+
+  bool to_json(JsonObject& json) override {
+    json["profile"] = static_cast<int>(profile_);
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    if (json["profile"].is<int>()) {
+      const int p = json["profile"].as<int>();
+      profile_ = (p >= 0 && p < SIM_NUM_PROFILES) ? static_cast<SimProfile>(p)
+                                                  : SIM_SWEEP;
+      if (started_) restart(millis());
+    }
+    return true;
+  }
+
+ private:
+  EngineInstance* engine_;
+  DataLogger*     log_;
+  SimProfile      profile_ = SIM_SWEEP;
+  bool            started_ = false;
+  uint32_t        start_ms_ = 0;
+
+  StepResponse    step_;
+  EdgeAudit       edges_;
+  float           tone_hz_ = -1.0f;
+  SimTarget       target_;
+
+  // Log replay: snapshot of the ring at start, looped
+  RingLog::Cursor replay_start_;
+  RingLog::Cursor replay_;
+  LogRecord       batch_[REPLAY_BATCH];
+  size_t          batch_n_   = 0;
+  size_t          batch_i_   = 0;
+  LogRecord       prev_;
+  bool            have_prev_ = false;
+  uint32_t        due_ms_    = 0;
+
+  StatusPageItem<String>* ui_profile_ = nullptr;
+  StatusPageItem<String>* ui_settle_  = nullptr;
+  StatusPageItem<String>* ui_edges_   = nullptr;
+
+  void restart(uint32_t now_ms) {
+    started_  = true;
+    start_ms_ = now_ms;
+
+    if (profile_ == SIM_LOG_REPLAY) {
+      if (log_ && log_->ready()) {
+        replay_start_ = log_->recorded();
+        replay_       = replay_start_;
+      } else {
+        ESP_LOGW("Sim", "No data log to replay, running the sweep");
+        profile_ = SIM_SWEEP;
+      }
+      batch_n_   = batch_i_ = 0;
+      have_prev_ = false;
+      due_ms_    = now_ms;
+    }
+
+    ui_profile_->set(sim_profile_name(profile_));
+  }
+
+  void update() {
+    const uint32_t now = millis();
+
+    if (profile_ == SIM_LOG_REPLAY) {
+      replay_next(now);
+    } else {
+      target_ = sim_profile_target(profile_, now - start_ms_,
+                                   engine_->config().rpm_teeth);
+    }
+    apply(target_, now);
+  }
+
+  // Advance to the record that is due (one per tick at most)
+  void replay_next(uint32_t now) {
+    if (static_cast<int32_t>(now - due_ms_) < 0) return;
+
+    if (batch_i_ >= batch_n_) {
+      batch_n_ = log_->read(replay_, batch_, REPLAY_BATCH);
+      batch_i_ = 0;
+      if (batch_n_ == 0) {
+        if (!have_prev_) {
+          ESP_LOGW("Sim", "Data log is empty, running the sweep");
+          profile_ = SIM_SWEEP;
+          ui_profile_->set(sim_profile_name(profile_));
+          return;
+        }
+        ESP_LOGI("Sim", "Log replay: end of log, restarting");
+        replay_    = replay_start_;
+        have_prev_ = false;
+        return;
+      }
+    }
+
+    const LogRecord& r = batch_[batch_i_++];
+    due_ms_   = now + (have_prev_ ? sim_record_gap_ms(prev_, r, MAX_REPLAY_GAP_MS)
+                                  : 0);
+    prev_      = r;
+    have_prev_ = true;
+    target_    = sim_record_target(r);
+  }
+
+  void apply(const SimTarget& t, uint32_t now) {
+    const float teeth   = engine_->config().rpm_teeth;
+    const float edge_hz = (std::isfinite(t.rev_s) && t.rev_s > 0.0f)
+                              ? t.rev_s * teeth : 0.0f;
+
+    // LEDC reprograms its timer on every call: only on a real change
+    if (std::fabs(edge_hz - tone_hz_) >= 0.5f) {
+      ledcWriteTone(TOOTH_CHANNEL, edge_hz);
+      tone_hz_ = edge_hz;
+      emit(edge_hz / teeth);
+    }
+    edges_.command(edge_hz, now);
+    step_.command((profile_ == SIM_SWEEP) ? NAN : t.rev_s, now);   // no steps in a ramp
+
+    if (std::isfinite(t.coolant_K)) {
+      const float v = coolant_adc_to_temp.inverse(t.coolant_K - SIM_KELVIN);
+      dacWrite(SIM_COOLANT_DAC_PIN, static_cast<uint8_t>(sim_volts_code(v, 8)));
+    }
+    if (std::isfinite(t.oil_Pa)) {
+      const float v = oil_adc_to_pa.inverse(t.oil_Pa);
+      ledcWrite(OIL_CHANNEL, sim_volts_code(v, OIL_PWM_BITS));
+    }
+  }
+
+  void report() {
+    edges_.advance(millis());
+
+    char settle[64];
+    perf_format(settle, sizeof(settle), step_.stats(), 1.0f);
+
+    char edges[48];
+    snprintf(edges, sizeof(edges), "%d of %.0f (unsettled steps %u)",
+             static_cast<int>(edges_.missed()),
+             static_cast<double>(edges_.commanded()),
+             static_cast<unsigned>(step_.unsettled()));
+
+    ESP_LOGI("Sim", "%s: settle ms %s | missed edges %s",
+             sim_profile_name(profile_), settle, edges);
+    ui_settle_->set(settle);
+    ui_edges_->set(edges);
+
+    step_.reset();
+    edges_.reset();
+  }
+};
+
+inline String ConfigSchema(const EngineSimulator&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "profile": {
+        "title": "Profile",
+        "type": "integer",
+        "description": "0 = RPM / coolant sweep, 1 = max RPM (7 kHz tooth rate), 2 = throttle steps 800 ↔ 3000 RPM, 3 = replay the data log"
+      }
+    }
+  })JSON";
+}
+
+#endif  // ARDUINO
@@ -0,0 +1,202 @@
+#pragma once
+
+// ============================================================================
+// FlatCurve — compile-time (constexpr) piecewise-linear lookup tables
+// ============================================================================
+//
+// • Curve points live in a `static constexpr CurvePoint[]` → .rodata (flash,
+//   DROM) instead of std::set nodes in DRAM
+// • Segment lookup by binary search (no pointer chasing)
+// • Same semantics as SensESP CurveInterpolator, so it is a drop-in:
+//      below first point → interpolate from (0, 0)
+//      above last point  → hold last value
+// • UniformCurveLut<N>: optional dense table (e.g. 4096 entries keyed on the
+//   raw 12-bit ADC code) built once at boot, O(1) branch-light lookup
+// • FlatCurveInterpolator: Transform<float,float> wrapper for pipelines
+//   (target only; the rest of the header is pure and builds on the host)
+//
+// Example:
+//   static constexpr CurvePoint kCurve[] = { {0.2f, 100.0f}, {1.4f, 10.0f} };
+//   static constexpr FlatCurve  curve(kCurve);
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+struct CurvePoint {
+  float x;
+  float y;
+};
+
+// Compile-time check: x strictly increasing (C++11 single-return recursion)
+constexpr bool flat_curve_sorted(const CurvePoint* p, size_t n) {
+  return (n < 2) ? true : (p[0].x < p[1].x && flat_curve_sorted(p + 1, n - 1));
+}
+
+template <size_t N>
+constexpr bool flat_curve_sorted(const CurvePoint (&pts)[N]) {
+  return flat_curve_sorted(pts, N);
+}
+
+class FlatCurve {
+ public:
+  template <size_t N>
+  constexpr FlatCurve(const CurvePoint (&pts)[N]) : pts_(pts), n_(N) {}
+
+  constexpr size_t size() const { return n_; }
+  constexpr const CurvePoint& operator[](size_t i) const { return pts_[i]; }
+
+  // -------------------------------------------------------------------------
+  // CurveInterpolator-compatible interpolation (binary search)
+  // -------------------------------------------------------------------------
+  float interpolate(float x) const {
+    if (n_ == 0) {
+      return NAN;
+    }
+
+    // First point with !(x > p.x) — same break rule as CurveInterpolator
+    size_t lo = 0;
+    size_t hi = n_;
+    while (lo < hi) {
+      const size_t mid = (lo + hi) / 2;
+      if (x > pts_[mid].x) lo = mid + 1;
+      else                 hi = mid;
+    }
+
+    if (lo == n_) {
+      return pts_[n_ - 1].y;
+    }
+
+    const float x0 = lo ? pts_[lo - 1].x : 0.0f;
+    const float y0 = lo ? pts_[lo - 1].y : 0.0f;
+    const float x1 = pts_[lo].x;
+    const float y1 = pts_[lo].y;
+
+    if (x1 == x0) {
+      return y1;
+    }
+
+    return (y0 * (x1 - x) + y1 * (x - x0)) / (x1 - x0);
+  }
+
+  // -------------------------------------------------------------------------
+  // Inverse lookup x(y) for a table with monotonic y (rising or falling),
+  // e.g. temperature → sender volts for a simulator. Only the table's own
+  // points are used (no implicit origin); y beyond the ends → end point x.
+  // -------------------------------------------------------------------------
+  float inverse(float y) const {
+    if (n_ == 0 || std::isnan(y)) {
+      return NAN;
+    }
+
+    const bool rising = pts_[n_ - 1].y > pts_[0].y;
+    if (rising ? !(y > pts_[0].y) : !(y < pts_[0].y)) {
+      return pts_[0].x;
+    }
+    if (rising ? !(y < pts_[n_ - 1].y) : !(y > pts_[n_ - 1].y)) {
+      return pts_[n_ - 1].x;
+    }
+
+    // First point at or past y (1 ≤ lo ≤ n_ - 1)
+    size_t lo = 1;
+    size_t hi = n_ - 1;
+    while (lo < hi) {
+      const size_t mid = (lo + hi) / 2;
+      const bool past = rising ? (pts_[mid].y >= y) : (pts_[mid].y <= y);
+      if (past) hi = mid;
+      else      lo = mid + 1;
+    }
+
+    const CurvePoint& a = pts_[lo - 1];
+    const CurvePoint& b = pts_[lo];
+    if (b.y == a.y) {
+      return b.x;
+    }
+    return a.x + (b.x - a.x) * (y - a.y) / (b.y - a.y);
+  }
+
+ private:
+  const CurvePoint* pts_;
+  size_t            n_;
+};
+
+// ============================================================================
+// UniformCurveLut<N> — dense precomputed table
+// ============================================================================
+template <size_t N>
+class UniformCurveLut {
+  static_assert(N >= 2, "UniformCurveLut needs at least 2 entries");
+
+ public:
+  // -------------------------------------------------------------------------
+  // Build on a uniform x grid [x_min, x_max] (lookup() interpolates)
+  // -------------------------------------------------------------------------
+  void build(const FlatCurve& curve, float x_min, float x_max) {
+    x_min_   = x_min;
+    inv_dx_  = (N - 1) / (x_max - x_min);
+    const float dx = (x_max - x_min) / (N - 1);
+
+    for (size_t i = 0; i < N; i++) {
+      values_[i] = curve.interpolate(x_min + i * dx);
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Build keyed on an integer code: values[i] = f(i)
+  // (e.g. raw ADC code → calibrated volts → curve). Use at() to read.
+  // -------------------------------------------------------------------------
+  template <typename KeyToValue>
+  void build_keyed(KeyToValue f) {
+    x_min_  = 0.0f;
+    inv_dx_ = 1.0f;
+    for (size_t i = 0; i < N; i++) {
+      values_[i] = f(i);
+    }
+  }
+
+  // Direct indexed load (index clamped to table)
+  float at(size_t i) const { return values_[(i < N) ? i : (N - 1)]; }
+
+  // Fractional index → linear interpolation between neighbours
+  float at_fractional(float idx) const {
+    if (!(idx > 0.0f)) return values_[0];
+    if (idx >= static_cast<float>(N - 1)) return values_[N - 1];
+
+    const size_t i = static_cast<size_t>(idx);
+    const float  u = idx - static_cast<float>(i);
+    return values_[i] + (values_[i + 1] - values_[i]) * u;
+  }
+
+  // Uniform-grid lookup in x units (clamped to the table range)
+  float lookup(float x) const { return at_fractional((x - x_min_) * inv_dx_); }
+
+  static constexpr size_t size() { return N; }
+
+ private:
+  float values_[N] = {};
+  float x_min_     = 0.0f;
+  float inv_dx_    = 1.0f;
+};
+
+#ifdef ARDUINO
+#include <sensesp/transforms/transform.h>
+
+// ============================================================================
+// FlatCurveInterpolator — drop-in replacement for CurveInterpolator
+// ============================================================================
+class FlatCurveInterpolator : public sensesp::Transform<float, float> {
+ public:
+  explicit FlatCurveInterpolator(const FlatCurve& curve,
+                                 const String& config_path = "")
+      : sensesp::Transform<float, float>(config_path), curve_(curve) {}
+
+  void set(const float& input) override {
+    this->emit(curve_.interpolate(input));
+  }
+
+ private:
+  const FlatCurve& curve_;
+};
+
+#endif  // ARDUINO
@@ -0,0 +1,473 @@
+// fuel_totalizer.h
+#pragma once
+
+/*
+ * ============================================================================
+ * FuelTotalizer — on-device fuel used, trip and economy accumulators
+ * ============================================================================
+ *
+ * INPUTS
+ * ------
+ *  • Raw model fuel rate (L/h, EngineModel — not the display average)
+ *  • SOG (m/s, VesselStateListener), distance counts only while fuel flows
+ *    (engine running) so sailing miles do not flatter the trip economy
+ *
+ * DESIGN
+ * ------
+ *  • Integrated on a 1 Hz wall-clock tick (like EngineHours), not per update
+ *  • Counters in integer mL / m, sub-unit remainder in RAM (no float drift)
+ *  • Rolling window: 60 × 5 s buckets (5 min), running sums updated
+ *    incrementally — O(1) per tick — and re-summed from the ring once per
+ *    rotation, so float rounding cannot build up over hours of running
+ *
+ * PUBLISHES (SI units)
+ * --------------------
+ *  • propulsion.<id>.fuel.used          m³    trip, resettable in the UI
+ *  • propulsion.<id>.fuel.usedLifetime  m³    since install
+ *  • propulsion.<id>.fuel.averageRate   m³/s  5 min rolling
+ *  • propulsion.<id>.fuel.economy       m³/m  5 min rolling (NAN < 50 m)
+ *  • propulsion.<id>.fuel.tripEconomy   m³/m  trip (NAN < 0.1 nm)
+ *  • Status page "Fuel" group in L, L/h, nm and L/nm (one per engine)
+ *
+ * PERSISTENCE
+ * -----------
+ *  • Three HoursJournal rings (lifetime mL, trip mL, trip m) sharing the
+ *    "fuel" flash partition via JournalFlashSlice, appended every
+ *    SAVE_INTERVAL_MS when changed
+ *  • No partition (4 MB table / older 16 MB table), or not engine 0
+ *    → NVS, every PREFS_SAVE_INTERVAL_MS
+ * ============================================================================
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// Integrator (no SensESP dependency)
+// ============================================================================
+class FuelIntegrator {
+ public:
+  static constexpr size_t   WINDOW_BUCKETS          = 60;
+  static constexpr uint32_t BUCKET_MS               = 5000;   // 5 min window
+  static constexpr float    METERS_PER_NM           = 1852.0f;
+  static constexpr float    MIN_ROLLING_DISTANCE_M  = 50.0f;
+  static constexpr float    MIN_TRIP_DISTANCE_M     = 185.2f;   // 0.1 nm
+
+  // One tick: dt of fuel at fuel_lph, distance at sog_ms (NAN → none)
+  void tick(uint32_t dt_ms, float fuel_lph, float sog_ms) {
+    const bool  fuel_flowing = std::isfinite(fuel_lph) && fuel_lph > 0.0f;
+    const float ml = fuel_flowing ? fuel_lph * dt_ms / 3600.0f : 0.0f;
+    const float m  = (fuel_flowing && std::isfinite(sog_ms) && sog_ms > 0.0f)
+                         ? sog_ms * dt_ms / 1000.0f : 0.0f;
+
+    ml_rem_ += ml;
+    const uint32_t whole_ml = static_cast<uint32_t>(ml_rem_);
+    ml_rem_ -= whole_ml;
+    total_ml_ += whole_ml;
+    trip_ml_  += whole_ml;
+
+    m_rem_ += m;
+    const uint32_t whole_m = static_cast<uint32_t>(m_rem_);
+    m_rem_ -= whole_m;
+    trip_m_ += whole_m;
+
+    // Rolling window: fill the open bucket, retire the oldest when full
+    cur_.ml += ml;
+    cur_.m  += m;
+    cur_.ms += dt_ms;
+
+    if (cur_.ms >= BUCKET_MS) {
+      Bucket& old = ring_[head_];
+      sum_.ml += cur_.ml - old.ml;
+      sum_.m  += cur_.m  - old.m;
+      sum_.ms += cur_.ms - old.ms;
+      old   = cur_;
+      cur_  = Bucket();
+      head_ = (head_ + 1) % WINDOW_BUCKETS;
+
+      // Full rotation: drop the accumulated rounding of the running sums
+      if (head_ == 0) {
+        resum();
+      }
+    }
+  }
+
+  // Restore persisted counters
+  void set_counters(uint32_t total_ml, uint32_t trip_ml, uint32_t trip_m) {
+    total_ml_ = total_ml;
+    trip_ml_  = trip_ml;
+    trip_m_   = trip_m;
+  }
+
+  void reset_trip() {
+    trip_ml_ = 0;
+    trip_m_  = 0;
+  }
+
+  uint32_t total_ml() const { return total_ml_; }
+  uint32_t trip_ml() const  { return trip_ml_; }
+  uint32_t trip_m() const   { return trip_m_; }
+
+  // L/h over the window (NAN until a full bucket exists)
+  float rolling_lph() const {
+    const float ms = sum_.ms + cur_.ms;
+    if (sum_.ms <= 0.0f || ms <= 0.0f) return NAN;
+    return (sum_.ml + cur_.ml) / 1000.0f / (ms / 3600000.0f);
+  }
+
+  // L/nm over the window (NAN below MIN_ROLLING_DISTANCE_M)
+  float rolling_l_per_nm() const {
+    return l_per_nm(sum_.ml + cur_.ml, sum_.m + cur_.m, MIN_ROLLING_DISTANCE_M);
+  }
+
+  float trip_l_per_nm() const {
+    return l_per_nm(static_cast<float>(trip_ml_), static_cast<float>(trip_m_),
+                    MIN_TRIP_DISTANCE_M);
+  }
+
+ private:
+  struct Bucket {
+    float ml = 0.0f;
+    float m  = 0.0f;
+    float ms = 0.0f;
+  };
+
+  uint32_t total_ml_ = 0;
+  uint32_t trip_ml_  = 0;
+  uint32_t trip_m_   = 0;
+  float    ml_rem_   = 0.0f;
+  float    m_rem_    = 0.0f;
+
+  Bucket ring_[WINDOW_BUCKETS];
+  Bucket cur_;
+  Bucket sum_;
+  size_t head_ = 0;
+
+  void resum() {
+    sum_ = Bucket();
+    for (size_t i = 0; i < WINDOW_BUCKETS; i++) {
+      sum_.ml += ring_[i].ml;
+      sum_.m  += ring_[i].m;
+      sum_.ms += ring_[i].ms;
+    }
+  }
+
+  static float l_per_nm(float ml, float m, float min_m) {
+    if (!(m >= min_m)) return NAN;
+    return (ml / 1000.0f) / (m / METERS_PER_NM);
+  }
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/system/lambda_consumer.h>
+#include <sensesp/transforms/transform.h>
+#include <sensesp/ui/config_item.h>
+#include <sensesp/ui/status_page_item.h>
+
+#include "engine_instance.h"
+#include "hours_journal.h"
+#include "journal_partition.h"
+#include "pipeline_profiler.h"
+#include "sk_output_batcher.h"
+#include "vessel_state_listener.h"
+
+extern SkOutputBatcher* g_sk_batcher;
+
+namespace sensesp {
+
+// Raw data partition holding the three counter journals (partitions_16MB.csv)
+static constexpr const char* FUEL_TOTAL_PARTITION = "fuel";
+
+class FuelTotalizer : public Transform<float, float> {
+ public:
+  explicit FuelTotalizer(const EngineInstance& e, const String& config_path = "")
+      : Transform<float, float>(config_path) {
+    prefs_.begin(e.nvs_name("fuel_total").c_str(), false);
+    open_journals(e.primary());
+    load_counters();   // config JSON is for UI edits only — the journal owns the counters
+
+    sk_trip_     = output(e.sk_path("fuel.used"));
+    sk_total_    = output(e.sk_path("fuel.usedLifetime"));
+    sk_rate_     = output(e.sk_path("fuel.averageRate"));
+    sk_economy_  = output(e.sk_path("fuel.economy"));
+    sk_trip_eco_ = output(e.sk_path("fuel.tripEconomy"));
+
+    const String group = e.ui_title("Fuel");
+    ui_trip_      = new StatusPageItem<float>("Trip fuel (L)", 0.0f, group, 0);
+    ui_trip_nm_   = new StatusPageItem<float>("Trip distance (nm)", 0.0f, group, 1);
+    ui_trip_eco_  = new StatusPageItem<float>("Trip economy (L/nm)", NAN, group, 2);
+    ui_rate_      = new StatusPageItem<float>("5 min rate (L/h)", NAN, group, 3);
+    ui_economy_   = new StatusPageItem<float>("5 min economy (L/nm)", NAN, group, 4);
+    ui_total_     = new StatusPageItem<float>("Lifetime fuel (L)", 0.0f, group, 5);
+
+    perf_repeat(e.perf_name("fuel_tick"), TICK_INTERVAL_MS, [this]() { this->tick(); });
+  }
+
+  ~FuelTotalizer() { prefs_.end(); }
+
+  // --------------------------------------------------------------------------
+  // Inputs: raw fuel rate (L/h) and SOG (m/s), latched with a hold
+  // --------------------------------------------------------------------------
+  void set(const float& fuel_lph) override {
+    if (std::isnan(fuel_lph)) return;
+    fuel_lph_    = fuel_lph;
+    fuel_ts_ms_  = millis();
+  }
+
+  void set_sog(float sog_ms) {
+    if (std::isnan(sog_ms)) return;
+    sog_ms_    = sog_ms;
+    sog_ts_ms_ = millis();
+  }
+
+  const FuelIntegrator& integrator() const { return integ_; }
+
+  // --------------------------------------------------------------------------
+  // SensESP configuration persistence
+  // --------------------------------------------------------------------------
+  bool to_json(JsonObject& json) override {
+    json["total_l"]    = integ_.total_ml() / 1000.0f;
+    json["reset_trip"] = false;
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    bool changed = false;
+    if (json["total_l"].is<float>()) {
+      const float l = json["total_l"].as<float>();
+      const uint32_t ml = (l > 0.0f) ? static_cast<uint32_t>(lroundf(l * 1000.0f)) : 0;
+      if (ml != integ_.total_ml()) {
+        integ_.set_counters(ml, integ_.trip_ml(), integ_.trip_m());
+        changed = true;
+      }
+    }
+    if (json["reset_trip"].is<bool>() && json["reset_trip"].as<bool>()) {
+      integ_.reset_trip();
+      changed = true;
+    }
+    if (changed) save_counters();
+    return true;
+  }
+
+ private:
+  static constexpr uint32_t TICK_INTERVAL_MS       = 1000;    // 1 Hz
+  static constexpr uint32_t INPUT_HOLD_MS          = 4000;
+  static constexpr uint32_t SAVE_INTERVAL_MS       = 10000;   // journal append
+  static constexpr uint32_t PREFS_SAVE_INTERVAL_MS = 60000;   // NVS fallback
+
+  enum Counter { TOTAL_ML = 0, TRIP_ML, TRIP_M, NUM_COUNTERS };
+
+  FuelIntegrator integ_;
+
+  float    fuel_lph_   = 0.0f;
+  uint32_t fuel_ts_ms_ = 0;
+  float    sog_ms_     = NAN;
+  uint32_t sog_ts_ms_  = 0;
+
+  uint32_t last_tick_ms_ = 0;
+  uint32_t last_save_ms_ = 0;
+
+  Preferences            prefs_;
+  PartitionJournalFlash* flash_ = nullptr;
+  JournalFlashSlice*     slices_[NUM_COUNTERS]   = {};
+  HoursJournal*          journals_[NUM_COUNTERS] = {};
+  uint32_t               saved_[NUM_COUNTERS]    = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+
+  ValueConsumer<float>* sk_trip_     = nullptr;
+  ValueConsumer<float>* sk_total_    = nullptr;
+  ValueConsumer<float>* sk_rate_     = nullptr;
+  ValueConsumer<float>* sk_economy_  = nullptr;
+  ValueConsumer<float>* sk_trip_eco_ = nullptr;
+
+  StatusPageItem<float>* ui_trip_     = nullptr;
+  StatusPageItem<float>* ui_trip_nm_  = nullptr;
+  StatusPageItem<float>* ui_trip_eco_ = nullptr;
+  StatusPageItem<float>* ui_rate_     = nullptr;
+  StatusPageItem<float>* ui_economy_  = nullptr;
+  StatusPageItem<float>* ui_total_    = nullptr;
+
+  static ValueConsumer<float>* output(const String& path) {
+    return batched(g_sk_batcher, new SKOutputFloat(path), 1000);
+  }
+
+  void tick() {
+    const uint32_t now = millis();
+
+    // First tick establishes the timebase only
+    if (last_tick_ms_ == 0) {
+      last_tick_ms_ = now;
+      last_save_ms_ = now;
+      return;
+    }
+
+    const float lph = (fuel_ts_ms_ != 0 && now - fuel_ts_ms_ <= INPUT_HOLD_MS)
+                          ? fuel_lph_ : 0.0f;
+    const float sog = (sog_ts_ms_ != 0 && now - sog_ts_ms_ <= INPUT_HOLD_MS)
+                          ? sog_ms_ : NAN;
+
+    integ_.tick(now - last_tick_ms_, lph, sog);
+    last_tick_ms_ = now;
+
+    publish();
+
+    const uint32_t interval = flash_ ? SAVE_INTERVAL_MS : PREFS_SAVE_INTERVAL_MS;
+    if (now - last_save_ms_ >= interval) {
+      save_counters();
+      last_save_ms_ = now;
+    }
+  }
+
+  void publish() {
+    const float trip_l  = integ_.trip_ml() / 1000.0f;
+    const float total_l = integ_.total_ml() / 1000.0f;
+    const float rate    = integ_.rolling_lph();
+    const float eco     = integ_.rolling_l_per_nm();
+    const float trip_eco = integ_.trip_l_per_nm();
+
+    // L → m³, L/nm → m³/m
+    constexpr float L_PER_NM_TO_M3_PER_M =
+        1.0f / 1000.0f / FuelIntegrator::METERS_PER_NM;
+
+    emit(total_l);
+
+    sk_trip_->set(trip_l / 1000.0f);
+    sk_total_->set(total_l / 1000.0f);
+    sk_rate_->set(std::isnan(rate) ? NAN : rate / 1000.0f / 3600.0f);
+    sk_economy_->set(eco * L_PER_NM_TO_M3_PER_M);
+    sk_trip_eco_->set(trip_eco * L_PER_NM_TO_M3_PER_M);
+
+    ui_trip_->set(trip_l);
+    ui_trip_nm_->set(integ_.trip_m() / FuelIntegrator::METERS_PER_NM);
+    ui_trip_eco_->set(trip_eco);
+    ui_rate_->set(rate);
+    ui_economy_->set(eco);
+    ui_total_->set(total_l);
+  }
+
+  // --------------------------------------------------------------------------
+  // Persistence helpers
+  // --------------------------------------------------------------------------
+  // The partition holds one engine's journals
+  void open_journals(bool use_partition) {
+    if (!use_partition) return;
+
+    flash_ = PartitionJournalFlash::open(FUEL_TOTAL_PARTITION);
+    if (!flash_) {
+      ESP_LOGW("FuelTotal", "No '%s' partition, using NVS", FUEL_TOTAL_PARTITION);
+      return;
+    }
+
+    // Lifetime counter gets half the partition, trip counters a quarter each
+    const size_t quarter =
+        flash_->size() / 4 / JournalFlash::SECTOR_BYTES * JournalFlash::SECTOR_BYTES;
+    const size_t offsets[NUM_COUNTERS] = {0, 2 * quarter, 3 * quarter};
+    const size_t sizes[NUM_COUNTERS]   = {2 * quarter, quarter, quarter};
+
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+      slices_[c]   = new JournalFlashSlice(flash_, offsets[c], sizes[c]);
+      journals_[c] = new HoursJournal(slices_[c]);
+    }
+  }
+
+  void load_counters() {
+    static const char* const KEYS[NUM_COUNTERS] = {"total_ml", "trip_ml", "trip_m"};
+    uint32_t v[NUM_COUNTERS] = {0, 0, 0};
+    bool from_journal = false;
+
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+      if (journals_[c] && journals_[c]->begin() && journals_[c]->has_record()) {
+        v[c] = journals_[c]->seconds();   // generic u32 counter
+        from_journal = true;
+      }
+    }
+
+    if (!from_journal) {
+      for (int c = 0; c < NUM_COUNTERS; c++) v[c] = prefs_.getUInt(KEYS[c], 0);
+    }
+
+    integ_.set_counters(v[TOTAL_ML], v[TRIP_ML], v[TRIP_M]);
+
+    if (from_journal || !flash_) {
+      for (int c = 0; c < NUM_COUNTERS; c++) saved_[c] = v[c];
+    } else {
+      save_counters();   // first boot with the partition: seed from NVS
+    }
+
+    ESP_LOGI("FuelTotal", "Lifetime %.1f L, trip %.1f L / %.1f nm",
+             v[TOTAL_ML] / 1000.0f, v[TRIP_ML] / 1000.0f,
+             v[TRIP_M] / FuelIntegrator::METERS_PER_NM);
+  }
+
+  // Only changed counters — an idle engine never writes flash
+  void save_counters() {
+    static const char* const KEYS[NUM_COUNTERS] = {"total_ml", "trip_ml", "trip_m"};
+    const uint32_t v[NUM_COUNTERS] = {
+      integ_.total_ml(), integ_.trip_ml(), integ_.trip_m()
+    };
+
+    for (int c = 0; c < NUM_COUNTERS; c++) {
+      if (v[c] == saved_[c]) continue;
+      const bool ok = flash_ ? journals_[c]->append(v[c])
+                             : prefs_.putUInt(KEYS[c], v[c]) > 0;
+      if (ok) saved_[c] = v[c];
+    }
+  }
+};
+
+// --------------------------------------------------------------------------
+// SensESP configuration schema (required)
+// --------------------------------------------------------------------------
+inline String ConfigSchema(const FuelTotalizer&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "total_l": {
+        "title": "Lifetime Fuel Used",
+        "type": "number",
+        "description": "Fuel used since install (liters; integrated on the device)"
+      },
+      "reset_trip": {
+        "title": "Reset Trip",
+        "type": "boolean",
+        "description": "Tick and save to zero the trip fuel, distance and economy"
+      }
+    }
+  })JSON";
+}
+
+// ============================================================================
+// SETUP — FUEL TOTALIZER
+// ============================================================================
+inline FuelTotalizer* setup_fuel_totalizer(EngineInstance&       e,
+                                           ValueProducer<float>* fuel_lph_raw,
+                                           VesselStateListener*  vessel) {
+  if (!fuel_lph_raw) return nullptr;
+
+  auto* totalizer = new FuelTotalizer(
+      e, e.config_path("/config/engine_fuel/totalizer"));
+  fuel_lph_raw->connect_to(totalizer);
+
+  if (vessel) {
+    vessel->connect_to(new LambdaConsumer<VesselState>(
+      [totalizer](const VesselState& s) {
+        if (s.is_fresh(VESSEL_SOG)) totalizer->set_sog(s.value[VESSEL_SOG]);
+      }
+    ));
+  }
+
+  ConfigItem(totalizer)
+      ->set_title(e.ui_title("Fuel Totalizer"))
+      ->set_description("Lifetime / trip fuel used and economy (reset trip here)");
+
+  return totalizer;
+}
+
+}  // namespace sensesp
+
+#endif  // ARDUINO
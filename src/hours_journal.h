@@ -0,0 +1,210 @@
+#pragma once
+
+// ============================================================================
+// HoursJournal — append-only, power-fail-safe counter log in raw flash
+// ============================================================================
+//
+// • Fixed 16-byte records { magic, sequence, seconds, crc32 } appended to a
+//   ring of 4 KB sectors — no key rewrite, no NVS page compaction
+// • A sector is erased only when the write position enters it
+//   (≥ 2 sectors: the newest record always survives the erase)
+// • Boot: scan all slots, newest valid (magic + CRC) sequence wins; a torn
+//   write fails its CRC and is skipped, never patched in place
+// • Integer seconds: no float precision loss at high hours
+// • Storage is abstract (JournalFlash) — partition backend in
+//   journal_partition.h, RAM backend in the unit tests
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "crc32.h"
+
+// ============================================================================
+// Flash backend interface
+// ============================================================================
+class JournalFlash {
+ public:
+  static constexpr size_t SECTOR_BYTES = 4096;
+
+  virtual ~JournalFlash() {}
+
+  virtual size_t size() const = 0;                         // bytes
+  virtual bool read(size_t offset, void* dst, size_t len) = 0;
+  virtual bool write(size_t offset, const void* src, size_t len) = 0;
+  virtual bool erase_sector(size_t offset) = 0;           // sector aligned
+};
+
+// ============================================================================
+// Sector-aligned window of another JournalFlash (several journals sharing
+// one partition, e.g. the fuel totalizer counters)
+// ============================================================================
+class JournalFlashSlice : public JournalFlash {
+ public:
+  JournalFlashSlice(JournalFlash* base, size_t offset, size_t size)
+      : base_(base), offset_(offset), size_(0) {
+    if (base_ && offset_ % SECTOR_BYTES == 0 && offset_ < base_->size()) {
+      const size_t avail = base_->size() - offset_;
+      size_ = ((size < avail) ? size : avail) / SECTOR_BYTES * SECTOR_BYTES;
+    }
+  }
+
+  size_t size() const override { return size_; }
+
+  bool read(size_t offset, void* dst, size_t len) override {
+    return in_range(offset, len) && base_->read(offset_ + offset, dst, len);
+  }
+
+  bool write(size_t offset, const void* src, size_t len) override {
+    return in_range(offset, len) && base_->write(offset_ + offset, src, len);
+  }
+
+  bool erase_sector(size_t offset) override {
+    return in_range(offset, SECTOR_BYTES) &&
+           base_->erase_sector(offset_ + offset);
+  }
+
+ private:
+  JournalFlash* base_;
+  size_t        offset_;
+  size_t        size_;
+
+  bool in_range(size_t offset, size_t len) const {
+    return offset <= size_ && len <= size_ - offset;
+  }
+};
+
+// ============================================================================
+// Journal
+// ============================================================================
+class HoursJournal {
+ public:
+  struct Record {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t seconds;
+    uint32_t crc;
+  };
+
+  static constexpr uint32_t MAGIC        = 0x48524A31;   // "HRJ1"
+  static constexpr size_t   RECORD_BYTES = sizeof(Record);
+
+  static_assert(sizeof(Record) == 16, "journal record must be 16 bytes");
+  static_assert(JournalFlash::SECTOR_BYTES % sizeof(Record) == 0,
+                "records must tile a sector");
+
+  explicit HoursJournal(JournalFlash* flash) : flash_(flash) {}
+
+  // -------------------------------------------------------------------------
+  // Recover the newest record and the next write position
+  // -------------------------------------------------------------------------
+  bool begin() {
+    found_ = false;
+    if (!usable()) {
+      return false;
+    }
+
+    size_t newest_offset = 0;
+    Record r;
+
+    for (size_t off = 0; off < flash_->size(); off += RECORD_BYTES) {
+      if (!flash_->read(off, &r, sizeof(r)) || !valid(r)) {
+        continue;
+      }
+      if (!found_ || r.sequence > sequence_) {
+        found_         = true;
+        sequence_      = r.sequence;
+        seconds_       = r.seconds;
+        newest_offset  = off;
+      }
+    }
+
+    write_offset_ = found_ ? next_erased(newest_offset + RECORD_BYTES) : 0;
+    return true;
+  }
+
+  // -------------------------------------------------------------------------
+  // Append one record (one 16-byte program, plus a sector erase every
+  // 256 records)
+  // -------------------------------------------------------------------------
+  bool append(uint32_t seconds) {
+    if (!usable()) {
+      return false;
+    }
+
+    if (write_offset_ % JournalFlash::SECTOR_BYTES == 0 &&
+        !flash_->erase_sector(write_offset_)) {
+      return false;
+    }
+
+    Record r;
+    r.magic    = MAGIC;
+    r.sequence = found_ ? sequence_ + 1 : 1;
+    r.seconds  = seconds;
+    r.crc      = crc_of(r);
+
+    const bool ok = flash_->write(write_offset_, &r, sizeof(r));
+
+    // Never reuse a slot: a failed/torn program is skipped
+    write_offset_ = wrap(write_offset_ + RECORD_BYTES);
+
+    if (ok) {
+      found_    = true;
+      sequence_ = r.sequence;
+      seconds_  = seconds;
+    }
+    return ok;
+  }
+
+  bool     has_record() const { return found_; }
+  uint32_t seconds() const    { return seconds_; }
+  uint32_t sequence() const   { return sequence_; }
+  size_t   write_offset() const { return write_offset_; }
+
+ private:
+  JournalFlash* flash_;
+  bool     found_        = false;
+  uint32_t sequence_     = 0;
+  uint32_t seconds_      = 0;
+  size_t   write_offset_ = 0;
+
+  bool usable() const {
+    return flash_ &&
+           flash_->size() >= 2 * JournalFlash::SECTOR_BYTES &&
+           flash_->size() % JournalFlash::SECTOR_BYTES == 0;
+  }
+
+  size_t wrap(size_t offset) const {
+    return (offset >= flash_->size()) ? 0 : offset;
+  }
+
+  static uint32_t crc_of(const Record& r) {
+    return crc32_ieee(&r, offsetof(Record, crc));
+  }
+
+  static bool valid(const Record& r) {
+    return r.magic == MAGIC && r.crc == crc_of(r);
+  }
+
+  // First erased slot at/after offset within its sector, else next sector
+  size_t next_erased(size_t offset) {
+    offset = wrap(offset);
+
+    while (offset % JournalFlash::SECTOR_BYTES != 0) {
+      uint8_t bytes[RECORD_BYTES];
+      if (flash_->read(offset, bytes, sizeof(bytes)) && erased(bytes)) {
+        return offset;
+      }
+      offset = wrap(offset + RECORD_BYTES);
+    }
+    return offset;   // sector start → erased on the next append
+  }
+
+  static bool erased(const uint8_t* bytes) {
+    for (size_t i = 0; i < RECORD_BYTES; i++) {
+      if (bytes[i] != 0xFF) return false;
+    }
+    return true;
+  }
+};
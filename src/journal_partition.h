@@ -0,0 +1,46 @@
+#pragma once
+
+// ============================================================================
+// PartitionJournalFlash — JournalFlash on a raw data partition
+// ============================================================================
+//
+// • Partition looked up by label (partitions_*.csv: "hours", data, 0x40)
+// • Tables flashed before the journal existed have no such partition:
+//   open() returns nullptr and callers fall back to Preferences
+//   (the partition table is not updated by OTA — flash once over USB)
+// ============================================================================
+
+#include <esp_partition.h>
+
+#include "hours_journal.h"
+
+class PartitionJournalFlash : public JournalFlash {
+ public:
+  static PartitionJournalFlash* open(const char* label) {
+    const esp_partition_t* p = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return p ? new PartitionJournalFlash(p) : nullptr;
+  }
+
+  size_t size() const override {
+    return partition_->size - (partition_->size % SECTOR_BYTES);
+  }
+
+  bool read(size_t offset, void* dst, size_t len) override {
+    return esp_partition_read(partition_, offset, dst, len) == ESP_OK;
+  }
+
+  bool write(size_t offset, const void* src, size_t len) override {
+    return esp_partition_write(partition_, offset, src, len) == ESP_OK;
+  }
+
+  bool erase_sector(size_t offset) override {
+    return esp_partition_erase_range(partition_, offset, SECTOR_BYTES) ==
+           ESP_OK;
+  }
+
+ private:
+  explicit PartitionJournalFlash(const esp_partition_t* p) : partition_(p) {}
+
+  const esp_partition_t* partition_;
+};
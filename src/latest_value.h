@@ -0,0 +1,45 @@
+#pragma once
+
+// ============================================================================
+// LatestValue — sink holding the most recent sample and its age
+// ============================================================================
+//
+// • For periodic consumers (bus output, logging) that sample the graph at
+//   their own rate instead of reacting to every emit
+// • get() returns NaN once the value is older than stale_ms
+//   (producer stopped, sensor unplugged) or was never set
+// ============================================================================
+
+#include <Arduino.h>
+#include <cmath>
+
+#include <sensesp/system/valueconsumer.h>
+
+using namespace sensesp;
+
+class LatestValue : public ValueConsumer<float> {
+ public:
+  static constexpr uint32_t DEFAULT_STALE_MS = 5000;
+
+  explicit LatestValue(uint32_t stale_ms = DEFAULT_STALE_MS)
+      : stale_ms_(stale_ms) {}
+
+  void set(const float& value) override {
+    value_      = value;
+    updated_ms_ = millis();
+    seen_       = true;
+  }
+
+  float get(uint32_t now_ms) const {
+    if (!seen_ || (now_ms - updated_ms_) > stale_ms_) {
+      return NAN;
+    }
+    return value_;
+  }
+
+ private:
+  uint32_t stale_ms_;
+  float    value_      = NAN;
+  uint32_t updated_ms_ = 0;
+  bool     seen_       = false;
+};
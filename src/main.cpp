@@ -10,6 +10,12 @@
 //  - Oil pressure, for american sender resistance (via boat's oil pressure sender, requires gauge to be fitted and working)
 //  - Engine hours accumulator, resetable via UI
 //  - SK debug output
+//  - Optional direct NMEA 2000 output (PGN 127488 / 127489 via TWAI)
+//  - On-device engine data logger with HTTP download (16MB partition table)
+//  - One or two engines per board (ENGINES[], propulsion.<id>.*)
+//  - Staged boot: RPM / oil / coolant first, the rest once the network is up
+//  - Engine-off power profile: slow keep-alives, modem/light sleep (ENABLE_POWER_SAVE)
+//  - Bench simulator: sweep / stress / log replay on the RPM + sender inputs (ENGINE_SIMULATOR)
 //  - OTA update
 //  - Full UI configuration for SK paths and calibration, setting wifi and SK server address
 // values sent to SignalK IAW https://signalk.org/specification/1.5.0/doc/vesselsBranch.html (note: minor errrors
@@ -22,7 +28,6 @@
 // SensESP core
 #include "sensesp_app_builder.h"
 #include "sensesp/signalk/signalk_output.h"
-#include "sensesp/signalk/signalk_value_listener.h"
 
 // Config UI elements
 #include "sensesp/ui/config_item.h"
@@ -41,33 +46,37 @@
 // Custom function
 //#include "sender_resistance.h"  // not in use
 #include "engine_hours.h"
+#include "acquisition_task.h"
+#include "adc_scan_engine.h"
+#include "sk_output_batcher.h"
+#include "n2k_engine_output.h"
+#include "data_logger.h"
+#include "sk_replay.h"
+#include "pipeline_profiler.h"
+#include "system_diagnostics.h"
+#include "boot_stage.h"
+#include "engine_instance.h"
+#include "power_profile.h"
 #include "calibrated_analog_input.h"
+#include "vessel_state_listener.h"
 #include "engine_fuel.h"
+#include "engine_load.h"
 #include "onewire_sensors.h"
 #include "coolant_temp.h"
 #include "rpm_sensor.h"
 #include "oil_pressure.h"
 
-// Simulator/test options
-#ifdef RPM_SIMULATOR
-#include "rpm_simulator.h"
-#endif
-
-#if COOLANT_SIMULATOR
-#include "coolant_simulator.h"
-#endif
-
-#if (RPM_SIMULATOR && COOLANT_SIMULATOR)
-#error "Enable only one simulator at a time (both want GPIO26)."
+// Bench simulator (tooth pulses + coolant / oil senders, -DENGINE_SIMULATOR=1)
+#if ENGINE_SIMULATOR
+#include "engine_simulator.h"
 #endif
 
 using namespace sensesp;
-using namespace sensesp::onewire;
 
 // -----------------------------------------------
 // FORWARD DECLARATIONS
 // -----------------------------------------------
-void setup_engine_hours();
+void setup_engine_hours(EngineInstance& e);
 
 // -----------------------------------------------
 // PIN DEFINITIONS — FIREBEETLE ESP32-E   EDIT THESE IF REQUIRE FOR YOUR BOARD
@@ -81,16 +90,70 @@ const uint8_t PIN_RPM              = 25;  // magnetic pickup for RPM (digital in
 
 const uint8_t PIN_ADC_OIL_PRESSURE = 36;  // choose free ADC pin
 
-// OneWire sensor read delay (ms)
+// NMEA 2000 transceiver (only used with ENABLE_N2K_OUTPUT)
+const uint8_t PIN_CAN_TX           = 22;
+const uint8_t PIN_CAN_RX           = 21;
+
+// OneWire delay between conversion cycles (ms, after the conversion time)
 const uint32_t ONEWIRE_READ_DELAY_MS = 500;
 
 // RPM sensor configuration (flywheel tooth count)
 const float RPM_TEETH = 116.0f;
 
-// RPM signal globals (defined here, used in rpm_sensor.h)
-Frequency* g_frequency = nullptr;
-ValueProducer<float>* g_engine_rev_s_smooth = nullptr;
-ValueProducer<float>* g_engine_rad_s = nullptr;
+// -----------------------------------------------
+// ENGINES ON THIS BOARD — one row per engine (max MAX_ENGINES)
+//   id "engine" keeps the single-engine Signal K paths; twin installs use
+//   e.g. "port" / "starboard" (propulsion.<id>.*). Row 0 keeps the existing
+//   calibration, hours and fuel totals. ADC pins must be ADC1 (GPIO32–39).
+// -----------------------------------------------
+const EngineConfig ENGINES[] = {
+  // id        N2K instance  RPM pickup  coolant ADC      oil ADC               teeth
+  { "engine",  0,            PIN_RPM,    PIN_ADC_COOLANT, PIN_ADC_OIL_PRESSURE, RPM_TEETH },
+  // { "starboard", 1,       16,         34,              35,                   RPM_TEETH },
+};
+
+const size_t NUM_ENGINES = sizeof(ENGINES) / sizeof(ENGINES[0]);
+
+static_assert(NUM_ENGINES >= 1 && NUM_ENGINES <= MAX_ENGINES,
+              "ENGINES[] must list 1..MAX_ENGINES engines");
+static_assert(SetupAllocTracker::MAX_SETUP_ENGINES >= MAX_ENGINES &&
+              SetupAllocTracker::MAX_BOOT_STEPS >= DeferredBootQueue::MAX_STEPS,
+              "setup allocation table smaller than setup()");
+
+// Engine pipelines and their signals (rev/s, load), ENGINES[] order
+EngineInstance* g_engines[MAX_ENGINES] = {};
+
+// ADC1 continuous DMA scan (coolant + oil pressure channels)
+AdcScanEngine* g_adc_scan = nullptr;
+
+// Core-1 sampling task (RPM, ADC scan, OneWire harvest) → SPSC → event loop
+AcquisitionTask* g_acquisition = nullptr;
+
+// 5 Hz rate-limited / deadbanded Signal K emission
+SkOutputBatcher* g_sk_batcher = nullptr;
+
+// Direct NMEA 2000 engine PGNs (nullptr unless ENABLE_N2K_OUTPUT)
+N2kEngineOutput* g_n2k = nullptr;
+
+// On-device engine data ring log ("datalog" partition, /api/datalog)
+DataLogger* g_datalog = nullptr;
+
+// Replays the log over Signal K after a websocket outage
+SkReplay* g_sk_replay = nullptr;
+
+// Running / engine-off sample-rate profile (nullptr unless ENABLE_POWER_SAVE)
+PowerManager* g_power = nullptr;
+
+// Heap / stack watermarks → debug.system.*, setup allocations per stage
+SystemDiagnostics* g_diag = nullptr;
+
+// Deferred (post-network) construction of the non-critical pipelines
+BootStager* g_boot = nullptr;
+
+#if ENABLE_PIPELINE_PROFILER
+// Per-stage cycle counts / onRepeat jitter → debug.perf.* every 10 s
+PipelineProfiler* g_profiler = nullptr;
+#endif
 
 // ---------------------------------------------------------------------------
 // NOTE:
@@ -104,25 +167,18 @@ const float OIL_PULLUP_RESISTOR = 220.0f;   // Resistance (ohm) in mid-range of
 // -----------------------------------------------
 // CONSTANTS
 // -----------------------------------------------
-const float ADC_SAMPLE_RATE_HZ = 1.0f;   // sample rate for coolant temp and oil pressure ADC pins (Hz)
+const float ADC_SAMPLE_RATE_HZ = 2.0f;   // coolant temp output rate (Hz), oversampled by the DMA scan
 
 // ============================================================================
 // SETUP
 // ============================================================================
 void setup() {
 
-#ifdef RPM_SIMULATOR
-  Serial.println("RPM SIMULATOR ACTIVE");
-  setupRPMSimulator();
-#endif
-
-#if COOLANT_SIMULATOR
-  Serial.println("COOLANT SIMULATOR ACTIVE");
-  setupCoolantSimulator();
-#endif
-
   SetupLogging();
 
+  // Heap baseline before anything is built
+  g_diag = new SystemDiagnostics();
+
   SensESPAppBuilder builder;
 
   builder.set_hostname("esp32-yanmar")
@@ -131,53 +187,161 @@ void setup() {
       ->set_sk_server("192.168.88.99", 3000);
 
   sensesp_app = builder.get_app();
+  g_diag->mark_setup("app");
+
+#if ENABLE_PIPELINE_PROFILER
+  // Stages register as the pipelines are built
+  g_profiler = new PipelineProfiler();
+#endif
 
   // setup engine performance inputs (from NMEA2000--> signalK --> sensesp)
-  auto* stw = new SKValueListener<float>(
-      "navigation.speedThroughWater",
-      1000,
-      "/config/inputs/stw"
-  );
+  // STW / SOG / AWS / AWA: one owner, coalesced + decimated to 1 Hz
+  auto* vessel = new VesselStateListener(1000);
 
-  auto* sog = new SKValueListener<float>(
-      "navigation.speedOverGround",
-      1000,
-      "/config/inputs/sog"
-  );
+  // Outputs register with the batcher as the sensors are set up
+  g_sk_batcher = new SkOutputBatcher();
 
-  auto* aws = new SKValueListener<float>(
-      "environment.wind.speedApparent",
-      1000,
-      "/config/inputs/aws"
-  );
+#if ENABLE_N2K_OUTPUT
+  // Field sinks are connected as the sensors are set up
+  g_n2k = new N2kEngineOutput(PIN_CAN_TX, PIN_CAN_RX);
+#endif
 
-  auto* awa = new SKValueListener<float>(
-      "environment.wind.angleApparent",
-      1000,
-      "/config/inputs/awa"
-  );
+  // Channel sinks are connected as the sensors are set up
+  g_datalog = new DataLogger("/config/datalog");
+
+  ConfigItem(g_datalog)
+      ->set_title("Engine Data Logger")
+      ->set_description(
+          "Records engine data to flash; download from /api/datalog");
 
-  // Call setup functions for sensors
-  setup_temperature_sensors();
-  setup_coolant_sender();
-  setup_rpm_sensor();
+  // Outputs bind their paths as the sensors are set up
+  g_sk_replay = new SkReplay(g_datalog);
+  g_diag->mark_setup("inputs+outputs");
+
+  // Sources register with the acquisition task before it starts
+  g_acquisition = new AcquisitionTask();
+
+  // All ADC1 senders register on the DMA scan before it starts
+  g_adc_scan = new AdcScanEngine();
+  g_diag->mark_setup("acq+adc_scan");
+
+#if ENABLE_POWER_SAVE
+  // Before the sensors: they register their profile listeners
+  g_power = new PowerManager();
+  g_power->on_change([](PowerProfile p) {
+    g_adc_scan->set_burst_period(
+        (p == POWER_ENGINE_OFF) ? ENGINE_OFF_ADC_BURST_PERIOD_MS : 0);
+  });
+#endif
+
+  // Steps queued below run from the event loop once WiFi is up
+  g_boot = new BootStager();
 
   // -------------------------------------------------------------------------
-  // Oil pressure sender (0.5–4.5V transducer → ADC → Signal K)
+  // Fast stage: publishes right after a reset (brownout during crank)
+  // Every engine's ADC1 channels register before the DMA scan starts
   // -------------------------------------------------------------------------
-  setup_oil_pressure_sensor(PIN_ADC_OIL_PRESSURE);
+  for (size_t i = 0; i < NUM_ENGINES; i++) {
+    auto* engine = new EngineInstance(ENGINES[i], static_cast<uint8_t>(i));
+    g_engines[i] = engine;
+
+    setup_rpm_sensor(*engine);
+    g_diag->mark_setup("rpm");
+
+    if (g_power && engine->rev_s_smooth) {
+      g_power->add_wake_pin(ENGINES[i].pin_rpm);
+      engine->rev_s_smooth->connect_to(g_power);
+    }
+
+    // -----------------------------------------------------------------------
+    // Oil pressure sender (0.5–4.5V transducer → ADC → Signal K)
+    // -----------------------------------------------------------------------
+    setup_oil_pressure_sensor(*engine);
+    g_diag->mark_setup("oil");
+
+    setup_coolant_sender(*engine);
+    g_diag->mark_setup("coolant");
+  }
 
-  setup_engine_hours();
+  g_adc_scan->start(g_acquisition);
+  g_diag->mark_setup("adc_scan start");
 
-  setup_engine_fuel(
-      g_engine_rev_s_smooth,  // stable revs
-      stw,
-      sog,
-      aws,
-      awa
-  );
+  for (size_t i = 0; i < NUM_ENGINES; i++) {
+    setup_engine_hours(*g_engines[i]);
+    g_diag->mark_setup("hours");
+  }
+
+  g_acquisition->start();
+  g_diag->mark_setup("acq start");
+
+  if (g_n2k) {
+    g_n2k->start();
+    g_diag->mark_setup("n2k");
+  }
+
+  g_datalog->start();
+  g_diag->mark_setup("datalog");
+
+  if (g_power) {
+    g_power->start();
+    g_diag->mark_setup("power");
+  }
+
+#if ENGINE_SIMULATOR
+  // Bench only: drives engine 0's RPM pickup and sender inputs
+  auto* simulator =
+      new EngineSimulator(g_engines[0], g_datalog, "/config/simulator");
+
+  ConfigItem(simulator)
+      ->set_title("Engine Simulator")
+      ->set_description(
+          "Bench test profile on GPIO27 (teeth), GPIO26 (coolant), "
+          "GPIO13 (oil); applied immediately");
+
+  simulator->start();
+  g_diag->mark_setup("simulator");
+#endif
+
+  // -------------------------------------------------------------------------
+  // Deferred stage (event loop, one step at a time)
+  // -------------------------------------------------------------------------
+  // OneWire discovery joins the running acquisition task (exhaust elbow:
+  // engine 0)
+  g_boot->defer("onewire", []() { setup_temperature_sensors(*g_engines[0]); });
+
+  for (size_t i = 0; i < NUM_ENGINES; i++) {
+    EngineInstance* engine = g_engines[i];
+    g_boot->defer("fuel+load", [engine, vessel]() {
+      auto* engine_model = setup_engine_fuel(*engine, vessel);
+      setup_engine_load(*engine, engine_model);
+    });
+  }
+
+  // After every output it replays is bound
+  g_boot->defer("replay", []() {
+    g_sk_replay->start();
+    if (!g_sk_replay->active()) return;
+
+    // Replayed outputs: SensESP's queue would resend the outage as "now"
+    for (size_t c = 0; c < REPLAY_NUM_CHANNELS; c++) {
+      SKOutputFloat* out =
+          g_sk_replay->output(static_cast<SkReplayChannel>(c));
+      if (out && !g_sk_batcher->set_replayed(out)) {
+        ESP_LOGW("SkReplay", "%s not batched, may be sent twice",
+                 out->get_sk_path().c_str());
+      }
+    }
+  });
+
+#if ENABLE_PIPELINE_PROFILER
+  g_boot->defer("profiler", []() { g_profiler->start(); });
+#endif
+
+  // Logs the setup table; its own outputs are not part of it
+  g_boot->defer("diag", []() { g_diag->start(); });
 
   sensesp_app->start();
+  g_boot->start();
 }
 
 // ============================================================================
@@ -185,22 +349,24 @@ void setup() {
 // ============================================================================
 #include "sensesp/transforms/linear.h"
 
-void setup_engine_hours() {
+void setup_engine_hours(EngineInstance& e) {
 
-  auto* hours = new EngineHours("/config/sensors/engine_hours");
+  auto* hours = new EngineHours(
+      e, e.config_path("/config/sensors/engine_hours"));
 
   auto* hours_to_seconds = hours->connect_to(
-      new Linear(3600.0f, 0.0f, "/config/sensors/engine_hours_to_seconds")
+      new Linear(3600.0f, 0.0f,
+                 e.config_path("/config/sensors/engine_hours_to_seconds"))
   );
 
   auto* sk_hours = new SKOutputFloat(
-      "propulsion.engine.runTime",
-      "/config/outputs/sk/engine_hours"
+      e.sk_path("runTime"),
+      e.config_path("/config/outputs/sk/engine_hours")
   );
 
-  if (g_engine_rev_s_smooth != nullptr) {
+  if (e.rev_s_smooth != nullptr) {
 
-    auto* revs_to_rpm = g_engine_rev_s_smooth->connect_to(
+    auto* revs_to_rpm = e.rev_s_smooth->connect_to(
         new LambdaTransform<float,float>([](float rps) {
           return std::isnan(rps) ? NAN : (rps * 60.0f);
         })
@@ -214,12 +380,17 @@ void setup_engine_hours() {
 
   // hours_to_seconds->connect_to(sk_hours);
 
+  // Direct NMEA 2000 PGN 127489 (hours → seconds in the encoder)
+  if (e.n2k) {
+    hours->connect_to(e.n2k->engine_hours());
+  }
+
   ConfigItem(hours)
-      ->set_title("Engine Hours Accumulator")
+      ->set_title(e.ui_title("Engine Hours Accumulator"))
       ->set_description("Tracks total engine run time in hours");
 
   ConfigItem(sk_hours)
-      ->set_title("Engine Run Time SK Path")
+      ->set_title(e.ui_title("Engine Run Time SK Path"))
       ->set_description("Signal K path for engine runtime (seconds)");
 }
 
@@ -228,23 +399,14 @@ void setup_engine_hours() {
 // ============================================================================
 void loop() {
 
-#ifdef RPM_SIMULATOR
-  static uint32_t last_debug = 0;
-  if (millis() - last_debug > 200) {
-    Serial.printf("Pulses: %u\n", pulse_count);
-    last_debug = millis();
+  {
+    PerfScope perf(perf_loop_stage());   // whole event-loop tick
+    sensesp_app->get_event_loop()->tick();
   }
-#endif
-
-  sensesp_app->get_event_loop()->tick();
 
-#ifdef RPM_SIMULATOR
-  loopRPMSimulator();
-#endif
-
-#if COOLANT_SIMULATOR
-  loopCoolantSimulator();
-#endif
+  if (g_power) {
+    g_power->idle();
+  }
 }
 
 #endif  // UNIT_TEST
@@ -0,0 +1,280 @@
+#pragma once
+
+// ============================================================================
+// N2kEngineOutput — direct NMEA 2000 engine PGNs over the ESP32 TWAI (CAN)
+// ============================================================================
+//
+// • Bypasses the Signal K round-trip (WiFi → server → gateway) for the
+//   chartplotter: values go on the bus straight from the transform graph
+//     PGN 127488 Rapid Update   every RAPID_INTERVAL_MS   (10 Hz)
+//     PGN 127489 Dynamic        every DYNAMIC_INTERVAL_MS (2 Hz, fast packet)
+// • One field set per engine (add_engine(), engine instance field of both
+//   PGNs) on one address / TWAI driver
+// • Producers connect to the field sinks (same units as Signal K inputs);
+//   a field not updated for 5 s (LatestValue) is sent as "not available"
+// • Minimal ISO 11783-5 address claim: claims PREFERRED_ADDRESS, answers
+//   ISO requests for PGN 60928, moves to the next address when a device
+//   with a lower NAME claims ours
+// • Transmit never blocks the event loop (TX queue full → frame dropped);
+//   bus-off is recovered automatically
+// • Requires a CAN transceiver (e.g. SN65HVD230) on PIN_CAN_TX / PIN_CAN_RX
+// ============================================================================
+
+#include <Arduino.h>
+#include <esp_log.h>
+#include <esp_system.h>
+#include <driver/twai.h>
+
+#include "sensesp_app.h"
+
+#include "latest_value.h"
+#include "n2k_pgn.h"
+
+using namespace sensesp;
+
+class N2kEngineOutput {
+ public:
+  static constexpr uint8_t  PREFERRED_ADDRESS   = 150;
+  static constexpr uint32_t RAPID_INTERVAL_MS   = 100;
+  static constexpr uint32_t DYNAMIC_INTERVAL_MS = 500;
+
+  static constexpr size_t   MAX_ENGINES         = 2;
+
+  // Latest value of one PGN field (NaN after LatestValue::DEFAULT_STALE_MS)
+  using Field = LatestValue;
+
+  // Field sinks of one engine instance (connect producers here)
+  class Engine {
+   public:
+    Field* revolutions() { return &rev_s_; }       // rev/s
+    Field* coolant_temp() { return &coolant_K_; }  // K
+    Field* oil_pressure() { return &oil_Pa_; }     // Pa
+    Field* fuel_rate() { return &fuel_lph_; }      // L/h
+    Field* engine_hours() { return &hours_; }      // h
+    Field* engine_load() { return &load_; }        // 0..1
+
+    uint8_t instance() const { return instance_; }
+
+   private:
+    friend class N2kEngineOutput;
+
+    uint8_t instance_ = 0;
+    Field   rev_s_;
+    Field   coolant_K_;
+    Field   oil_Pa_;
+    Field   fuel_lph_;
+    Field   hours_;
+    Field   load_;
+  };
+
+  // device_instance: NAME field (distinguishes several gateways)
+  N2kEngineOutput(uint8_t tx_pin, uint8_t rx_pin, uint8_t device_instance = 0)
+      : tx_pin_(tx_pin), rx_pin_(rx_pin) {
+    uint8_t mac[6];
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    name_.unique_number =
+        (static_cast<uint32_t>(mac[3]) << 16) | (mac[4] << 8) | mac[5];
+    name_.device_instance = device_instance;
+  }
+
+  // One field set per engine, before start(); nullptr when full
+  Engine* add_engine(uint8_t engine_instance) {
+    if (num_engines_ >= MAX_ENGINES) {
+      ESP_LOGE("N2K", "Engine table full, instance %u not sent",
+               engine_instance);
+      return nullptr;
+    }
+    Engine* e    = &engines_[num_engines_++];
+    e->instance_ = engine_instance;
+    return e;
+  }
+
+  // -------------------------------------------------------------------------
+  // Install the TWAI driver, claim an address, start the PGN timers
+  // -------------------------------------------------------------------------
+  bool start() {
+    twai_general_config_t g = TWAI_GENERAL_CONFIG_DEFAULT(
+        static_cast<gpio_num_t>(tx_pin_),
+        static_cast<gpio_num_t>(rx_pin_),
+        TWAI_MODE_NORMAL);
+    g.tx_queue_len = TX_QUEUE_LEN;
+    g.rx_queue_len = RX_QUEUE_LEN;
+
+    const twai_timing_config_t t = TWAI_TIMING_CONFIG_250KBITS();
+    const twai_filter_config_t f = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+
+    if (twai_driver_install(&g, &t, &f) != ESP_OK ||
+        twai_start() != ESP_OK) {
+      ESP_LOGE("N2K", "TWAI start failed (TX GPIO%d, RX GPIO%d)",
+               tx_pin_, rx_pin_);
+      return false;
+    }
+
+    send_address_claim();
+
+    auto* loop = sensesp_app->get_event_loop();
+    loop->onRepeat(RAPID_INTERVAL_MS, [this]() { this->send_rapid(); });
+    loop->onRepeat(DYNAMIC_INTERVAL_MS, [this]() { this->send_dynamic(); });
+    loop->onRepeat(SERVICE_INTERVAL_MS, [this]() { this->service(); });
+
+    ESP_LOGI("N2K", "NMEA 2000 output on TX GPIO%d / RX GPIO%d, address %u",
+             tx_pin_, rx_pin_, address_);
+    return true;
+  }
+
+  uint8_t address() const { return address_; }
+  uint32_t dropped() const { return dropped_; }
+
+ private:
+  // --------------------------------------------------------------------------
+  // Constants
+  // --------------------------------------------------------------------------
+  static constexpr uint32_t TX_QUEUE_LEN        = 16;
+  static constexpr uint32_t RX_QUEUE_LEN        = 16;
+  static constexpr uint32_t SERVICE_INTERVAL_MS = 50;
+  static constexpr uint8_t  PRIORITY_RAPID      = 2;
+  static constexpr uint8_t  PRIORITY_DYNAMIC    = 2;
+  static constexpr uint8_t  PRIORITY_CLAIM      = 6;
+
+  uint8_t   tx_pin_;
+  uint8_t   rx_pin_;
+  n2k::Name name_;
+  uint8_t   address_    = PREFERRED_ADDRESS;
+  bool      claimed_    = false;
+  uint8_t   fp_seq_     = 0;
+  uint32_t  dropped_    = 0;
+
+  Engine engines_[MAX_ENGINES];
+  size_t num_engines_ = 0;
+
+  // -------------------------------------------------------------------------
+  // Periodic PGNs
+  // -------------------------------------------------------------------------
+  void send_rapid() {
+    if (!claimed_) return;
+
+    const uint32_t now = millis();
+    for (size_t i = 0; i < num_engines_; i++) {
+      const Engine& e = engines_[i];
+
+      uint8_t data[n2k::ENGINE_RAPID_LEN];
+      n2k::encode_engine_rapid(data, e.instance_, e.rev_s_.get(now));
+      send_frame(n2k::can_id(PRIORITY_RAPID, n2k::PGN_ENGINE_RAPID, address_),
+                 data, sizeof(data));
+    }
+  }
+
+  void send_dynamic() {
+    if (!claimed_) return;
+
+    const uint32_t now = millis();
+    const uint32_t id =
+        n2k::can_id(PRIORITY_DYNAMIC, n2k::PGN_ENGINE_DYNAMIC, address_);
+
+    for (size_t e_i = 0; e_i < num_engines_; e_i++) {
+      const Engine& e = engines_[e_i];
+
+      n2k::EngineDynamic d;
+      d.oil_pressure_Pa = e.oil_Pa_.get(now);
+      d.coolant_K       = e.coolant_K_.get(now);
+      d.fuel_rate_lph   = e.fuel_lph_.get(now);
+      d.hours           = e.hours_.get(now);
+      d.load_ratio      = e.load_.get(now);
+
+      uint8_t data[n2k::ENGINE_DYNAMIC_LEN];
+      n2k::encode_engine_dynamic(data, e.instance_, d);
+
+      uint8_t frames[4][8];
+      const size_t n = n2k::fast_packet_encode(frames, 4, fp_seq_++,
+                                               data, sizeof(data));
+
+      for (size_t i = 0; i < n; i++) {
+        if (!send_frame(id, frames[i], 8)) {
+          break;   // partial fast packet is discarded by receivers anyway
+        }
+      }
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Address claim / bus maintenance
+  // -------------------------------------------------------------------------
+  void send_address_claim() {
+    uint8_t data[8];
+    n2k::encode_name(data, name_.value());
+    claimed_ = send_frame(
+        n2k::can_id(PRIORITY_CLAIM, n2k::PGN_ISO_ADDRESS_CLAIM, address_,
+                    n2k::ADDRESS_GLOBAL),
+        data, sizeof(data));
+  }
+
+  void service() {
+    twai_status_info_t status;
+    if (twai_get_status_info(&status) == ESP_OK) {
+      if (status.state == TWAI_STATE_BUS_OFF) {
+        twai_initiate_recovery();
+        claimed_ = false;
+        return;
+      }
+      if (status.state == TWAI_STATE_STOPPED) {
+        twai_start();   // recovery complete
+        send_address_claim();
+        return;
+      }
+    }
+
+    if (!claimed_) {
+      send_address_claim();
+    }
+
+    twai_message_t msg;
+    while (twai_receive(&msg, 0) == ESP_OK) {
+      if (!msg.extd || msg.rtr) continue;
+
+      const uint32_t pgn = n2k::id_pgn(msg.identifier);
+
+      if (pgn == n2k::PGN_ISO_REQUEST && msg.data_length_code >= 3) {
+        const uint8_t dst = n2k::id_destination(msg.identifier);
+        const uint32_t requested = msg.data[0] |
+                                   (msg.data[1] << 8) |
+                                   (static_cast<uint32_t>(msg.data[2]) << 16);
+        if (requested == n2k::PGN_ISO_ADDRESS_CLAIM &&
+            (dst == address_ || dst == n2k::ADDRESS_GLOBAL)) {
+          send_address_claim();
+        }
+      } else if (pgn == n2k::PGN_ISO_ADDRESS_CLAIM &&
+                 msg.data_length_code == 8 &&
+                 n2k::id_source(msg.identifier) == address_) {
+        on_conflicting_claim(n2k::decode_name(msg.data));
+      }
+    }
+  }
+
+  // Lower NAME wins; we defend or move to the next free-looking address
+  void on_conflicting_claim(uint64_t other) {
+    if (other == name_.value()) return;
+
+    if (other > name_.value()) {
+      send_address_claim();   // defend
+      return;
+    }
+
+    address_ = (address_ >= 251) ? 128 : static_cast<uint8_t>(address_ + 1);
+    ESP_LOGW("N2K", "Address conflict, moving to %u", address_);
+    send_address_claim();
+  }
+
+  bool send_frame(uint32_t id, const uint8_t* data, size_t len) {
+    twai_message_t msg = {};
+    msg.extd             = 1;
+    msg.identifier       = id;
+    msg.data_length_code = static_cast<uint8_t>(len);
+    memcpy(msg.data, data, len);
+
+    if (twai_transmit(&msg, 0) != ESP_OK) {
+      dropped_++;
+      return false;
+    }
+    return true;
+  }
+};
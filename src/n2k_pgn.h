@@ -0,0 +1,225 @@
+#pragma once
+
+// ============================================================================
+// NMEA 2000 engine PGN encoding (no driver dependency)
+// ============================================================================
+//
+// • 29-bit CAN identifiers (priority / PGN / destination / source)
+// • PGN 127488 Engine Parameters, Rapid Update   — single frame, 8 bytes
+// • PGN 127489 Engine Parameters, Dynamic        — fast packet, 26 bytes
+// • PGN 60928  ISO Address Claim (64-bit NAME)
+// • Inputs in the units used everywhere else in this firmware
+//   (rev/s, K, Pa, L/h, hours, load ratio); NaN → "data not available"
+// • Field layout / resolutions as in canboat pgns.json
+// ============================================================================
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace n2k {
+
+static constexpr uint32_t PGN_ISO_REQUEST         = 59904;
+static constexpr uint32_t PGN_ISO_ADDRESS_CLAIM   = 60928;
+static constexpr uint32_t PGN_ENGINE_RAPID        = 127488;
+static constexpr uint32_t PGN_ENGINE_DYNAMIC      = 127489;
+
+static constexpr uint8_t  ADDRESS_GLOBAL          = 255;
+static constexpr uint8_t  ADDRESS_NULL            = 254;
+
+static constexpr size_t   ENGINE_RAPID_LEN        = 8;
+static constexpr size_t   ENGINE_DYNAMIC_LEN      = 26;
+
+// Fast packet: 6 bytes in frame 0, 7 in each following frame
+static constexpr size_t   FAST_PACKET_MAX_LEN     = 223;
+
+// ----------------------------------------------------------------------------
+// CAN identifier
+// ----------------------------------------------------------------------------
+inline uint32_t can_id(uint8_t priority, uint32_t pgn,
+                       uint8_t source, uint8_t destination = ADDRESS_GLOBAL) {
+  const uint8_t pf = static_cast<uint8_t>((pgn >> 8) & 0xFF);
+  uint32_t id_pgn  = pgn & 0x3FFFF;
+
+  // PDU1 (PF < 240): low byte of the identifier is the destination
+  if (pf < 240) {
+    id_pgn = (id_pgn & 0x3FF00) | destination;
+  }
+
+  return (static_cast<uint32_t>(priority & 0x7) << 26) |
+         (id_pgn << 8) |
+         source;
+}
+
+inline uint32_t id_pgn(uint32_t id) {
+  const uint32_t pgn = (id >> 8) & 0x3FFFF;
+  const uint8_t  pf  = static_cast<uint8_t>((pgn >> 8) & 0xFF);
+  return (pf < 240) ? (pgn & 0x3FF00) : pgn;
+}
+
+inline uint8_t id_source(uint32_t id)      { return id & 0xFF; }
+inline uint8_t id_destination(uint32_t id) { return (id >> 8) & 0xFF; }
+
+// ----------------------------------------------------------------------------
+// Scaled field helpers (round to nearest, out of range → not available)
+// ----------------------------------------------------------------------------
+inline uint16_t to_u16(float value, float resolution) {
+  if (!std::isfinite(value)) return 0xFFFF;
+  const float raw = std::round(value / resolution);
+  if (raw < 0.0f || raw > 65533.0f) return 0xFFFF;   // 0xFFFE/F reserved
+  return static_cast<uint16_t>(raw);
+}
+
+inline uint16_t to_i16(float value, float resolution) {
+  if (!std::isfinite(value)) return 0x7FFF;
+  const float raw = std::round(value / resolution);
+  if (raw < -32767.0f || raw > 32765.0f) return 0x7FFF;
+  return static_cast<uint16_t>(static_cast<int16_t>(raw));
+}
+
+inline uint32_t to_u32(float value, float resolution) {
+  if (!std::isfinite(value)) return 0xFFFFFFFFu;
+  const double raw = std::round(static_cast<double>(value) / resolution);
+  if (raw < 0.0 || raw > 4294967293.0) return 0xFFFFFFFFu;
+  return static_cast<uint32_t>(raw);
+}
+
+inline uint8_t to_i8(float value, float resolution) {
+  if (!std::isfinite(value)) return 0x7F;
+  const float raw = std::round(value / resolution);
+  if (raw < -127.0f || raw > 125.0f) return 0x7F;
+  return static_cast<uint8_t>(static_cast<int8_t>(raw));
+}
+
+inline void put_u16(uint8_t* p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+inline void put_u32(uint8_t* p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = v >> 24;
+}
+
+// ----------------------------------------------------------------------------
+// PGN 127488 — engine speed (0.25 rpm/bit), boost and trim not available
+// ----------------------------------------------------------------------------
+inline void encode_engine_rapid(uint8_t* out, uint8_t instance, float rev_s) {
+  memset(out, 0xFF, ENGINE_RAPID_LEN);
+  out[0] = instance;
+  put_u16(out + 1, to_u16(rev_s * 60.0f, 0.25f));
+  put_u16(out + 3, 0xFFFF);   // boost pressure
+  out[5] = 0x7F;              // tilt / trim
+}
+
+// ----------------------------------------------------------------------------
+// PGN 127489 — dynamic parameters (fields this firmware measures)
+// ----------------------------------------------------------------------------
+struct EngineDynamic {
+  float oil_pressure_Pa = NAN;
+  float coolant_K       = NAN;
+  float fuel_rate_lph   = NAN;
+  float hours           = NAN;
+  float load_ratio      = NAN;   // 0..1
+};
+
+inline void encode_engine_dynamic(uint8_t* out, uint8_t instance,
+                                  const EngineDynamic& d) {
+  memset(out, 0xFF, ENGINE_DYNAMIC_LEN);
+  out[0] = instance;
+  put_u16(out + 1,  to_u16(d.oil_pressure_Pa, 100.0f));
+  put_u16(out + 3,  0xFFFF);                             // oil temperature
+  put_u16(out + 5,  to_u16(d.coolant_K, 0.01f));
+  put_u16(out + 7,  0x7FFF);                             // alternator V
+  put_u16(out + 9,  to_i16(d.fuel_rate_lph, 0.1f));
+  put_u32(out + 11, to_u32(d.hours * 3600.0f, 1.0f));
+  put_u16(out + 15, 0xFFFF);                             // coolant pressure
+  put_u16(out + 17, 0xFFFF);                             // fuel pressure
+  out[19] = 0xFF;                                        // reserved
+  put_u16(out + 20, 0x0000);                             // discrete status 1
+  put_u16(out + 22, 0x0000);                             // discrete status 2
+  out[24] = to_i8(d.load_ratio * 100.0f, 1.0f);
+  out[25] = 0x7F;                                        // torque
+}
+
+// ----------------------------------------------------------------------------
+// ISO NAME (PGN 60928 payload, little endian)
+// ----------------------------------------------------------------------------
+struct Name {
+  uint32_t unique_number     = 0;      // 21 bits
+  uint16_t manufacturer_code = 2046;   // 11 bits (unregistered / DIY)
+  uint8_t  device_instance   = 0;
+  uint8_t  device_function   = 140;    // Engine
+  uint8_t  device_class      = 50;     // Propulsion
+  uint8_t  system_instance   = 0;
+  uint8_t  industry_group    = 4;      // Marine
+  bool     arbitrary_address = true;
+
+  uint64_t value() const {
+    return (static_cast<uint64_t>(unique_number & 0x1FFFFF)) |
+           (static_cast<uint64_t>(manufacturer_code & 0x7FF) << 21) |
+           (static_cast<uint64_t>(device_instance) << 32) |
+           (static_cast<uint64_t>(device_function) << 40) |
+           (static_cast<uint64_t>(device_class & 0x7F) << 49) |
+           (static_cast<uint64_t>(system_instance & 0x0F) << 56) |
+           (static_cast<uint64_t>(industry_group & 0x07) << 60) |
+           (static_cast<uint64_t>(arbitrary_address ? 1 : 0) << 63);
+  }
+};
+
+inline void encode_name(uint8_t* out, uint64_t name) {
+  for (size_t i = 0; i < 8; i++) {
+    out[i] = static_cast<uint8_t>(name >> (8 * i));
+  }
+}
+
+inline uint64_t decode_name(const uint8_t* in) {
+  uint64_t name = 0;
+  for (size_t i = 0; i < 8; i++) {
+    name |= static_cast<uint64_t>(in[i]) << (8 * i);
+  }
+  return name;
+}
+
+// ----------------------------------------------------------------------------
+// Fast-packet framing — writes 8-byte frames, returns the frame count
+// ----------------------------------------------------------------------------
+inline size_t fast_packet_frames(size_t len) {
+  if (len <= 6) return 1;
+  return 1 + (len - 6 + 6) / 7;
+}
+
+inline size_t fast_packet_encode(uint8_t (*frames)[8], size_t max_frames,
+                                 uint8_t sequence,
+                                 const uint8_t* data, size_t len) {
+  if (len > FAST_PACKET_MAX_LEN || fast_packet_frames(len) > max_frames) {
+    return 0;
+  }
+
+  const uint8_t seq = static_cast<uint8_t>((sequence & 0x07) << 5);
+  size_t pos = 0;
+  size_t n   = 0;
+
+  while (pos < len || n == 0) {
+    uint8_t* f = frames[n];
+    memset(f, 0xFF, 8);
+    f[0] = static_cast<uint8_t>(seq | (n & 0x1F));
+
+    size_t first = 1;
+    if (n == 0) {
+      f[1]  = static_cast<uint8_t>(len);
+      first = 2;
+    }
+
+    for (size_t i = first; i < 8 && pos < len; i++) {
+      f[i] = data[pos++];
+    }
+    n++;
+  }
+
+  return n;
+}
+
+}  // namespace n2k
@@ -22,69 +22,131 @@ Oil Pressure Sender                        ESP32 FireBeetle
 */
 
 // Divider: 10k / 10k  → ADC sees 0.25–2.25 V
-// Output: environment.engine.oilPressure (Pa)
+// Output: environment.engine.oilPressure (Pa) — id "engine", otherwise
+//         propulsion.<id>.oilPressure
+//
+// • Calibrated ADC (DMA scan, oversampled) at 20 Hz, trim-only: no outlier
+//   gate, so a pressure loss already moves the burst that contains it
+// • ADC code → Pa in one LUT load (divider + transducer scale folded in)
+// • Display path: 1.6 s moving average published at 5 Hz (unchanged)
+// • Fast path: LowOilPressureAlarm on the unsmoothed 20 Hz value
+//     → notifications.environment.engine.oilPressure within ~100 ms
+//       (notifications.propulsion.<id>.oilPressure)
 // ============================================================================
 
 #include <Arduino.h>
+#include <cmath>
 
-#include <sensesp/sensors/analog_input.h>
-#include <sensesp/transforms/lambda_transform.h>
+#include <sensesp/system/valueproducer.h>
 #include <sensesp/transforms/moving_average.h>
 #include <sensesp/signalk/signalk_output.h>
+#include <sensesp/ui/config_item.h>
+
+#include "calibrated_analog_input.h"
+#include "data_logger.h"
+#include "engine_instance.h"
+#include "n2k_engine_output.h"
+#include "oil_pressure_alarm.h"
+#include "pipeline_profiler.h"
+#include "power_profile.h"
+#include "sender_curves.h"
+#include "sk_output_batcher.h"
+#include "sk_replay.h"
 
 using namespace sensesp;
 
+extern AdcScanEngine* g_adc_scan;
+extern SkOutputBatcher* g_sk_batcher;
+
 // -----------------------------------------------------------------------------
-// SENSOR CONSTANTS
+// SENSOR CONSTANTS (transducer scale: sender_curves.h)
 // -----------------------------------------------------------------------------
-static constexpr float DIVIDER_RATIO  = 0.5f;
-
-static constexpr float SENSOR_V_MIN   = 0.5f;
-static constexpr float SENSOR_V_MAX   = 4.5f;
-static constexpr float SENSOR_PSI_MAX = 100.0f;
+static constexpr float    OIL_SAMPLE_RATE_HZ    = 20.0f;
+static constexpr int      OIL_DISPLAY_MA_WINDOW = 32;    // 1.6 s @ 20 Hz
+static constexpr uint32_t OIL_DISPLAY_EMIT_MS   = 200;   // 5 Hz
 
 // -----------------------------------------------------------------------------
 // SETUP FUNCTION
 // -----------------------------------------------------------------------------
-inline void setup_oil_pressure_sensor(uint8_t adc_pin) {
+inline void setup_oil_pressure_sensor(EngineInstance& e) {
 
-  auto* oil_adc = new AnalogInput(
-      adc_pin,
-      200,
-      "/Engine/OilPressure/ADC",
-      1.0
+  // Raw code → Pa, decimated from the DMA scan
+  auto* oil_pa = new CalibratedAnalogInput(
+      e.config().pin_adc_oil,
+      g_adc_scan,
+      OIL_SAMPLE_RATE_HZ,
+      e.config_path("/Engine/OilPressure/ADC")
   );
+  oil_pa->set_output_lut(&oil_adc_to_pa);
+  oil_pa->set_scan_reject_codes(0.0f);   // gate would hide a step for one burst
+  oil_pa->set_perf_name(e.perf_name("adc_scan_read"));
+  oil_pa->enable();
 
-  // ADC volts → sensor volts
-  auto* adc_to_sensor_v = new LambdaTransform<float, float>(
-    [](float adc_v) {
-      return adc_v / DIVIDER_RATIO;
-    }
+  // ---------------------------------------------------------------------------
+  // Display value (same 1.6 s smoothing and 5 Hz rate as before)
+  // ---------------------------------------------------------------------------
+  auto* oil_pa_smooth = oil_pa->connect_to(
+      new MovingAverage(OIL_DISPLAY_MA_WINDOW)
   );
 
-  // Sensor volts → PSI
-  auto* sensor_v_to_psi = new LambdaTransform<float, float>(
-    [](float v) {
-      v = constrain(v, SENSOR_V_MIN, SENSOR_V_MAX);
-      return (v - SENSOR_V_MIN) *
-             (SENSOR_PSI_MAX / (SENSOR_V_MAX - SENSOR_V_MIN));
-    }
+  auto* sk_oil = new SKOutputFloat(
+      e.legacy_paths() ? String("environment.engine.oilPressure")
+                       : e.sk_path("oilPressure")
   );
 
-  auto* psi_smooth = new MovingAverage(8);
+  // Batched: ≥ 0.1 psi change to send, otherwise keep-alive only
+  auto* oil_out = batched(g_sk_batcher, sk_oil, OIL_DISPLAY_EMIT_MS, 690.0f);
 
-  auto* psi_to_pa = new LambdaTransform<float, float>(
-    [](float psi) {
-      return psi * 6894.757f;
-    }
+  // Display rate; keep-alive only when the engine is off (alarm unaffected)
+  uint32_t last_emit_ms = 0;
+  perf_repeat(
+      e.perf_name("oil_emit"),
+      OIL_DISPLAY_EMIT_MS,
+      [oil_pa_smooth, oil_out, last_emit_ms]() mutable {
+        if (power_throttled(last_emit_ms, ENGINE_OFF_EMIT_MS)) return;
+        float v = oil_pa_smooth->get();
+        if (!std::isnan(v)) {
+          oil_out->set(v);
+        }
+      }
   );
 
-  oil_adc
-    ->connect_to(adc_to_sensor_v)
-    ->connect_to(sensor_v_to_psi)
-    ->connect_to(psi_smooth)
-    ->connect_to(psi_to_pa)
-    ->connect_to(new SKOutputFloat(
-        "environment.engine.oilPressure"
-    ));
+  // Direct NMEA 2000 PGN 127489 (display-smoothed Pa)
+  if (e.n2k) {
+    oil_pa_smooth->connect_to(e.n2k->oil_pressure());
+  }
+
+  // Log the unsmoothed 20 Hz value (the log has its own rate)
+  if (e.datalog()) {
+    oil_pa->connect_to(e.datalog()->oil_pressure());
+  }
+
+  if (e.sk_replay()) {
+    e.sk_replay()->bind(REPLAY_OIL_PRESSURE, sk_oil);
+  }
+
+  // ---------------------------------------------------------------------------
+  // Fast low-pressure alarm (unsmoothed, gated on engine speed)
+  // ---------------------------------------------------------------------------
+  auto* alarm = new LowOilPressureAlarm(
+      e.rev_s_smooth,
+      e.config_path("/config/sensors/oil_pressure/alarm")
+  );
+
+  auto* sk_alarm = new SKOutputRawJson(
+      e.legacy_paths() ? String("notifications.environment.engine.oilPressure")
+                       : e.notification_path("oilPressure"),
+      e.config_path("/config/outputs/sk/oil_pressure_notification")
+  );
+
+  oil_pa->connect_to(alarm)->connect_to(sk_alarm);
+
+  ConfigItem(alarm)
+      ->set_title(e.ui_title("Low Oil Pressure Alarm"))
+      ->set_description(
+          "Fast-path threshold on raw 20 Hz oil pressure; "
+          "armed only while the engine runs");
+
+  ConfigItem(sk_alarm)
+      ->set_title(e.ui_title("Low Oil Pressure Notification SK Path"));
 }
@@ -0,0 +1,175 @@
+#pragma once
+
+// ============================================================================
+// LowOilPressureAlarm — fast-path threshold detector → Signal K notification
+// ============================================================================
+//
+// • Fed directly from the 20 Hz calibrated oil pressure (Pa), BEFORE any
+//   display smoothing → crossing reaches Signal K within ~100 ms
+// • Armed only while the engine runs above min_rpm (EngineInstance::rev_s_smooth)
+//   and start_delay_ms has elapsed since it started (pressure build-up)
+// • debounce_samples consecutive low samples raise the alarm; it clears
+//   above clear_psi (hysteresis) or when the engine stops
+// • Emits a raw JSON notification value only when the state changes
+// ============================================================================
+
+#include <Arduino.h>
+#include <cmath>
+
+#include <sensesp/system/valueproducer.h>
+#include <sensesp/transforms/transform.h>
+
+using namespace sensesp;
+
+class LowOilPressureAlarm : public Transform<float, String> {
+ public:
+  LowOilPressureAlarm(ValueProducer<float>* engine_rev_s,
+                      const String& config_path = "")
+      : Transform<float, String>(config_path),
+        engine_rev_s_(engine_rev_s) {
+    this->load();
+  }
+
+  void set(const float& pa) override {
+    const uint32_t now = millis();
+
+    if (!armed(now) || std::isnan(pa)) {
+      below_count_ = 0;
+      update(false);
+      return;
+    }
+
+    if (alarm_) {
+      update(pa < clear_psi_ * PA_PER_PSI);
+      return;
+    }
+
+    if (pa < low_psi_ * PA_PER_PSI) {
+      below_count_++;
+    } else {
+      below_count_ = 0;
+    }
+
+    update(below_count_ >= debounce_samples_);
+  }
+
+  bool alarm() const { return alarm_; }
+
+  // -------------------------------------------------------------------------
+  // SensESP configuration persistence
+  // -------------------------------------------------------------------------
+  bool to_json(JsonObject& json) override {
+    json["low_psi"]          = low_psi_;
+    json["clear_psi"]        = clear_psi_;
+    json["min_rpm"]          = min_rpm_;
+    json["start_delay_ms"]   = start_delay_ms_;
+    json["debounce_samples"] = debounce_samples_;
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    if (json["low_psi"].is<float>()) {
+      low_psi_ = json["low_psi"].as<float>();
+    }
+    if (json["clear_psi"].is<float>()) {
+      clear_psi_ = json["clear_psi"].as<float>();
+    }
+    if (clear_psi_ < low_psi_) {
+      clear_psi_ = low_psi_;
+    }
+    if (json["min_rpm"].is<float>()) {
+      min_rpm_ = json["min_rpm"].as<float>();
+    }
+    if (json["start_delay_ms"].is<uint32_t>()) {
+      start_delay_ms_ = json["start_delay_ms"].as<uint32_t>();
+    }
+    if (json["debounce_samples"].is<int>()) {
+      const int n = json["debounce_samples"].as<int>();
+      debounce_samples_ = (n < 1) ? 1 : static_cast<uint32_t>(n);
+    }
+    return true;
+  }
+
+ private:
+  static constexpr float PA_PER_PSI = 6894.757f;
+
+  ValueProducer<float>* engine_rev_s_;
+
+  float    low_psi_          = 7.0f;
+  float    clear_psi_        = 10.0f;
+  float    min_rpm_          = 700.0f;
+  uint32_t start_delay_ms_   = 3000;
+  uint32_t debounce_samples_ = 2;      // 100 ms @ 20 Hz
+
+  bool     alarm_            = false;
+  bool     published_        = false;
+  bool     running_          = false;
+  uint32_t running_since_ms_ = 0;
+  uint32_t below_count_      = 0;
+
+  // Engine above min_rpm for at least start_delay_ms
+  bool armed(uint32_t now) {
+    const float rps = engine_rev_s_ ? engine_rev_s_->get() : NAN;
+    const bool running = std::isfinite(rps) && (rps * 60.0f) >= min_rpm_;
+
+    if (!running) {
+      running_ = false;
+      return false;
+    }
+
+    if (!running_) {
+      running_          = true;
+      running_since_ms_ = now;
+    }
+
+    return (now - running_since_ms_) >= start_delay_ms_;
+  }
+
+  void update(bool alarm) {
+    if (published_ && alarm == alarm_) {
+      return;
+    }
+
+    alarm_     = alarm;
+    published_ = true;
+
+    this->emit(alarm
+        ? String("{\"state\":\"alarm\",\"method\":[\"visual\",\"sound\"],"
+                 "\"message\":\"Low engine oil pressure\"}")
+        : String("{\"state\":\"normal\",\"method\":[],"
+                 "\"message\":\"Engine oil pressure normal\"}"));
+  }
+};
+
+inline String ConfigSchema(const LowOilPressureAlarm&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "low_psi": {
+        "title": "Alarm below (psi)",
+        "type": "number",
+        "description": "Raw (unsmoothed) oil pressure threshold"
+      },
+      "clear_psi": {
+        "title": "Clear above (psi)",
+        "type": "number",
+        "description": "Hysteresis: alarm clears above this pressure"
+      },
+      "min_rpm": {
+        "title": "Armed above (RPM)",
+        "type": "number",
+        "description": "Alarm only evaluated while the engine runs above this speed"
+      },
+      "start_delay_ms": {
+        "title": "Start-up delay (ms)",
+        "type": "integer",
+        "description": "Time above min RPM before arming (oil pressure build-up)"
+      },
+      "debounce_samples": {
+        "title": "Debounce (samples @ 20 Hz)",
+        "type": "integer",
+        "description": "Consecutive low samples required to raise the alarm"
+      }
+    }
+  })JSON";
+}
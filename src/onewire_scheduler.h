@@ -0,0 +1,380 @@
+#pragma once
+
+// ============================================================================
+// OneWireScheduler — non-blocking DS18B20 acquisition on all buses
+// ============================================================================
+//
+// • One low-priority FreeRTOS task (core 0) owns every OneWire bus; all
+//   bit-banged transfers happen there, never on the SensESP event loop
+// • Each cycle: start conversions on ALL buses at once
+//   (setWaitForConversion(false)), sleep the conversion time, then read
+//   every scratchpad (CRC-checked by DallasTemperature)
+// • Results land in per-sensor slots (spinlock, a few words), harvested
+//   every HARVEST_INTERVAL_MS by the AcquisitionTask (or the event loop)
+//   and emitted on the event loop — microseconds per slice
+// • set_read_delay() changes the pause between cycles at runtime (engine
+//   off profile); a shorter delay takes effect immediately
+// • OneWireTempSensor: per-sensor producer (Kelvin), address selectable in
+//   the UI like SensESP's OneWireTemperature (empty → first unclaimed)
+// • ROM IDs found by the bus search are cached in NVS (BootCache): at boot
+//   the cached devices are only checked for presence. The search runs
+//   again when one is missing or the firmware changed (a sensor added to
+//   an empty slot is found after the next update or sensor swap)
+// ============================================================================
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+#include <OneWire.h>
+#include <esp_log.h>
+
+#include "sensesp/sensors/sensor.h"
+#include "sensesp_app.h"
+
+#include "acquisition_task.h"
+#include "boot_cache.h"
+
+using namespace sensesp;
+
+class OneWireScheduler;
+
+// ============================================================================
+// Per-sensor producer
+// ============================================================================
+class OneWireTempSensor : public Sensor<float> {
+ public:
+  OneWireTempSensor(OneWireScheduler* scheduler,
+                    int bus,
+                    const String& config_path = "");
+
+  bool to_json(JsonObject& json) override {
+    json["address"] = address_str_;
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    if (json["address"].is<String>()) {
+      address_str_ = json["address"].as<String>();
+    }
+    return true;
+  }
+
+  int bus() const { return bus_; }
+  bool has_address() const { return found_; }
+  const uint8_t* address() const { return address_; }
+
+ private:
+  friend class OneWireScheduler;
+
+  int     bus_;
+  String  address_str_;
+  uint8_t address_[8] = {};
+  bool    found_      = false;
+
+  // Written by the acquisition task, read by the event loop
+  float latest_K_ = NAN;
+  bool  fresh_    = false;
+
+  void assign(const uint8_t* addr) {
+    memcpy(address_, addr, sizeof(address_));
+    found_       = true;
+    address_str_ = format_address(addr);
+  }
+
+  static String format_address(const uint8_t* a) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x",
+             a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+    return String(buf);
+  }
+};
+
+inline String ConfigSchema(const OneWireTempSensor&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "address": {
+        "title": "Sensor address",
+        "type": "string",
+        "description": "DS18B20 ROM code (empty = first unclaimed sensor on the bus, restart required)"
+      }
+    }
+  })JSON";
+}
+
+// ============================================================================
+// Scheduler
+// ============================================================================
+class OneWireScheduler : public AcquisitionSource {
+ public:
+  static constexpr size_t MAX_BUSES   = 3;
+  static constexpr size_t MAX_SENSORS = 8;
+
+  explicit OneWireScheduler(uint32_t read_delay_ms)
+      : read_delay_ms_(read_delay_ms) {}
+
+  // Returns the bus index (or -1 when full)
+  int add_bus(uint8_t pin) {
+    if (started_ || num_buses_ >= MAX_BUSES) {
+      ESP_LOGE("OneWire", "Cannot add OneWire bus on GPIO%d", pin);
+      return -1;
+    }
+
+    Bus& b   = buses_[num_buses_];
+    b.pin    = pin;
+    b.wire   = new OneWire(pin);
+    b.dallas = new DallasTemperature(b.wire);
+    return static_cast<int>(num_buses_++);
+  }
+
+  void add_sensor(OneWireTempSensor* sensor) {
+    if (started_ || num_sensors_ >= MAX_SENSORS ||
+        sensor->bus() < 0 || sensor->bus() >= static_cast<int>(num_buses_)) {
+      ESP_LOGE("OneWire", "Cannot register OneWire sensor");
+      return;
+    }
+    sensors_[num_sensors_++] = sensor;
+  }
+
+  // -------------------------------------------------------------------------
+  // Discover devices (setup time), assign addresses, start the task
+  // acq == nullptr → slots harvested from the event loop
+  // -------------------------------------------------------------------------
+  void start(AcquisitionTask* acq = nullptr) {
+    if (started_) {
+      return;
+    }
+
+    if (!load_cached_roms()) {
+      search_buses();
+      store_roms();
+    }
+
+    assign_addresses();
+
+    started_ = true;
+
+    xTaskCreatePinnedToCore(
+        &OneWireScheduler::task_entry,
+        "onewire",
+        TASK_STACK_BYTES,
+        this,
+        TASK_PRIORITY,
+        &task_,
+        TASK_CORE);
+
+    schedule(acq, HARVEST_INTERVAL_MS);
+  }
+
+  // Pause after each conversion cycle; wakes a task sleeping on the old one
+  void set_read_delay(uint32_t read_delay_ms) {
+    read_delay_ms_ = read_delay_ms;
+    if (task_) xTaskNotifyGive(task_);
+  }
+
+ private:
+  // --------------------------------------------------------------------------
+  // Constants
+  // --------------------------------------------------------------------------
+  static constexpr uint32_t    TASK_STACK_BYTES    = 4096;
+  static constexpr UBaseType_t TASK_PRIORITY       = tskIDLE_PRIORITY + 1;
+  static constexpr BaseType_t  TASK_CORE           = 0;    // loopTask is on 1
+  static constexpr uint32_t    HARVEST_INTERVAL_MS = 100;
+
+  static constexpr uint8_t     RESOLUTION_BITS     = 12;   // DS18B20 default
+
+  struct Bus {
+    uint8_t            pin    = 0;
+    OneWire*           wire   = nullptr;
+    DallasTemperature* dallas = nullptr;
+    uint8_t            num_roms = 0;
+    uint8_t            roms[MAX_SENSORS][8];
+  };
+
+  // NVS payload: every bus's devices, in add_bus() order
+  struct RomRecord {
+    uint8_t pins[MAX_BUSES];
+    uint8_t num_roms[MAX_BUSES];
+    uint8_t roms[MAX_BUSES][MAX_SENSORS][8];
+  };
+
+  volatile uint32_t  read_delay_ms_;
+  TaskHandle_t       task_        = nullptr;
+  Bus                buses_[MAX_BUSES];
+  size_t             num_buses_   = 0;
+  OneWireTempSensor* sensors_[MAX_SENSORS] = {};
+  size_t             num_sensors_ = 0;
+  bool               started_     = false;
+  portMUX_TYPE       mux_         = portMUX_INITIALIZER_UNLOCKED;
+
+  // -------------------------------------------------------------------------
+  // Device discovery: cached ROM IDs (presence check only) or a bus search
+  // -------------------------------------------------------------------------
+  bool load_cached_roms() {
+    RomRecord r;
+    if (!BootCache::load("onewire_roms", r)) return false;
+
+    for (size_t i = 0; i < num_buses_; i++) {
+      if (r.pins[i] != buses_[i].pin || r.num_roms[i] > MAX_SENSORS) return false;
+    }
+
+    for (size_t i = 0; i < num_buses_; i++) {
+      Bus& b = buses_[i];
+      b.num_roms = 0;
+      b.dallas->setWaitForConversion(false);
+      b.dallas->setResolution(RESOLUTION_BITS);   // conversion time only
+
+      for (uint8_t d = 0; d < r.num_roms[i]; d++) {
+        if (!b.dallas->isConnected(r.roms[i][d])) {
+          ESP_LOGI("OneWire", "GPIO%d: cached device gone, searching", b.pin);
+          return false;
+        }
+        memcpy(b.roms[b.num_roms++], r.roms[i][d], 8);
+      }
+      ESP_LOGI("OneWire", "GPIO%d: %u cached device(s)", b.pin,
+               static_cast<unsigned>(b.num_roms));
+    }
+    return true;
+  }
+
+  void search_buses() {
+    for (size_t i = 0; i < num_buses_; i++) {
+      Bus& b = buses_[i];
+      b.dallas->begin();
+      b.dallas->setWaitForConversion(false);
+
+      b.num_roms = 0;
+      const int n = b.dallas->getDeviceCount();
+      for (int d = 0; d < n && b.num_roms < MAX_SENSORS; d++) {
+        if (b.dallas->getAddress(b.roms[b.num_roms], d)) b.num_roms++;
+      }
+      ESP_LOGI("OneWire", "GPIO%d: %d device(s)", b.pin, n);
+    }
+  }
+
+  void store_roms() {
+    RomRecord r;
+    memset(&r, 0, sizeof(r));
+    for (size_t i = 0; i < num_buses_; i++) {
+      r.pins[i]     = buses_[i].pin;
+      r.num_roms[i] = buses_[i].num_roms;
+      memcpy(r.roms[i], buses_[i].roms, sizeof(r.roms[i]));
+    }
+    BootCache::store("onewire_roms", r);
+  }
+
+  // -------------------------------------------------------------------------
+  // Configured address if present on the sensor's bus, else first unclaimed
+  // -------------------------------------------------------------------------
+  void assign_addresses() {
+    for (size_t pass = 0; pass < 2; pass++) {
+      for (size_t i = 0; i < num_sensors_; i++) {
+        OneWireTempSensor* s = sensors_[i];
+        if (s->found_) continue;
+
+        Bus& b = buses_[s->bus_];
+
+        for (uint8_t d = 0; d < b.num_roms; d++) {
+          const uint8_t* addr = b.roms[d];
+          if (claimed(addr)) continue;
+
+          const bool configured =
+              OneWireTempSensor::format_address(addr) == s->address_str_;
+
+          // Pass 0: honour configured addresses; pass 1: fill the rest
+          if (configured || (pass == 1)) {
+            s->assign(addr);
+            break;
+          }
+        }
+
+        if (pass == 1 && !s->found_) {
+          ESP_LOGW("OneWire", "No DS18B20 for %s on GPIO%d",
+                   s->get_config_path().c_str(), b.pin);
+        }
+      }
+    }
+  }
+
+  bool claimed(const uint8_t* addr) const {
+    for (size_t i = 0; i < num_sensors_; i++) {
+      if (sensors_[i]->found_ &&
+          memcmp(sensors_[i]->address_, addr, 8) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // -------------------------------------------------------------------------
+  // Acquisition task — all bus I/O lives here
+  // -------------------------------------------------------------------------
+  static void task_entry(void* arg) {
+    static_cast<OneWireScheduler*>(arg)->run();
+  }
+
+  void run() {
+    for (;;) {
+      // Start conversions on every bus back to back
+      uint32_t conversion_ms = 0;
+      for (size_t i = 0; i < num_buses_; i++) {
+        buses_[i].dallas->requestTemperatures();
+        const uint32_t ms = buses_[i].dallas->millisToWaitForConversion(
+            buses_[i].dallas->getResolution());
+        if (ms > conversion_ms) conversion_ms = ms;
+      }
+
+      vTaskDelay(pdMS_TO_TICKS(conversion_ms));
+
+      for (size_t i = 0; i < num_sensors_; i++) {
+        OneWireTempSensor* s = sensors_[i];
+        if (!s->found_) continue;
+
+        const float c = buses_[s->bus_].dallas->getTempC(s->address_);
+        if (c == DEVICE_DISCONNECTED_C) {
+          continue;  // CRC / presence failure — keep the last value
+        }
+
+        portENTER_CRITICAL(&mux_);
+        s->latest_K_ = c + 273.15f;
+        s->fresh_    = true;
+        portEXIT_CRITICAL(&mux_);
+      }
+
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(read_delay_ms_));
+    }
+  }
+
+  // -------------------------------------------------------------------------
+  // Harvest: copy fresh results out of the slots (no bus I/O)
+  // -------------------------------------------------------------------------
+  void acquire(uint32_t now_ms) override {
+    for (size_t i = 0; i < num_sensors_; i++) {
+      OneWireTempSensor* s = sensors_[i];
+
+      portENTER_CRITICAL(&mux_);
+      const bool  fresh = s->fresh_;
+      const float value = s->latest_K_;
+      s->fresh_ = false;
+      portEXIT_CRITICAL(&mux_);
+
+      if (fresh) {
+        publish(static_cast<uint16_t>(i), value, now_ms);
+      }
+    }
+  }
+
+  void deliver(uint16_t index, float kelvin, uint32_t) override {
+    if (index < num_sensors_) {
+      sensors_[index]->emit(kelvin);
+    }
+  }
+};
+
+// ----------------------------------------------------------------------------
+inline OneWireTempSensor::OneWireTempSensor(OneWireScheduler* scheduler,
+                                            int bus,
+                                            const String& config_path)
+    : Sensor<float>(config_path), bus_(bus) {
+  this->load();
+  scheduler->add_sensor(this);
+}
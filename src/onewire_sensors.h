@@ -1,33 +1,53 @@
 #pragma once
 
-#include <sensesp_onewire/onewire_temperature.h>
 #include <sensesp/transforms/linear.h>
 #include <sensesp/signalk/signalk_output.h>
 #include <sensesp/ui/config_item.h>
 
+#include "data_logger.h"
+#include "engine_instance.h"
+#include "onewire_scheduler.h"
+#include "power_profile.h"
+#include "sk_output_batcher.h"
+#include "sk_replay.h"
+#include "thermal_anomaly.h"
+
 using namespace sensesp;
-using namespace sensesp::onewire;
 
 // These are provided by main.cpp
 extern const uint8_t PIN_TEMP_COMPARTMENT;
 extern const uint8_t PIN_TEMP_EXHAUST;
 extern const uint8_t PIN_TEMP_ALT_12V;
 extern const uint32_t ONEWIRE_READ_DELAY_MS;
+extern AcquisitionTask* g_acquisition;
+extern SkOutputBatcher* g_sk_batcher;
+extern DataLogger* g_datalog;
+extern SkReplay* g_sk_replay;
+
+// DS18B20 outputs: ≥ 0.1 K change to send, at most 1 Hz
+static constexpr uint32_t ONEWIRE_SK_MIN_INTERVAL_MS = 1000;
+static constexpr float    ONEWIRE_SK_DEADBAND_K      = 0.1f;
 
 // -----------------------------------------------------------------------------
 // OneWire / DS18B20 temperature sensors
+//
+// All three buses are driven by one OneWireScheduler task: conversions start
+// together, results are harvested by the event loop without bus I/O.
+// The exhaust elbow belongs to `engine` (propulsion.<id>.exhaustTemperature).
 // -----------------------------------------------------------------------------
-inline void setup_temperature_sensors() {
+inline void setup_temperature_sensors(EngineInstance& engine) {
+
+  auto* onewire = new OneWireScheduler(ONEWIRE_READ_DELAY_MS);
 
-  auto* s1 = new DallasTemperatureSensors(PIN_TEMP_COMPARTMENT);
-  auto* s2 = new DallasTemperatureSensors(PIN_TEMP_EXHAUST);
-  auto* s3 = new DallasTemperatureSensors(PIN_TEMP_ALT_12V);
+  const int s1 = onewire->add_bus(PIN_TEMP_COMPARTMENT);
+  const int s2 = onewire->add_bus(PIN_TEMP_EXHAUST);
+  const int s3 = onewire->add_bus(PIN_TEMP_ALT_12V);
 
   // ========================= ENGINE ROOM ==============================
 
-  auto* t1 = new OneWireTemperature(
+  auto* t1 = new OneWireTempSensor(
+      onewire,
       s1,
-      ONEWIRE_READ_DELAY_MS,
       "/config/sensors/temperature/engine"
   );
 
@@ -42,7 +62,9 @@ inline void setup_temperature_sensors() {
       "/config/outputs/sk/engine_temp"
   );
 
-  t1->connect_to(t1_linear)->connect_to(sk_engine);
+  t1->connect_to(t1_linear)->connect_to(batched(
+      g_sk_batcher, sk_engine,
+      ONEWIRE_SK_MIN_INTERVAL_MS, ONEWIRE_SK_DEADBAND_K));
 
   ConfigItem(t1)
       ->set_title("Engine Room DS18B20")
@@ -59,9 +81,9 @@ inline void setup_temperature_sensors() {
 
   // ========================= EXHAUST ==============================
 
-  auto* t2 = new OneWireTemperature(
+  auto* t2 = new OneWireTempSensor(
+      onewire,
       s2,
-      ONEWIRE_READ_DELAY_MS,
       "/config/sensors/temperature/exhaust"
   );
 
@@ -72,17 +94,21 @@ inline void setup_temperature_sensors() {
   );
 
   auto* sk_exhaust = new SKOutputFloat(
-      "propulsion.engine.exhaustTemperature",
+      engine.sk_path("exhaustTemperature"),
       "/config/outputs/sk/exhaust_temp"
   );
 
   auto* sk_exhaust_i70 = new SKOutputFloat(
-      "propulsion.engine.transmision.oilTemperature",
+      engine.sk_path("transmision.oilTemperature"),
       "/config/outputs/sk/transmission_temp"
   );
 
-  t2->connect_to(t2_linear)->connect_to(sk_exhaust);
-  t2->connect_to(t2_linear)->connect_to(sk_exhaust_i70);
+  t2->connect_to(t2_linear)->connect_to(batched(
+      g_sk_batcher, sk_exhaust,
+      ONEWIRE_SK_MIN_INTERVAL_MS, ONEWIRE_SK_DEADBAND_K));
+  t2_linear->connect_to(batched(
+      g_sk_batcher, sk_exhaust_i70,
+      ONEWIRE_SK_MIN_INTERVAL_MS, ONEWIRE_SK_DEADBAND_K));
 
   ConfigItem(t2)
       ->set_title("Exhaust elbow DS18B20")
@@ -96,11 +122,15 @@ inline void setup_temperature_sensors() {
       ->set_title("Exhaust elbow SK Path")
       ->set_sort_order(202);
 
+  // Water-injected elbow: first to show a raw-water flow problem
+  setup_thermal_anomaly(
+      engine, t2_linear, "Exhaust", "exhaust", "exhaustTemperature", 203);
+
   // ========================= ALTERNATOR ==============================
 
-  auto* t3 = new OneWireTemperature(
+  auto* t3 = new OneWireTempSensor(
+      onewire,
       s3,
-      ONEWIRE_READ_DELAY_MS,
       "/config/sensors/temperature/alternator"
   );
 
@@ -115,7 +145,9 @@ inline void setup_temperature_sensors() {
       "/config/outputs/sk/alternator_temp"
   );
 
-  t3->connect_to(t3_linear)->connect_to(sk_alt);
+  t3->connect_to(t3_linear)->connect_to(batched(
+      g_sk_batcher, sk_alt,
+      ONEWIRE_SK_MIN_INTERVAL_MS, ONEWIRE_SK_DEADBAND_K));
 
   ConfigItem(t3)
       ->set_title("Alternator DS18B20")
@@ -128,4 +160,27 @@ inline void setup_temperature_sensors() {
   ConfigItem(sk_alt)
       ->set_title("Alternator SK Path")
       ->set_sort_order(302);
+
+  // On-device log (calibrated K): engine room, exhaust, alternator
+  if (g_datalog) {
+    t1_linear->connect_to(g_datalog->temperature(0));
+    t2_linear->connect_to(g_datalog->temperature(1));
+    t3_linear->connect_to(g_datalog->temperature(2));
+  }
+
+  if (g_sk_replay) {
+    g_sk_replay->bind(REPLAY_TEMP_ENGINE_ROOM, sk_engine);
+    g_sk_replay->bind(REPLAY_TEMP_EXHAUST, sk_exhaust);
+    g_sk_replay->bind(REPLAY_TEMP_ALTERNATOR, sk_alt);
+  }
+
+  // Engine off: one conversion cycle every ENGINE_OFF_ONEWIRE_DELAY_MS
+  if (g_power) {
+    g_power->on_change([onewire](PowerProfile p) {
+      onewire->set_read_delay((p == POWER_ENGINE_OFF) ? ENGINE_OFF_ONEWIRE_DELAY_MS
+                                                      : ONEWIRE_READ_DELAY_MS);
+    });
+  }
+
+  onewire->start(g_acquisition);
 }
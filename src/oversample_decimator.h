@@ -0,0 +1,131 @@
+#pragma once
+
+// ============================================================================
+// OversampleDecimator — burst → one high-resolution value
+// ============================================================================
+//
+// • add(): one pass per raw sample, no buffer, no sorting
+// • Outlier rejection, single pass:
+//     - samples further than reject_codes from the previous output are
+//       dropped (ADC spikes, switching noise)
+//     - the burst min and max are trimmed from the mean
+// • If a whole burst is rejected (a real step change), the ungated trimmed
+//   mean is used so the output re-anchors within one burst
+// • decimate(): returns the fractional mean code and starts a new burst
+//
+// Works on raw ADC codes (0..4095) so the result can index
+// UniformCurveLut::at_fractional() directly.
+// ============================================================================
+
+#include <cmath>
+#include <cstdint>
+
+class OversampleDecimator {
+ public:
+  static constexpr float DEFAULT_REJECT_CODES = 64.0f;   // ≈50 mV @ 11 dB
+
+  explicit OversampleDecimator(float reject_codes = DEFAULT_REJECT_CODES) {
+    set_reject_threshold(reject_codes);
+  }
+
+  // <= 0 disables gating (trim only)
+  void set_reject_threshold(float codes) {
+    reject_codes_ = codes;
+    update_gate();
+  }
+
+  // -------------------------------------------------------------------------
+  // One raw sample
+  // -------------------------------------------------------------------------
+  void add(uint16_t code) {
+    all_.add(code);
+    if (code >= gate_lo_ && code <= gate_hi_) {
+      kept_.add(code);
+    }
+  }
+
+  uint32_t count() const { return all_.n; }
+
+  // -------------------------------------------------------------------------
+  // Close the burst → mean code (NAN when no samples)
+  // -------------------------------------------------------------------------
+  float decimate() {
+    float out = NAN;
+
+    if (kept_.n > 0) {
+      out = kept_.trimmed_mean();
+    } else if (all_.n > 0) {
+      out = all_.trimmed_mean();
+    }
+
+    rejected_ = all_.n - kept_.n;
+    all_.clear();
+    kept_.clear();
+
+    if (!std::isnan(out)) {
+      last_ = out;
+      update_gate();
+    }
+
+    return out;
+  }
+
+  float    last() const { return last_; }
+  uint32_t rejected() const { return rejected_; }   // in the previous burst
+
+  // Forget the reference (next burst is trimmed only)
+  void reset() {
+    all_.clear();
+    kept_.clear();
+    last_     = NAN;
+    rejected_ = 0;
+    update_gate();
+  }
+
+ private:
+  struct Accum {
+    uint32_t sum = 0;
+    uint32_t n   = 0;
+    uint16_t min = UINT16_MAX;
+    uint16_t max = 0;
+
+    void add(uint16_t code) {
+      sum += code;
+      n++;
+      if (code < min) min = code;
+      if (code > max) max = code;
+    }
+
+    float trimmed_mean() const {
+      if (n >= 3) {
+        return static_cast<float>(sum - min - max) / (n - 2);
+      }
+      return static_cast<float>(sum) / n;
+    }
+
+    void clear() { *this = Accum(); }
+  };
+
+  Accum    all_;
+  Accum    kept_;
+  float    reject_codes_ = DEFAULT_REJECT_CODES;
+  float    last_         = NAN;
+  uint32_t rejected_     = 0;
+
+  // Integer gate so add() does no float math
+  uint16_t gate_lo_ = 0;
+  uint16_t gate_hi_ = UINT16_MAX;
+
+  void update_gate() {
+    if (std::isnan(last_) || !(reject_codes_ > 0.0f)) {
+      gate_lo_ = 0;
+      gate_hi_ = UINT16_MAX;
+      return;
+    }
+
+    const float lo = std::ceil(last_ - reject_codes_);
+    const float hi = std::floor(last_ + reject_codes_);
+    gate_lo_ = (lo <= 0.0f) ? 0 : static_cast<uint16_t>(lo);
+    gate_hi_ = (hi >= UINT16_MAX) ? UINT16_MAX : static_cast<uint16_t>(hi);
+  }
+};
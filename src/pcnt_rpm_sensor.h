@@ -0,0 +1,194 @@
+#pragma once
+
+// ============================================================================
+// PcntRpmSensor — hardware pulse-counter engine speed (SensESP v3.1.1)
+// ============================================================================
+//
+// • Counts flywheel tooth edges in the ESP32 PCNT peripheral (no GPIO ISR)
+// • PCNT glitch filter rejects pickup ringing shorter than filter_ns
+// • Counter is read and cleared once per window (default 250 ms)
+// • Emits rev/s (Hz) — same contract as the former Frequency transform:
+//       rev/s = edges / teeth / window_s
+// • 0.0 is emitted when no edges were seen in the window
+// • Counter read runs in the AcquisitionTask when one is given
+//
+// Why: 116 teeth at 3600 RPM is ~7 kHz of edges. DigitalInputCounter took an
+// interrupt per edge, which preempts WiFi and the SensESP event loop.
+// ============================================================================
+
+#include <Arduino.h>
+#include <driver/pcnt.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include <atomic>
+
+#include "sensesp/sensors/sensor.h"
+#include "sensesp_app.h"
+
+#include "acquisition_task.h"
+
+using namespace sensesp;
+
+class PcntRpmSensor : public Sensor<float>, public AcquisitionSource {
+ public:
+  PcntRpmSensor(uint8_t pin,
+                float teeth,
+                pcnt_unit_t unit = PCNT_UNIT_0,
+                const String& config_path = "")
+      : Sensor<float>(config_path),
+        pin_(pin),
+        teeth_(teeth),
+        unit_(unit) {
+    this->load();
+    configure_unit();
+  }
+
+  // -------------------------------------------------------------------------
+  // Must be called explicitly (custom Sensor subclasses are not auto-enabled)
+  // acq == nullptr → counter read from the event loop
+  // -------------------------------------------------------------------------
+  void enable(AcquisitionTask* acq = nullptr) {
+    last_read_us_ = esp_timer_get_time();
+    pcnt_counter_clear(unit_);
+    pcnt_counter_resume(unit_);
+
+    schedule(acq, window_ms_);
+  }
+
+  // Latest acquired rev/s (safe from any task; may be ahead of get())
+  float latest_rps() const { return latest_rps_.load(std::memory_order_relaxed); }
+
+  // -------------------------------------------------------------------------
+  // SensESP configuration persistence
+  // -------------------------------------------------------------------------
+  bool to_json(JsonObject& json) override {
+    json["window_ms"] = window_ms_;
+    json["filter_ns"] = filter_ns_;
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    if (json["window_ms"].is<int>()) {
+      window_ms_ = clamp_window(json["window_ms"].as<int>());
+    }
+    if (json["filter_ns"].is<int>()) {
+      filter_ns_ = json["filter_ns"].as<int>();
+    }
+    return true;
+  }
+
+ private:
+  // --------------------------------------------------------------------------
+  // Constants
+  // --------------------------------------------------------------------------
+  static constexpr int16_t  PCNT_H_LIM        = 32767;
+  static constexpr uint32_t MIN_WINDOW_MS     = 50;
+  // 16-bit counter: 3900 RPM × 116 teeth ≈ 7.5 kHz → 4 s before wrap
+  static constexpr uint32_t MAX_WINDOW_MS     = 2000;
+  static constexpr uint32_t APB_CYCLES_PER_US = 80;     // PCNT filter clock
+  static constexpr uint16_t MAX_FILTER_CYCLES = 1023;   // 10-bit filter
+
+  uint8_t     pin_;
+  float       teeth_;
+  pcnt_unit_t unit_;
+
+  uint32_t window_ms_ = 250;
+  int      filter_ns_ = 10000;  // 10 µs (tooth period @ 3900 RPM ≈ 133 µs)
+
+  int64_t            last_read_us_ = 0;
+  std::atomic<float> latest_rps_{0.0f};
+
+  static uint32_t clamp_window(int ms) {
+    if (ms < static_cast<int>(MIN_WINDOW_MS)) return MIN_WINDOW_MS;
+    if (ms > static_cast<int>(MAX_WINDOW_MS)) return MAX_WINDOW_MS;
+    return static_cast<uint32_t>(ms);
+  }
+
+  // -------------------------------------------------------------------------
+  // Configure PCNT unit: count rising edges only, no control pin
+  // -------------------------------------------------------------------------
+  void configure_unit() {
+    pcnt_config_t cfg = {};
+    cfg.pulse_gpio_num = pin_;
+    cfg.ctrl_gpio_num  = PCNT_PIN_NOT_USED;
+    cfg.channel        = PCNT_CHANNEL_0;
+    cfg.unit           = unit_;
+    cfg.pos_mode       = PCNT_COUNT_INC;
+    cfg.neg_mode       = PCNT_COUNT_DIS;
+    cfg.lctrl_mode     = PCNT_MODE_KEEP;
+    cfg.hctrl_mode     = PCNT_MODE_KEEP;
+    cfg.counter_h_lim  = PCNT_H_LIM;
+    cfg.counter_l_lim  = 0;
+
+    if (pcnt_unit_config(&cfg) != ESP_OK) {
+      ESP_LOGE("PcntRPM", "PCNT unit %d config failed (pin %d)",
+               static_cast<int>(unit_), pin_);
+      return;
+    }
+
+    uint32_t cycles = (filter_ns_ > 0)
+        ? (static_cast<uint32_t>(filter_ns_) * APB_CYCLES_PER_US) / 1000
+        : 0;
+    if (cycles > MAX_FILTER_CYCLES) cycles = MAX_FILTER_CYCLES;
+
+    if (cycles > 0) {
+      pcnt_set_filter_value(unit_, static_cast<uint16_t>(cycles));
+      pcnt_filter_enable(unit_);
+    } else {
+      pcnt_filter_disable(unit_);
+    }
+
+    pcnt_counter_pause(unit_);
+    pcnt_counter_clear(unit_);
+
+    ESP_LOGI("PcntRPM", "PCNT unit %d on GPIO%d, filter %u cycles",
+             static_cast<int>(unit_), pin_, static_cast<unsigned>(cycles));
+  }
+
+  // -------------------------------------------------------------------------
+  // Read + clear counter → rev/s over the measured (not nominal) window
+  // -------------------------------------------------------------------------
+  void acquire(uint32_t now_ms) override {
+    int16_t count = 0;
+    pcnt_get_counter_value(unit_, &count);
+    pcnt_counter_clear(unit_);
+
+    const int64_t now_us = esp_timer_get_time();
+    const int64_t dt_us  = now_us - last_read_us_;
+    last_read_us_ = now_us;
+
+    if (dt_us <= 0 || teeth_ <= 0.0f) {
+      return;
+    }
+
+    const float window_s = dt_us / 1000000.0f;
+    const float rps = (count / teeth_) / window_s;
+
+    latest_rps_.store(rps, std::memory_order_relaxed);
+    publish(0, rps, now_ms);
+  }
+
+  void deliver(uint16_t, float rps, uint32_t) override { emit(rps); }
+};
+
+// --------------------------------------------------------------------------
+// SensESP configuration schema (required)
+// --------------------------------------------------------------------------
+inline String ConfigSchema(const PcntRpmSensor&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "window_ms": {
+        "title": "Count window (ms)",
+        "type": "integer",
+        "description": "PCNT read interval, 50–2000 ms (restart required)"
+      },
+      "filter_ns": {
+        "title": "Glitch filter (ns)",
+        "type": "integer",
+        "description": "Ignore pulses shorter than this, max ~12700 ns (restart required)"
+      }
+    }
+  })JSON";
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+// ============================================================================
+// PeriodRpmSensor — input-capture (tooth period) engine speed
+// ============================================================================
+//
+// • MCPWM capture unit timestamps every Nth rising edge in hardware
+//   (capture prescaler = N teeth, one ISR per N teeth — not per edge)
+// • rev/s = (N / teeth) / (Δticks / APB_CLK)
+// • Emits at a fixed rate (default 20 Hz), independent of engine speed
+// • Below fallback_rpm, or when no capture arrived recently, the latest
+//   PCNT window count is emitted instead (period is meaningless when stalled)
+//
+// Output contract is identical to PcntRpmSensor: rev/s (Hz), 0.0 when stopped.
+// The periodic read runs in the AcquisitionTask when one is given.
+// ============================================================================
+
+#include <Arduino.h>
+#include <driver/mcpwm.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include "sensesp/sensors/sensor.h"
+#include "sensesp_app.h"
+
+#include "acquisition_task.h"
+#include "pcnt_rpm_sensor.h"
+
+using namespace sensesp;
+
+class PeriodRpmSensor : public Sensor<float>, public AcquisitionSource {
+ public:
+  PeriodRpmSensor(uint8_t pin,
+                  float teeth,
+                  PcntRpmSensor* fallback,
+                  mcpwm_unit_t unit = MCPWM_UNIT_0,
+                  const String& config_path = "")
+      : Sensor<float>(config_path),
+        pin_(pin),
+        teeth_(teeth),
+        fallback_(fallback),
+        unit_(unit) {
+    this->load();
+  }
+
+  // True when the UI selected period (input-capture) measurement
+  bool period_mode() const { return period_mode_; }
+
+  // -------------------------------------------------------------------------
+  // Must be called explicitly (custom Sensor subclasses are not auto-enabled)
+  // -------------------------------------------------------------------------
+  void enable(AcquisitionTask* acq = nullptr) {
+    if (!configure_capture()) {
+      return;
+    }
+
+    const uint32_t interval_ms =
+        static_cast<uint32_t>(1000.0f / emit_rate_hz_);
+
+    schedule(acq, interval_ms);
+  }
+
+  // -------------------------------------------------------------------------
+  // SensESP configuration persistence
+  // -------------------------------------------------------------------------
+  bool to_json(JsonObject& json) override {
+    json["period_mode"]      = period_mode_;
+    json["emit_rate_hz"]     = emit_rate_hz_;
+    json["teeth_per_period"] = teeth_per_period_;
+    json["fallback_rpm"]     = fallback_rpm_;
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    if (json["period_mode"].is<bool>()) {
+      period_mode_ = json["period_mode"].as<bool>();
+    }
+    if (json["emit_rate_hz"].is<float>()) {
+      emit_rate_hz_ = clamp_rate(json["emit_rate_hz"].as<float>());
+    }
+    if (json["teeth_per_period"].is<int>()) {
+      teeth_per_period_ = clamp_teeth(json["teeth_per_period"].as<int>());
+    }
+    if (json["fallback_rpm"].is<float>()) {
+      fallback_rpm_ = json["fallback_rpm"].as<float>();
+    }
+    return true;
+  }
+
+ private:
+  // --------------------------------------------------------------------------
+  // Constants
+  // --------------------------------------------------------------------------
+  static constexpr float    MIN_RATE_HZ        = 10.0f;
+  static constexpr float    MAX_RATE_HZ        = 20.0f;
+  static constexpr uint32_t MAX_PRESCALE       = 256;      // MCPWM hardware limit
+  static constexpr int64_t  MIN_STALE_US       = 200000;   // 200 ms
+
+  uint8_t        pin_;
+  float          teeth_;
+  PcntRpmSensor* fallback_;
+  mcpwm_unit_t   unit_;
+
+  bool     period_mode_      = false;
+  float    emit_rate_hz_     = 20.0f;
+  uint32_t teeth_per_period_ = 58;     // half a revolution
+  float    fallback_rpm_     = 600.0f;
+
+  float apb_hz_ = 80000000.0f;
+
+  // Written from the capture ISR, read on the event loop
+  volatile uint32_t last_cap_ticks_  = 0;
+  volatile uint32_t period_ticks_    = 0;
+  volatile int64_t  last_capture_us_ = 0;
+  portMUX_TYPE      mux_             = portMUX_INITIALIZER_UNLOCKED;
+
+  static float clamp_rate(float hz) {
+    if (!(hz >= MIN_RATE_HZ)) return MIN_RATE_HZ;
+    if (hz > MAX_RATE_HZ) return MAX_RATE_HZ;
+    return hz;
+  }
+
+  static uint32_t clamp_teeth(int n) {
+    if (n < 1) return 1;
+    if (n > static_cast<int>(MAX_PRESCALE)) return MAX_PRESCALE;
+    return static_cast<uint32_t>(n);
+  }
+
+  // -------------------------------------------------------------------------
+  // Capture ISR: one call per teeth_per_period_ edges
+  // -------------------------------------------------------------------------
+  static bool IRAM_ATTR on_capture(mcpwm_unit_t,
+                                   mcpwm_capture_channel_id_t,
+                                   const cap_event_data_t* edata,
+                                   void* user_data) {
+    auto* self = static_cast<PeriodRpmSensor*>(user_data);
+
+    portENTER_CRITICAL_ISR(&self->mux_);
+    if (self->last_capture_us_ != 0) {
+      self->period_ticks_ = edata->cap_value - self->last_cap_ticks_;
+    }
+    self->last_cap_ticks_  = edata->cap_value;
+    self->last_capture_us_ = esp_timer_get_time();
+    portEXIT_CRITICAL_ISR(&self->mux_);
+
+    return false;  // no task woken
+  }
+
+  bool configure_capture() {
+    apb_hz_ = static_cast<float>(getApbFrequency());
+
+    mcpwm_gpio_init(unit_, MCPWM_CAP_0, pin_);
+
+    mcpwm_capture_config_t cfg = {};
+    cfg.cap_edge     = MCPWM_POS_EDGE;
+    cfg.cap_prescale = teeth_per_period_;
+    cfg.capture_cb   = &PeriodRpmSensor::on_capture;
+    cfg.user_data    = this;
+
+    if (mcpwm_capture_enable_channel(unit_, MCPWM_SELECT_CAP0, &cfg) != ESP_OK) {
+      ESP_LOGE("PeriodRPM", "MCPWM capture enable failed (pin %d)", pin_);
+      return false;
+    }
+
+    ESP_LOGI("PeriodRPM", "MCPWM capture on GPIO%d, %u teeth/period, %.0f Hz",
+             pin_, static_cast<unsigned>(teeth_per_period_), emit_rate_hz_);
+    return true;
+  }
+
+  // -------------------------------------------------------------------------
+  // rev/s from the latest period, falling back to PCNT below idle
+  // -------------------------------------------------------------------------
+  void acquire(uint32_t now_ms) override {
+    portENTER_CRITICAL(&mux_);
+    const uint32_t ticks   = period_ticks_;
+    const int64_t  last_us = last_capture_us_;
+    portEXIT_CRITICAL(&mux_);
+
+    const float fallback_rps = fallback_ ? fallback_->latest_rps() : 0.0f;
+
+    if (ticks == 0 || last_us == 0 || teeth_ <= 0.0f) {
+      publish(0, fallback_rps, now_ms);
+      return;
+    }
+
+    const float period_s = ticks / apb_hz_;
+    const float rps = (teeth_per_period_ / teeth_) / period_s;
+
+    // Stale: no capture for 3 expected periods (engine stopping/stopped)
+    int64_t stale_us = static_cast<int64_t>(period_s * 3.0e6f);
+    if (stale_us < MIN_STALE_US) stale_us = MIN_STALE_US;
+
+    const bool stale = (esp_timer_get_time() - last_us) > stale_us;
+
+    if (stale || (rps * 60.0f) < fallback_rpm_) {
+      publish(0, fallback_rps, now_ms);
+      return;
+    }
+
+    publish(0, rps, now_ms);
+  }
+
+  void deliver(uint16_t, float rps, uint32_t) override { emit(rps); }
+};
+
+// --------------------------------------------------------------------------
+// SensESP configuration schema (required)
+// --------------------------------------------------------------------------
+inline String ConfigSchema(const PeriodRpmSensor&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "period_mode": {
+        "title": "Period (input-capture) mode",
+        "type": "boolean",
+        "description": "On = low-latency tooth-period RPM, Off = PCNT window count (restart required)"
+      },
+      "emit_rate_hz": {
+        "title": "Update rate (Hz)",
+        "type": "number",
+        "description": "Period mode output rate, 10–20 Hz"
+      },
+      "teeth_per_period": {
+        "title": "Teeth averaged per period",
+        "type": "integer",
+        "description": "Edges per capture (1–256); 58 = half a revolution"
+      },
+      "fallback_rpm": {
+        "title": "PCNT fallback below (RPM)",
+        "type": "number",
+        "description": "Below this speed the PCNT window count is used"
+      }
+    }
+  })JSON";
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+// ============================================================================
+// PipelineProfiler — per-stage cycle counts and event-loop jitter
+// ============================================================================
+//
+// • Compiled in with -DENABLE_PIPELINE_PROFILER=1 (platformio.ini); with 0
+//   every hook below is an empty inline / the untouched lambda
+// • Stages (event loop only — stats are not locked):
+//     perf_timed(name, fn)        wraps a LambdaTransform function: cycles
+//                                 of fn itself (downstream emits excluded)
+//     PerfScope scope(id)         cycles of a block (id from perf_stage())
+//     perf_repeat(name, ms, fn)   onRepeat() replacement: callback cycles
+//                                 (downstream included) + <name>_late, the
+//                                 period overrun in µs (0 = on time)
+//   loop_tick times the whole event_loop()->tick()
+// • Equal names share one stage: per-engine stages pass
+//   EngineInstance::perf_name() (engine 0 as is, others <id>.<stage>)
+// • PerfStats: count, min, mean, max and a log2 histogram (p99 is the
+//   upper edge of its bucket, clamped to max → within 2× of the truth)
+// • Every REPORT_INTERVAL_MS each stage is published as one compact string
+//   on debug.perf.<name> and on the web UI status page, then reset
+//   (stats cover the last interval)
+// • perf_format_json(): the same stats as one JSON object with a pass/fail
+//   budget, printed by the on-target budget suite (test/test_perf_budget)
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifndef ENABLE_PIPELINE_PROFILER
+#define ENABLE_PIPELINE_PROFILER 0
+#endif
+
+// ============================================================================
+// Stats (no SensESP dependency)
+// ============================================================================
+struct PerfStats {
+  static constexpr size_t BUCKETS = 32;   // bucket b: [2^b, 2^(b+1))
+
+  uint32_t count = 0;
+  uint32_t min   = UINT32_MAX;
+  uint32_t max   = 0;
+  uint64_t sum   = 0;
+  uint16_t hist[BUCKETS] = {};   // saturating
+
+  static size_t bucket(uint32_t v) {
+    return v ? static_cast<size_t>(31 - __builtin_clz(v)) : 0;
+  }
+
+  void record(uint32_t v) {
+    count++;
+    sum += v;
+    if (v < min) min = v;
+    if (v > max) max = v;
+
+    uint16_t& h = hist[bucket(v)];
+    if (h < UINT16_MAX) h++;
+  }
+
+  float mean() const {
+    return count ? static_cast<float>(static_cast<double>(sum) / count) : NAN;
+  }
+
+  // Upper bound of the p-quantile (0 < p ≤ 1), 0 when empty
+  uint32_t percentile(float p) const {
+    uint32_t total = 0;
+    for (size_t b = 0; b < BUCKETS; b++) total += hist[b];
+    if (total == 0) return 0;
+
+    uint32_t target = static_cast<uint32_t>(std::ceil(p * total));
+    if (target < 1) target = 1;
+
+    uint32_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; b++) {
+      seen += hist[b];
+      if (seen >= target) {
+        const uint32_t upper =
+            (b >= 31) ? UINT32_MAX : ((2u << b) - 1);
+        return (upper < max) ? upper : max;
+      }
+    }
+    return max;
+  }
+
+  void reset() { *this = PerfStats(); }
+};
+
+// "n=120 min=12.1 avg=14.0 p99=31.9 max=55.0" in units of `per_unit`
+// raw counts (e.g. cycles per µs); returns the length (0 on error)
+inline size_t perf_format(char* buf, size_t len, const PerfStats& s,
+                          float per_unit) {
+  if (!buf || len == 0) return 0;
+
+  int n;
+  if (s.count == 0) {
+    n = snprintf(buf, len, "n=0");
+  } else {
+    const float k = (per_unit > 0.0f) ? 1.0f / per_unit : 1.0f;
+    n = snprintf(buf, len, "n=%u min=%.1f avg=%.1f p99=%.1f max=%.1f",
+                 static_cast<unsigned>(s.count),
+                 static_cast<double>(s.min * k),
+                 static_cast<double>(s.mean() * k),
+                 static_cast<double>(s.percentile(0.99f) * k),
+                 static_cast<double>(s.max * k));
+  }
+  return (n > 0 && static_cast<size_t>(n) < len) ? static_cast<size_t>(n) : 0;
+}
+
+// One JSON object per metric for tracking across firmware versions
+// (test/test_perf_budget):
+//   {"metric":"fuel_load_eval","unit":"us","n":2,"min":1.0,"avg":1.5,
+//    "p99":2.0,"max":2.0,"budget":50.0,"pass":true}
+// pass = at least one sample and max ≤ budget (both in output units)
+inline size_t perf_format_json(char* buf, size_t len, const char* metric,
+                               const char* unit, const PerfStats& s,
+                               float per_unit, float budget) {
+  if (!buf || len == 0) return 0;
+
+  const float k   = (per_unit > 0.0f) ? 1.0f / per_unit : 1.0f;
+  const float max = s.max * k;
+  const bool pass = s.count > 0 && max <= budget;
+
+  int n;
+  if (s.count == 0) {
+    n = snprintf(buf, len,
+                 "{\"metric\":\"%s\",\"unit\":\"%s\",\"n\":0,"
+                 "\"budget\":%.1f,\"pass\":false}",
+                 metric, unit, static_cast<double>(budget));
+  } else {
+    n = snprintf(buf, len,
+                 "{\"metric\":\"%s\",\"unit\":\"%s\",\"n\":%u,\"min\":%.1f,"
+                 "\"avg\":%.1f,\"p99\":%.1f,\"max\":%.1f,"
+                 "\"budget\":%.1f,\"pass\":%s}",
+                 metric, unit, static_cast<unsigned>(s.count),
+                 static_cast<double>(s.min * k),
+                 static_cast<double>(s.mean() * k),
+                 static_cast<double>(s.percentile(0.99f) * k),
+                 static_cast<double>(max),
+                 static_cast<double>(budget),
+                 pass ? "true" : "false");
+  }
+  return (n > 0 && static_cast<size_t>(n) < len) ? static_cast<size_t>(n) : 0;
+}
+
+#if ENABLE_PIPELINE_PROFILER
+
+#include <Arduino.h>
+#include <esp_cpu.h>
+#include <esp_log.h>
+
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/ui/status_page_item.h>
+
+#include "sensesp_app.h"
+
+using namespace sensesp;
+
+// ============================================================================
+// Profiler
+// ============================================================================
+class PipelineProfiler {
+ public:
+  static constexpr size_t   MAX_STAGES         = 40;   // ~13 per engine
+  static constexpr uint32_t REPORT_INTERVAL_MS = 10000;
+  static constexpr size_t   SUMMARY_BYTES      = 64;
+
+  enum Unit : uint8_t { CYCLES, MICROS };
+
+  PipelineProfiler() { loop_stage_ = add("loop_tick", CYCLES); }
+
+  // Stage id for name (same name + unit → same stage), -1 when full
+  int add(const char* name, Unit unit) {
+    for (size_t i = 0; i < num_stages_; i++) {
+      if (stages_[i].unit == unit && strcmp(stages_[i].name, name) == 0) {
+        return static_cast<int>(i);
+      }
+    }
+    if (num_stages_ >= MAX_STAGES) {
+      ESP_LOGW("Perf", "Stage table full, '%s' not profiled", name);
+      return -1;
+    }
+
+    Stage& s = stages_[num_stages_];
+    s.name = name;
+    s.unit = unit;
+    return static_cast<int>(num_stages_++);
+  }
+
+  void record(int id, uint32_t value) {
+    if (id >= 0 && static_cast<size_t>(id) < num_stages_) {
+      stages_[id].stats.record(value);
+    }
+  }
+
+  int loop_stage() const { return loop_stage_; }
+
+  // After every stage is registered: outputs + report timer
+  void start() {
+    for (size_t i = 0; i < num_stages_; i++) {
+      Stage& s = stages_[i];
+      const String label =
+          String(s.name) + (s.unit == MICROS ? "_late" : "");
+      s.sk = new SKOutputString("debug.perf." + label);
+      s.ui = new StatusPageItem<String>(label, "", "Pipeline Profiler",
+                                        static_cast<int>(i));
+    }
+
+    sensesp_app->get_event_loop()->onRepeat(
+        REPORT_INTERVAL_MS,
+        [this]() { this->report(); });
+  }
+
+ private:
+  struct Stage {
+    const char*             name = "";
+    Unit                    unit = CYCLES;
+    PerfStats               stats;
+    SKOutputString*         sk   = nullptr;
+    StatusPageItem<String>* ui   = nullptr;
+  };
+
+  Stage  stages_[MAX_STAGES];
+  size_t num_stages_ = 0;
+  int    loop_stage_ = -1;
+
+  // Values in µs: cycles / MHz, lateness as is
+  void report() {
+    const float mhz = static_cast<float>(getCpuFrequencyMhz());
+    char buf[SUMMARY_BYTES];
+
+    for (size_t i = 0; i < num_stages_; i++) {
+      Stage& s = stages_[i];
+      if (!s.sk) continue;   // registered after start()
+
+      perf_format(buf, sizeof(buf), s.stats, s.unit == CYCLES ? mhz : 1.0f);
+      const String summary(buf);
+      s.sk->set(summary);
+      s.ui->set(summary);
+      s.stats.reset();
+    }
+  }
+};
+
+extern PipelineProfiler* g_profiler;   // main.cpp
+
+inline uint32_t perf_ccount() { return esp_cpu_get_ccount(); }
+
+inline int perf_stage(const char* name) {
+  return g_profiler ? g_profiler->add(name, PipelineProfiler::CYCLES) : -1;
+}
+
+inline int perf_loop_stage() {
+  return g_profiler ? g_profiler->loop_stage() : -1;
+}
+
+// Cycles of one block
+class PerfScope {
+ public:
+  explicit PerfScope(int id) : id_(id), t0_(perf_ccount()) {}
+  ~PerfScope() {
+    if (g_profiler) g_profiler->record(id_, perf_ccount() - t0_);
+  }
+
+ private:
+  int      id_;
+  uint32_t t0_;
+};
+
+// Timed wrapper around a transform function
+template <typename F>
+struct PerfTimed {
+  int id;
+  F   fn;
+
+  template <typename... A>
+  auto operator()(A... args) -> decltype(fn(args...)) {
+    PerfScope scope(id);
+    return fn(args...);
+  }
+};
+
+template <typename F>
+PerfTimed<F> perf_timed(const char* name, F fn) {
+  PerfTimed<F> t = {perf_stage(name), fn};
+  return t;
+}
+
+// onRepeat with callback cycles and period overrun (µs)
+template <typename F>
+void perf_repeat(const char* name, uint32_t interval_ms, F fn) {
+  const int run_id  = perf_stage(name);
+  const int late_id =
+      g_profiler ? g_profiler->add(name, PipelineProfiler::MICROS) : -1;
+  const uint32_t interval_us = interval_ms * 1000;
+  uint32_t last_us = 0;
+
+  sensesp_app->get_event_loop()->onRepeat(
+      interval_ms,
+      [=]() mutable {
+        const uint32_t now_us = micros();
+        if (last_us != 0 && g_profiler) {
+          const uint32_t period = now_us - last_us;
+          g_profiler->record(late_id,
+                             period > interval_us ? period - interval_us : 0);
+        }
+        last_us = now_us;
+
+        PerfScope scope(run_id);
+        fn();
+      });
+}
+
+#else  // !ENABLE_PIPELINE_PROFILER
+
+inline int perf_stage(const char*) { return -1; }
+inline int perf_loop_stage() { return -1; }
+
+class PerfScope {
+ public:
+  explicit PerfScope(int) {}
+};
+
+template <typename F>
+F perf_timed(const char*, F fn) {
+  return fn;
+}
+
+// Event-loop hook needs SensESP: target builds only (the native benchmark
+// env uses the pure headers)
+#ifdef ARDUINO
+#include "sensesp_app.h"
+
+using namespace sensesp;
+
+template <typename F>
+void perf_repeat(const char*, uint32_t interval_ms, F fn) {
+  sensesp_app->get_event_loop()->onRepeat(interval_ms, fn);
+}
+#endif
+
+#endif  // ENABLE_PIPELINE_PROFILER
@@ -0,0 +1,281 @@
+#pragma once
+
+// ============================================================================
+// PowerManager — engine-state driven sample rates and power saving
+// ============================================================================
+//
+// • Profile from the canonical smoothed rev/s of every engine
+//   (engine_running(), 500 RPM; any engine running → RUNNING):
+//     RUNNING     as soon as one running sample arrives (boot default)
+//     ENGINE_OFF  after ENGINE_OFF_DELAY_MS without one (no flapping at
+//                 idle / while stopping)
+// • RUNNING: build-time rates everywhere, CPU 240 MHz, WiFi modem sleep off
+//   (lowest alarm / websocket latency)
+// • ENGINE_OFF (boat at the dock for weeks, running off the house bank):
+//     ADC DMA scan in short bursts every ENGINE_OFF_ADC_BURST_PERIOD_MS
+//     OneWire conversions every ENGINE_OFF_ONEWIRE_DELAY_MS
+//     coolant / oil emitters at ENGINE_OFF_EMIT_MS (batcher keep-alives)
+//     event loop yields ENGINE_OFF_LOOP_IDLE_MS per pass (idle())
+//     CPU 80 MHz, WiFi max modem sleep
+//     with CONFIG_PM_ENABLE: frequency scaling, plus automatic light sleep
+//     between reads (needs CONFIG_FREERTOS_USE_TICKLESS_IDLE), woken by
+//     any RPM pickup GPIO; RUNNING holds CPU_FREQ_MAX / NO_LIGHT_SLEEP
+//     locks. If esp_pm_configure() rejects both, setCpuFrequencyMhz().
+// • GPIO wake is level triggered: each pickup pin is armed for the level
+//   opposite to the one the stopped flywheel left it at (re-armed on
+//   entering ENGINE_OFF and every poll)
+// • RPM sampling and the 1 Hz engine hours tick are never slowed — they
+//   are what detects the engine start
+// • Subsystems react via on_change(); periodic emitters use
+//   power_throttled()
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// Engine state tracking (no SensESP dependency)
+// ============================================================================
+enum PowerProfile : uint8_t {
+  POWER_RUNNING = 0,
+  POWER_ENGINE_OFF
+};
+
+class EngineStateTracker {
+ public:
+  explicit EngineStateTracker(uint32_t off_delay_ms, float running_rev_s)
+      : off_delay_ms_(off_delay_ms), running_rev_s_(running_rev_s) {}
+
+  // One rev/s sample (NaN = no pulses); true when the profile changed
+  bool update(float rev_s, uint32_t now_ms) {
+    if (!std::isnan(rev_s) && rev_s >= running_rev_s_) {
+      last_running_ms_ = now_ms;
+      seen_            = true;
+      return set(POWER_RUNNING);
+    }
+    return poll(now_ms);
+  }
+
+  // Time passing without samples; true when the profile changed
+  bool poll(uint32_t now_ms) {
+    if (!seen_) {
+      seen_            = true;   // boot: start the off timer now
+      last_running_ms_ = now_ms;
+    }
+    if (profile_ == POWER_RUNNING && (now_ms - last_running_ms_) >= off_delay_ms_) {
+      return set(POWER_ENGINE_OFF);
+    }
+    return false;
+  }
+
+  PowerProfile profile() const { return profile_; }
+
+ private:
+  uint32_t     off_delay_ms_;
+  float        running_rev_s_;
+  uint32_t     last_running_ms_ = 0;
+  bool         seen_            = false;
+  PowerProfile profile_         = POWER_RUNNING;
+
+  bool set(PowerProfile p) {
+    if (p == profile_) return false;
+    profile_ = p;
+    return true;
+  }
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <driver/gpio.h>
+#include <esp_log.h>
+#include <esp_sleep.h>
+#include <esp_wifi.h>
+
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+#include <functional>
+
+#include <sensesp/system/valueconsumer.h>
+#include <sensesp/ui/status_page_item.h>
+
+#include "sensesp_app.h"
+
+#include "engine_model.h"
+
+using namespace sensesp;
+
+// ----------------------------------------------------------------------------
+// Engine-off rates
+// ----------------------------------------------------------------------------
+static constexpr uint32_t ENGINE_OFF_DELAY_MS             = 120000;
+static constexpr uint32_t ENGINE_OFF_EMIT_MS              = 10000;
+static constexpr uint32_t ENGINE_OFF_ONEWIRE_DELAY_MS     = 30000;
+static constexpr uint32_t ENGINE_OFF_ADC_BURST_PERIOD_MS  = 10000;
+static constexpr uint32_t ENGINE_OFF_LOOP_IDLE_MS         = 20;
+
+class PowerManager : public ValueConsumer<float> {
+ public:
+  typedef std::function<void(PowerProfile)> Listener;
+
+  static constexpr size_t   MAX_LISTENERS       = 8;
+  static constexpr size_t   MAX_WAKE_PINS       = 2;     // one per engine
+  static constexpr uint32_t POLL_INTERVAL_MS    = 1000;
+  static constexpr uint32_t RUNNING_CPU_MHZ     = 240;
+  static constexpr uint32_t ENGINE_OFF_CPU_MHZ  = 80;    // WiFi minimum
+
+  PowerManager() : tracker_(ENGINE_OFF_DELAY_MS, ENGINE_RUNNING_RPM / 60.0f) {}
+
+  // RPM pickup input of one engine (before start())
+  void add_wake_pin(uint8_t pin) {
+    if (num_wake_pins_ < MAX_WAKE_PINS) {
+      wake_pins_[num_wake_pins_++] = pin;
+    }
+  }
+
+  // rev/s input (connect every engine's rev_s_smooth): a running sample
+  // from any engine holds RUNNING, the others' stopped samples don't count
+  void set(const float& rev_s) override {
+    if (tracker_.update(rev_s, millis())) apply();
+  }
+
+  // Called on every profile change (event loop)
+  void on_change(Listener l) {
+    if (num_listeners_ < MAX_LISTENERS) {
+      listeners_[num_listeners_++] = l;
+    } else {
+      ESP_LOGE("Power", "Listener table full");
+    }
+  }
+
+  PowerProfile profile() const { return tracker_.profile(); }
+  bool engine_off() const { return tracker_.profile() == POWER_ENGINE_OFF; }
+
+  // loop(): the event loop otherwise never lets the idle task run
+  void idle() const {
+    if (engine_off()) vTaskDelay(pdMS_TO_TICKS(ENGINE_OFF_LOOP_IDLE_MS));
+  }
+
+  // After every listener is registered
+  void start() {
+#if CONFIG_PM_ENABLE
+    // Boot profile: RUNNING
+    esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "engine_cpu", &cpu_max_lock_);
+    esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "engine", &no_sleep_lock_);
+    if (cpu_max_lock_)  esp_pm_lock_acquire(cpu_max_lock_);
+    if (no_sleep_lock_) esp_pm_lock_acquire(no_sleep_lock_);
+
+    esp_pm_config_esp32_t pm = {};
+    pm.max_freq_mhz       = RUNNING_CPU_MHZ;
+    pm.min_freq_mhz       = ENGINE_OFF_CPU_MHZ;
+    pm.light_sleep_enable = true;
+    if (esp_pm_configure(&pm) == ESP_OK) {
+      pm_active_   = true;
+      light_sleep_ = true;
+    } else {
+      // No tickless idle in the SDK: frequency scaling only
+      pm.light_sleep_enable = false;
+      pm_active_ = (esp_pm_configure(&pm) == ESP_OK);
+      ESP_LOGW("Power", "No light sleep%s",
+               pm_active_ ? "" : ", esp_pm_configure failed (setCpuFrequencyMhz)");
+    }
+
+    if (light_sleep_) {
+      // First tooth after a stop wakes the chip from light sleep
+      arm_wake_pins();
+      esp_sleep_enable_gpio_wakeup();
+    }
+#endif
+
+    ui_profile_ = new StatusPageItem<String>("Profile", name(profile()), "Power", 0);
+
+    sensesp_app->get_event_loop()->onRepeat(
+        POLL_INTERVAL_MS,
+        [this]() {
+          if (tracker_.poll(millis())) {
+            this->apply();
+          } else if (engine_off()) {
+            arm_wake_pins();   // flywheel may have settled since
+          }
+        });
+  }
+
+ private:
+  EngineStateTracker      tracker_;
+  uint8_t                 wake_pins_[MAX_WAKE_PINS] = {};
+  size_t                  num_wake_pins_ = 0;
+  Listener                listeners_[MAX_LISTENERS];
+  size_t                  num_listeners_ = 0;
+  StatusPageItem<String>* ui_profile_    = nullptr;
+  bool                    pm_active_     = false;   // esp_pm owns the CPU clock
+  bool                    light_sleep_   = false;
+#if CONFIG_PM_ENABLE
+  esp_pm_lock_handle_t    cpu_max_lock_  = nullptr;
+  esp_pm_lock_handle_t    no_sleep_lock_ = nullptr;
+#endif
+
+  // Level-triggered wake: arm for the level the pin is NOT at now, so a
+  // pickup resting HIGH does not wake the chip straight back up
+  void arm_wake_pins() {
+    if (!light_sleep_) return;
+    for (size_t i = 0; i < num_wake_pins_; i++) {
+      const gpio_num_t pin = static_cast<gpio_num_t>(wake_pins_[i]);
+      gpio_wakeup_enable(pin, gpio_get_level(pin) ? GPIO_INTR_LOW_LEVEL
+                                                  : GPIO_INTR_HIGH_LEVEL);
+    }
+  }
+
+  static const char* name(PowerProfile p) {
+    return (p == POWER_RUNNING) ? "Running" : "Engine off";
+  }
+
+  void apply() {
+    const PowerProfile p = tracker_.profile();
+    const bool running = (p == POWER_RUNNING);
+
+    ESP_LOGI("Power", "Profile: %s", name(p));
+
+#if CONFIG_PM_ENABLE
+    // DFS between max/min: max + no light sleep only while the locks are held
+    if (pm_active_) {
+      if (running) {
+        if (cpu_max_lock_)  esp_pm_lock_acquire(cpu_max_lock_);
+        if (no_sleep_lock_) esp_pm_lock_acquire(no_sleep_lock_);
+      } else {
+        arm_wake_pins();
+        if (no_sleep_lock_) esp_pm_lock_release(no_sleep_lock_);
+        if (cpu_max_lock_)  esp_pm_lock_release(cpu_max_lock_);
+      }
+    }
+#endif
+    if (!pm_active_) {
+      setCpuFrequencyMhz(running ? RUNNING_CPU_MHZ : ENGINE_OFF_CPU_MHZ);
+    }
+
+    esp_wifi_set_ps(running ? WIFI_PS_NONE : WIFI_PS_MAX_MODEM);
+
+    for (size_t i = 0; i < num_listeners_; i++) {
+      listeners_[i](p);
+    }
+
+    if (ui_profile_) ui_profile_->set(name(p));
+  }
+};
+
+extern PowerManager* g_power;   // main.cpp (nullptr unless ENABLE_POWER_SAVE)
+
+// Periodic emitters: true → skip this call (engine off, not yet due)
+inline bool power_throttled(uint32_t& last_ms, uint32_t engine_off_interval_ms) {
+  const uint32_t now = millis();
+  if (g_power && g_power->engine_off() &&
+      (now - last_ms) < engine_off_interval_ms) {
+    return true;
+  }
+  last_ms = now;
+  return false;
+}
+
+#endif  // ARDUINO
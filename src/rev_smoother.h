@@ -0,0 +1,48 @@
+#pragma once
+
+// ============================================================================
+// RevSmoother<N> — canonical engine speed filter (rev/s)
+// ============================================================================
+//
+// • Time-windowed mean of valid samples (SlidingWindowAverage<N>)
+// • Samples ≤ 0.1 rev/s or NaN are not averaged (engine stopped / glitch)
+// • No valid sample for stall_timeout_ms → window cleared → NaN, so
+//   downstream logic can fault/idle without flapping on short gaps
+// • Free of SensESP/Arduino (time is passed in) so the exact pipeline code
+//   runs in unit tests and in the native benchmarks
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "sliding_window_average.h"
+
+template <size_t N>
+class RevSmoother {
+ public:
+  RevSmoother(uint32_t window_ms, uint32_t stall_timeout_ms)
+      : buf_(window_ms), stall_timeout_ms_(stall_timeout_ms) {}
+
+  // One raw rev/s sample → smoothed rev/s (NaN when empty)
+  float update(float rps, uint32_t now_ms) {
+    if (!std::isnan(rps) && rps > 0.1f) {
+      buf_.push(rps, now_ms);
+      last_sample_ms_ = now_ms;
+    }
+
+    buf_.evict(now_ms);
+
+    if (!buf_.empty() && last_sample_ms_ != 0 &&
+        (now_ms - last_sample_ms_) > stall_timeout_ms_) {
+      buf_.clear();
+    }
+
+    return buf_.mean();
+  }
+
+ private:
+  SlidingWindowAverage<N> buf_;
+  uint32_t                stall_timeout_ms_;
+  uint32_t                last_sample_ms_ = 0;
+};
@@ -10,117 +10,124 @@
 // • This signal MUST be smoothed and free of transient 0 / NAN
 // • engine_hours and engine_performance MUST consume this signal
 //
-// Raw Frequency output is NOT suitable for engine logic.
+// Raw PCNT output is NOT suitable for engine logic.
 //
-// Signal map produced here:
-//   g_frequency             → rev/s (raw, diagnostic only)
-//   g_engine_rev_s_smooth   → rev/s (SMOOTHED, CANONICAL)
-//   g_engine_rad_s          → rad/s (DERIVED, INTERNAL ONLY)
+// Signal map produced here (members of the EngineInstance):
+//   frequency      → rev/s (raw PCNT count, diagnostic only)
+//   rev_s_smooth   → rev/s (SMOOTHED, CANONICAL)
+//   rad_s          → rad/s (DERIVED, INTERNAL ONLY)
+//
+// Measurement modes (UI: "RPM Measurement Mode"):
+//   • PCNT window count (default) — 1 s smoothing window
+//   • Period / input capture      — 10–20 Hz, 200 ms smoothing window,
+//                                   PCNT count used below fallback RPM
+//
+// One pickup per engine: PCNT_UNIT_<index> / MCPWM_UNIT_<index>.
 //
 // NOTE:
-// Signal K propulsion.engine.revolutions MUST be published in Hz (rev/s).
-// Conversion to rad/s is handled downstream (SK → NMEA2000 PGN 127488).
+// Signal K propulsion.<id>.revolutions MUST be published in Hz (rev/s).
+// Conversion to rad/s is handled downstream (SK → NMEA2000 PGN 127488),
+// or on-board when the direct N2K output (n2k_engine_output.h) is enabled.
 // ============================================================================
 
 #include <cmath>
-#include <deque>
 
-#include <sensesp/sensors/digital_input.h>
-#include <sensesp/transforms/frequency.h>
 #include <sensesp/transforms/lambda_transform.h>
 #include <sensesp/signalk/signalk_output.h>
 #include <sensesp/ui/config_item.h>
 
+#include "boot_stage.h"
+#include "data_logger.h"
+#include "engine_instance.h"
+#include "n2k_engine_output.h"
+#include "pcnt_rpm_sensor.h"
+#include "period_rpm_sensor.h"
+#include "pipeline_profiler.h"
+#include "rev_smoother.h"
+#include "sk_output_batcher.h"
+#include "sk_replay.h"
+
 using namespace sensesp;
 
 // -----------------------------------------------------------------------------
 // Externals provided by main.cpp
 // -----------------------------------------------------------------------------
-extern const uint8_t PIN_RPM;
-extern const float   RPM_TEETH;
-
-// Shared signals (defined in main.cpp)
-extern Frequency*            g_frequency;           // rev/s (raw)
-extern ValueProducer<float>* g_engine_rev_s_smooth; // rev/s (CANONICAL)
-extern ValueProducer<float>* g_engine_rad_s;        // rad/s (derived)
+extern AcquisitionTask*      g_acquisition;         // sampling task
+extern SkOutputBatcher*      g_sk_batcher;          // SK emission
 
 // -----------------------------------------------------------------------------
 // RPM smoothing parameters
 // -----------------------------------------------------------------------------
 static constexpr uint32_t RPM_AVG_WINDOW_MS = 1000;
+static constexpr uint32_t RPM_PERIOD_AVG_WINDOW_MS = 200;  // period mode: already averaged over N teeth
 static constexpr uint32_t RPM_STALL_TIMEOUT_MS = 4000;  // allow short gaps before dropping to NAN
-
-struct RpmSample {
-  float    rps;
-  uint32_t t_ms;
-};
+static constexpr size_t   RPM_AVG_CAPACITY = 32;        // ≥ samples per window at 20 Hz
+static constexpr float    RPM_SK_DEADBAND_REV_S = 0.05f;  // 3 RPM
 
 // -----------------------------------------------------------------------------
 // RPM sensor setup
 // -----------------------------------------------------------------------------
-inline void setup_rpm_sensor() {
+inline void setup_rpm_sensor(EngineInstance& e) {
 
-  // ---------------------------------------------------------------------------
-  // 1. Pulse counter
-  // ---------------------------------------------------------------------------
-  auto* pulse_input = new DigitalInputCounter(
-      PIN_RPM,
-      INPUT,
-      RISING,
-      0
-  );
+  const EngineConfig& cfg = e.config();
 
   // ---------------------------------------------------------------------------
-  // 2. Pulses/sec → rev/s (RAW, UNSAFE)
+  // 1+2. Hardware pulse counter (PCNT) → rev/s (RAW, UNSAFE)
   // ---------------------------------------------------------------------------
-  g_frequency = pulse_input->connect_to(
-      new Frequency(
-          1.0f / RPM_TEETH,
-          "/config/sensors/rpm/frequency"
-      )
+  auto* pulse_counter = new PcntRpmSensor(
+      cfg.pin_rpm,
+      cfg.rpm_teeth,
+      e.pcnt_unit(),
+      e.config_path("/config/sensors/rpm/pcnt")
   );
+  pulse_counter->enable(g_acquisition);
+
+  ConfigItem(pulse_counter)
+      ->set_title(e.ui_title("RPM Pulse Counter (PCNT)"))
+      ->set_description("Hardware tooth counter window and glitch filter");
 
   // ---------------------------------------------------------------------------
-  // 3. Sliding-window smoothing on rev/s (CANONICAL ENGINE SPEED)
+  // 2b. Optional period (input-capture) mode — selected in the UI
   // ---------------------------------------------------------------------------
-  static std::deque<RpmSample> rpm_buf;
-
-  g_engine_rev_s_smooth = g_frequency->connect_to(
-      new LambdaTransform<float,float>(
-          [](float rps) {
-            static uint32_t last_sample_ms = 0;
-            const uint32_t now = millis();
+  auto* period_sensor = new PeriodRpmSensor(
+      cfg.pin_rpm,
+      cfg.rpm_teeth,
+      pulse_counter,
+      e.mcpwm_unit(),
+      e.config_path("/config/sensors/rpm/period")
+  );
 
-            if (!std::isnan(rps) && rps > 0.1f) {
-              rpm_buf.push_back({rps, now});
-              last_sample_ms = now;
-            }
+  ConfigItem(period_sensor)
+      ->set_title(e.ui_title("RPM Measurement Mode"))
+      ->set_description(
+          "Period mode updates at 10–20 Hz from tooth timing; "
+          "PCNT counting is used below the fallback speed");
 
-            while (!rpm_buf.empty() &&
-                   (now - rpm_buf.front().t_ms) > RPM_AVG_WINDOW_MS) {
-              rpm_buf.pop_front();
-            }
+  const bool period_mode = period_sensor->period_mode();
 
-            // If we've gone longer than the smoothing window without any new
-            // valid pulses, drop to NAN (after a grace period) so downstream
-            // logic can fault/idle without flapping.
-            if (!rpm_buf.empty() && last_sample_ms != 0 &&
-                (now - last_sample_ms) > RPM_STALL_TIMEOUT_MS) {
-              rpm_buf.clear();
-            }
+  if (period_mode) {
+    period_sensor->enable(g_acquisition);
+    e.frequency = period_sensor;
+  } else {
+    e.frequency = pulse_counter;
+  }
 
-            if (rpm_buf.empty()) {
-              return NAN;
-            }
+  const uint32_t avg_window_ms =
+      period_mode ? RPM_PERIOD_AVG_WINDOW_MS : RPM_AVG_WINDOW_MS;
 
-            float sum = 0.0f;
-            for (const auto& s : rpm_buf) {
-              sum += s.rps;
-            }
+  // ---------------------------------------------------------------------------
+  // 3. Sliding-window smoothing on rev/s (CANONICAL ENGINE SPEED)
+  // ---------------------------------------------------------------------------
+  // Short gaps are held; no valid pulse for RPM_STALL_TIMEOUT_MS → NAN
+  auto* smoother = new RevSmoother<RPM_AVG_CAPACITY>(avg_window_ms,
+                                                     RPM_STALL_TIMEOUT_MS);
 
-            return sum / rpm_buf.size();
-          },
-          "/config/sensors/rpm/rev_per_sec_smooth"
+  e.rev_s_smooth = e.frequency->connect_to(
+      new LambdaTransform<float,float>(
+          perf_timed(e.perf_name("rpm_smooth"), [smoother](float rps) -> float {
+            return smoother->update(rps, millis());  // NAN when empty
+          }),
+          e.config_path("/config/sensors/rpm/rev_per_sec_smooth")
       )
   );
 
@@ -129,55 +136,66 @@ inline void setup_rpm_sensor() {
   // ---------------------------------------------------------------------------
   constexpr float PI_F = 3.14159265f;
 
-  g_engine_rad_s = g_engine_rev_s_smooth->connect_to(
+  e.rad_s = e.rev_s_smooth->connect_to(
       new LambdaTransform<float,float>(
           [](float rps) {
             return std::isnan(rps) ? NAN : (rps * 2.0f * PI_F);
           },
-          "/config/sensors/rpm/rad_per_sec_smooth"
+          e.config_path("/config/sensors/rpm/rad_per_sec_smooth")
       )
   );
 
 #if ENABLE_DEBUG_OUTPUTS
   // ---------------------------------------------------------------------------
-  // Debug outputs (explicit units)
+  // Debug outputs (explicit units, deferred boot stage)
   // ---------------------------------------------------------------------------
-  g_frequency->connect_to(
-      new SKOutputFloat("debug.engine.revolutions_hz_raw")
-  );
-
-  g_engine_rev_s_smooth->connect_to(
-      new SKOutputFloat("debug.engine.revolutions_hz")
-  );
-
-  g_engine_rad_s->connect_to(
-      new SKOutputFloat("debug.engine.revolutions_rad_s")
-  );
-
-  g_engine_rev_s_smooth->connect_to(
-      new LambdaTransform<float,float>([](float rps){
-        return std::isnan(rps) ? NAN : (rps * 60.0f);
-      })
-  )->connect_to(
-      new SKOutputFloat("debug.engine.rpm")
-  );
+  boot_defer("rpm debug", [&e]() {
+    e.frequency->connect_to(batched(
+        g_sk_batcher,
+        new SKOutputFloat(e.debug_path("engine.revolutions_hz_raw")),
+        SK_DEBUG_MIN_INTERVAL_MS
+    ));
+
+    e.rev_s_smooth->connect_to(batched(
+        g_sk_batcher,
+        new SKOutputFloat(e.debug_path("engine.revolutions_hz")),
+        SK_DEBUG_MIN_INTERVAL_MS
+    ));
+
+    e.rad_s->connect_to(batched(
+        g_sk_batcher,
+        new SKOutputFloat(e.debug_path("engine.revolutions_rad_s")),
+        SK_DEBUG_MIN_INTERVAL_MS
+    ));
+
+    e.rev_s_smooth->connect_to(
+        new LambdaTransform<float,float>([](float rps){
+          return std::isnan(rps) ? NAN : (rps * 60.0f);
+        })
+    )->connect_to(batched(
+        g_sk_batcher,
+        new SKOutputFloat(e.debug_path("engine.rpm")),
+        SK_DEBUG_MIN_INTERVAL_MS
+    ));
+  });
 #endif
 
   // ---------------------------------------------------------------------------
   // 5. Signal K output (Hz / rev/s — NOT rad/s)
   // ---------------------------------------------------------------------------
   auto* sk_revs = new SKOutputFloat(
-      "propulsion.engine.revolutions",
-      "/config/outputs/sk/revolutions"
+      e.sk_path("revolutions"),
+      e.config_path("/config/outputs/sk/revolutions")
   );
 
   // Hold last good RPM during short NaN gaps so SK/N2K instruments don't blank
-  auto* rpm_latched = g_engine_rev_s_smooth->connect_to(
+  float    last_good_rps = NAN;
+  uint32_t last_good_ms  = 0;
+
+  auto* rpm_latched = e.rev_s_smooth->connect_to(
       new LambdaTransform<float,float>(
-          [](float rps) {
-            static float    last_good_rps = NAN;
-            static uint32_t last_good_ms  = 0;
-            const uint32_t  now           = millis();
+          [last_good_rps, last_good_ms](float rps) mutable -> float {
+            const uint32_t now = millis();
 
             if (std::isfinite(rps)) {
               last_good_rps = (rps < 0.0f) ? 0.0f : rps;
@@ -197,12 +215,27 @@ inline void setup_rpm_sensor() {
   );
 
   // Signal K expects Hz (rev/s)
-  rpm_latched->connect_to(sk_revs);
+  rpm_latched->connect_to(batched(g_sk_batcher, sk_revs, 0, RPM_SK_DEADBAND_REV_S));
+
+  // Direct NMEA 2000 PGN 127488 (rev/s → rpm in the encoder)
+  if (e.n2k) {
+    rpm_latched->connect_to(e.n2k->revolutions());
+  }
+
+  // On-device log: canonical smoothed rev/s (NaN = stopped / no signal)
+  if (e.datalog()) {
+    e.rev_s_smooth->connect_to(e.datalog()->revolutions());
+  }
+
+  // Outage replay (from the log) on the same, UI-editable path
+  if (e.sk_replay()) {
+    e.sk_replay()->bind(REPLAY_REVOLUTIONS, sk_revs);
+  }
 
   ConfigItem(sk_revs)
-      ->set_title("Engine Revolutions (Hz)")
+      ->set_title(e.ui_title("Engine Revolutions (Hz)"))
       ->set_description(
-          "Smoothed propulsion.engine.revolutions in Hz (rev/s). "
+          "Smoothed propulsion.<id>.revolutions in Hz (rev/s). "
           "Converted to rad/s downstream for NMEA 2000 PGN 127488."
       );
 }
@@ -0,0 +1,70 @@
+#pragma once
+
+// ============================================================================
+// Sender curves — ADC-pin volts → engineering units (no SensESP pipeline)
+// ============================================================================
+//
+// • Coolant: measured gauge-sender voltages (DFR0051 5:1 divider) → °C
+// • Oil pressure: 0.5–4.5 V / 0–100 psi transducer behind a 1:2 divider → Pa
+// • Shared by the sender pipelines (coolant_temp.h, oil_pressure.h, raw-code
+//   LUTs) and the bench simulator (engine_simulator.h, FlatCurve::inverse),
+//   so simulated sender voltages read back as exactly the commanded values
+// ============================================================================
+
+#include "flat_curve.h"
+
+// -----------------------------------------------------------------------------
+// Coolant: ADC validity domain (used only to qualify updates)
+// -----------------------------------------------------------------------------
+constexpr float ADC_MIN_VALID_V = 0.257f;   // ≈121 °C
+constexpr float ADC_MAX_VALID_V = 1.392f;   // ≈10 °C
+
+// -----------------------------------------------------------------------------
+// ADC volts → temperature (°C), constexpr table in flash
+// -----------------------------------------------------------------------------
+static constexpr CurvePoint kCoolantAdcToTempC[] = {
+
+    { 0.257f, 121.0f },   // 250 °F, ~30 Ω
+
+    { 0.762f,  80.6f },   // 177 °F
+    { 0.766f,  80.0f },   // 176 °F
+    { 0.786f,  79.4f },   // 175 °F
+    { 0.814f,  78.3f },   // 173 °F
+    { 0.843f,  76.7f },   // 170 °F
+    { 0.898f,  71.1f },   // 160 °F
+    { 0.925f,  67.8f },   // 154 °F
+    { 0.941f,  66.7f },   // 152 °F
+    { 0.943f,  66.1f },   // 151 °F
+    { 1.040f,  60.0f },   // 140 °F
+    { 1.136f,  52.2f },   // 126 °F
+    { 1.212f,  48.9f },   // 120 °F
+    { 1.309f,  40.6f },   // 105 °F
+    { 1.392f,  10.0f }    // 50 °F
+};
+
+static_assert(flat_curve_sorted(kCoolantAdcToTempC),
+              "coolant curve must be sorted by ADC volts");
+
+static constexpr FlatCurve coolant_adc_to_temp(kCoolantAdcToTempC);
+
+// -----------------------------------------------------------------------------
+// Oil pressure transducer
+// -----------------------------------------------------------------------------
+static constexpr float DIVIDER_RATIO  = 0.5f;
+
+static constexpr float SENSOR_V_MIN   = 0.5f;
+static constexpr float SENSOR_V_MAX   = 4.5f;
+static constexpr float SENSOR_PSI_MAX = 100.0f;
+
+// -----------------------------------------------------------------------------
+// ADC-pin volts → Pa (linear transducer; clamped below V_MIN, held above V_MAX)
+// -----------------------------------------------------------------------------
+static constexpr CurvePoint kOilAdcToPa[] = {
+    { SENSOR_V_MIN * DIVIDER_RATIO, 0.0f },
+    { SENSOR_V_MAX * DIVIDER_RATIO, SENSOR_PSI_MAX * 6894.757f }
+};
+
+static_assert(flat_curve_sorted(kOilAdcToPa),
+              "oil pressure curve must be sorted by ADC volts");
+
+static constexpr FlatCurve oil_adc_to_pa(kOilAdcToPa);
@@ -0,0 +1,218 @@
+#pragma once
+
+// ============================================================================
+// SkDeltaWriter — pre-serialized Signal K delta templates
+// ============================================================================
+//
+// • Every path's JSON value object is formatted ONCE at setup:
+//       {"path":"propulsion.engine.load","value":              }
+//   with a fixed-width, space-padded numeric slot
+// • The delta header keeps a fixed-width timestamp member; when the clock is
+//   not set the whole member is blanked with spaces (still valid JSON)
+// • A path edited in the UI is detected with has_path(); the owner then
+//   rebuilds its templates (clear_paths() + add_path())
+// • Per emit: memcpy the templates into one static buffer, patch the value
+//   slots and the timestamp with snprintf — no ArduinoJson document, no
+//   String concatenation, no heap allocation
+// ============================================================================
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+class SkDeltaWriter {
+ public:
+  static constexpr size_t MAX_ENTRIES = 64;     // two engines + board sensors
+  static constexpr size_t POOL_BYTES  = 4096;   // all entry templates
+  static constexpr size_t BUF_BYTES   = 2048;   // one assembled delta
+  static constexpr size_t VALUE_WIDTH = 14;     // "%14.6g" / "null" padded
+
+  // -------------------------------------------------------------------------
+  // Setup: header with source label (call once)
+  // -------------------------------------------------------------------------
+  bool begin(const char* source_label) {
+    const int n = snprintf(header_, sizeof(header_),
+                           "{\"updates\":[{\"source\":{\"label\":\"%s\"},"
+                           "%*s\"values\":[",
+                           source_label, static_cast<int>(TS_MEMBER_LEN), "");
+    if (n <= 0 || static_cast<size_t>(n) >= sizeof(header_)) {
+      header_len_ = 0;
+      return false;
+    }
+
+    header_len_ = static_cast<size_t>(n);
+    ts_offset_  = header_len_ - TS_MEMBER_LEN - strlen("\"values\":[");
+    return true;
+  }
+
+  // -------------------------------------------------------------------------
+  // Setup: preformat one path → entry id (or -1)
+  // -------------------------------------------------------------------------
+  int add_path(const char* path) {
+    if (num_entries_ >= MAX_ENTRIES) {
+      return -1;
+    }
+
+    char* dst = pool_ + pool_used_;
+    const size_t room = POOL_BYTES - pool_used_;
+    const int n = snprintf(dst, room, "{\"path\":\"%s\",\"value\":%*s}",
+                           path, static_cast<int>(VALUE_WIDTH), "");
+    if (n <= 0 || static_cast<size_t>(n) >= room) {
+      return -1;
+    }
+
+    Entry& e = entries_[num_entries_];
+    e.offset = pool_used_;
+    e.len    = static_cast<size_t>(n);
+    pool_used_ += e.len;
+    return static_cast<int>(num_entries_++);
+  }
+
+  // True when entry `id` was formatted from `path` (UI path edits)
+  bool has_path(int id, const char* path) const {
+    if (id < 0 || static_cast<size_t>(id) >= num_entries_) {
+      return false;
+    }
+
+    const Entry& e    = entries_[id];
+    const size_t plen = strlen(path);
+    if (PATH_OFFSET + plen >= e.len) {
+      return false;
+    }
+
+    const char* p = pool_ + e.offset + PATH_OFFSET;
+    return memcmp(p, path, plen) == 0 && p[plen] == '"';
+  }
+
+  // Drop every entry; add_path() hands out ids from 0 again
+  void clear_paths() {
+    num_entries_ = 0;
+    pool_used_   = 0;
+  }
+
+  // -------------------------------------------------------------------------
+  // Per emit
+  // -------------------------------------------------------------------------
+  void start() {
+    len_   = 0;
+    count_ = 0;
+    if (header_len_ == 0) return;
+
+    memcpy(buf_, header_, header_len_);
+    len_ = header_len_;
+  }
+
+  bool append(int id, float value) {
+    if (header_len_ == 0 || id < 0 || static_cast<size_t>(id) >= num_entries_) {
+      return false;
+    }
+
+    const Entry& e = entries_[id];
+    const size_t need = e.len + (count_ ? 1 : 0);
+    if (len_ + need + FOOTER_LEN + 1 > BUF_BYTES) {
+      return false;  // full — caller sends and starts again
+    }
+
+    if (count_) buf_[len_++] = ',';
+
+    char* entry = buf_ + len_;
+    memcpy(entry, pool_ + e.offset, e.len);
+    len_ += e.len;
+    count_++;
+
+    write_value(entry + e.len - 1 - VALUE_WIDTH, value);
+    return true;
+  }
+
+  // Patch timestamp, close the delta; returns the NUL-terminated frame
+  const char* finish(time_t now_s, unsigned millis_part) {
+    if (header_len_ == 0) {
+      buf_[0] = '\0';
+      return buf_;
+    }
+
+    write_timestamp(buf_ + ts_offset_, now_s, millis_part);
+
+    memcpy(buf_ + len_, "]}]}", FOOTER_LEN);
+    len_ += FOOTER_LEN;
+    buf_[len_] = '\0';
+    return buf_;
+  }
+
+  size_t count() const  { return count_; }
+  size_t length() const { return len_; }
+  size_t entries() const { return num_entries_; }
+
+ private:
+  // "timestamp":"2024-01-01T00:00:00.000Z",
+  static constexpr size_t TS_MEMBER_LEN  = 39;
+  static constexpr size_t FOOTER_LEN     = 4;            // "]}]}"
+  static constexpr size_t PATH_OFFSET    = 9;            // {"path":"
+  static constexpr time_t MIN_VALID_TIME = 1577836800;   // 2020-01-01
+
+  struct Entry {
+    size_t offset = 0;
+    size_t len    = 0;
+  };
+
+  char   header_[160] = {};
+  size_t header_len_  = 0;
+  size_t ts_offset_   = 0;
+
+  char   pool_[POOL_BYTES] = {};
+  size_t pool_used_        = 0;
+  Entry  entries_[MAX_ENTRIES];
+  size_t num_entries_      = 0;
+
+  char   buf_[BUF_BYTES + 1] = {};
+  size_t len_   = 0;
+  size_t count_ = 0;
+
+  // Fixed-width, right-aligned, space padded; NaN/Inf → null
+  static void write_value(char* slot, float value) {
+    char tmp[VALUE_WIDTH + 8];
+    int n;
+
+    if (std::isfinite(value)) {
+      n = snprintf(tmp, sizeof(tmp), "%*.6g",
+                   static_cast<int>(VALUE_WIDTH), static_cast<double>(value));
+    } else {
+      n = snprintf(tmp, sizeof(tmp), "%*s",
+                   static_cast<int>(VALUE_WIDTH), "null");
+    }
+
+    if (n != static_cast<int>(VALUE_WIDTH)) {
+      // Cannot happen for %.6g floats; keep the frame valid regardless
+      memset(slot, ' ', VALUE_WIDTH);
+      memcpy(slot + VALUE_WIDTH - 4, "null", 4);
+      return;
+    }
+
+    memcpy(slot, tmp, VALUE_WIDTH);
+  }
+
+  // Valid clock → "timestamp":"…Z",   otherwise blank (whitespace)
+  static void write_timestamp(char* slot, time_t now_s, unsigned ms) {
+    if (now_s < MIN_VALID_TIME) {
+      memset(slot, ' ', TS_MEMBER_LEN);
+      return;
+    }
+
+    struct tm t;
+    gmtime_r(&now_s, &t);
+
+    char tmp[TS_MEMBER_LEN + 8];
+    const int n = snprintf(tmp, sizeof(tmp),
+                           "\"timestamp\":\"%04d-%02d-%02dT%02d:%02d:%02d.%03uZ\",",
+                           t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+                           t.tm_hour, t.tm_min, t.tm_sec, ms % 1000);
+
+    if (n != static_cast<int>(TS_MEMBER_LEN)) {
+      memset(slot, ' ', TS_MEMBER_LEN);
+      return;
+    }
+
+    memcpy(slot, tmp, TS_MEMBER_LEN);
+  }
+};
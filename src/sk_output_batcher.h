@@ -0,0 +1,272 @@
+#pragma once
+
+// ============================================================================
+// SkOutputBatcher — rate-limited, deadbanded Signal K emission
+// ============================================================================
+//
+// • Producers connect to a batcher slot instead of directly to SKOutputFloat
+// • Slots only store the latest value; nothing is serialized on input
+// • One tick (default 5 Hz) writes every due slot into ONE multi-value
+//   delta, assembled from pre-serialized templates (SkDeltaWriter) in a
+//   static buffer and sent straight to the websocket — no ArduinoJson, no
+//   per-emit heap allocation. While disconnected, slots fall back to their
+//   SKOutputFloat (SensESP's own delta queue) — except outputs the outage
+//   replay resends from the data log: SensESP would flush its queue with
+//   "now" stamps on reconnect and duplicate the replayed interval
+// • Per slot:
+//     min_interval_ms — never sent more often than this
+//     deadband        — change (vs. last SENT value) needed to send
+//     keep-alive      — unchanged values are re-sent every keepalive_ms
+// • SKOutputFloat objects (and their UI-editable paths) are unchanged; a
+//   path edited in the UI is picked up on the next tick (templates rebuilt)
+// ============================================================================
+
+#include <Arduino.h>
+#include <cmath>
+
+#include <sys/time.h>
+
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/system/valueconsumer.h>
+
+#include "sensesp_app.h"
+
+#include "sk_delta_writer.h"
+
+using namespace sensesp;
+
+// Debug paths: low rate, no deadband (diagnostics want every change)
+static constexpr uint32_t SK_DEBUG_MIN_INTERVAL_MS = 1000;
+
+// ============================================================================
+// DeadbandGate — send decision for one path (no SensESP dependency)
+// ============================================================================
+struct DeadbandGate {
+  uint32_t min_interval_ms = 0;
+  float    deadband        = 0.0f;
+
+  bool     sent         = false;
+  float    last_sent    = NAN;
+  uint32_t last_sent_ms = 0;
+
+  // Minimum interval elapsed (or never sent) → worth evaluating
+  bool due(uint32_t now_ms) const {
+    return !sent || (now_ms - last_sent_ms) >= min_interval_ms;
+  }
+
+  // pending: a new input arrived since the last evaluation
+  bool should_send(bool pending, float value,
+                   uint32_t now_ms, uint32_t keepalive_ms) const {
+    if (!sent) {
+      return pending;
+    }
+
+    if (!due(now_ms)) {
+      return false;
+    }
+
+    if (keepalive_ms > 0 && (now_ms - last_sent_ms) >= keepalive_ms) {
+      return true;
+    }
+
+    if (!pending) {
+      return false;
+    }
+
+    if (std::isnan(value) || std::isnan(last_sent)) {
+      return std::isnan(value) != std::isnan(last_sent);
+    }
+
+    return std::fabs(value - last_sent) > deadband;
+  }
+
+  void mark_sent(float value, uint32_t now_ms) {
+    sent         = true;
+    last_sent    = value;
+    last_sent_ms = now_ms;
+  }
+};
+
+// Where a due value goes
+enum SkSendRoute {
+  SK_ROUTE_DIRECT,   // pre-serialized delta, straight to the websocket
+  SK_ROUTE_OUTPUT,   // SKOutputFloat::set() (SensESP's delta queue)
+  SK_ROUTE_DROP,     // offline, resent by SkReplay with its original time
+};
+
+inline SkSendRoute sk_send_route(bool connected, bool has_template,
+                                 bool replayed) {
+  if (!connected) return replayed ? SK_ROUTE_DROP : SK_ROUTE_OUTPUT;
+  return has_template ? SK_ROUTE_DIRECT : SK_ROUTE_OUTPUT;
+}
+
+// ============================================================================
+// Batcher
+// ============================================================================
+class SkOutputBatcher {
+ public:
+  static constexpr size_t   MAX_SLOTS            = 64;      // = SkDeltaWriter::MAX_ENTRIES
+  static constexpr uint32_t DEFAULT_TICK_MS      = 200;     // 5 Hz
+  static constexpr uint32_t DEFAULT_KEEPALIVE_MS = 10000;
+
+  class Slot : public ValueConsumer<float> {
+   public:
+    void set(const float& value) override {
+      value_   = value;
+      pending_ = true;
+    }
+
+   private:
+    friend class SkOutputBatcher;
+
+    SKOutputFloat* output_      = nullptr;
+    int            template_id_ = -1;
+    DeadbandGate   gate_;
+    float          value_    = NAN;
+    bool           pending_  = false;
+    bool           replayed_ = false;
+  };
+
+  explicit SkOutputBatcher(uint32_t tick_ms = DEFAULT_TICK_MS,
+                           uint32_t keepalive_ms = DEFAULT_KEEPALIVE_MS)
+      : keepalive_ms_(keepalive_ms) {
+    writer_.begin(sensesp_app->get_hostname().c_str());
+    payload_.reserve(SkDeltaWriter::BUF_BYTES);   // only heap use, once
+
+    sensesp_app->get_event_loop()->onRepeat(
+        tick_ms,
+        [this]() { this->tick(); });
+  }
+
+  // -------------------------------------------------------------------------
+  // Route an output through the batcher; connect producers to the result.
+  // Returns nullptr when full (use batched() for automatic fallback).
+  // -------------------------------------------------------------------------
+  ValueConsumer<float>* add(SKOutputFloat* output,
+                            uint32_t min_interval_ms = 0,
+                            float deadband = 0.0f) {
+    if (num_slots_ >= MAX_SLOTS) {
+      ESP_LOGE("SkBatch", "Batcher full, %s sent directly",
+               output->get_sk_path().c_str());
+      return nullptr;
+    }
+
+    Slot& s                 = slots_[num_slots_++];
+    s.output_               = output;
+    s.template_id_          = writer_.add_path(output->get_sk_path().c_str());
+    s.gate_.min_interval_ms = min_interval_ms;
+    s.gate_.deadband        = deadband;
+    return &s;
+  }
+
+  // Once the replay is running: `output` is not queued while disconnected
+  // (the data log covers it). False when it is not routed through a slot.
+  bool set_replayed(const SKOutputFloat* output) {
+    for (size_t i = 0; i < num_slots_; i++) {
+      if (slots_[i].output_ == output) {
+        slots_[i].replayed_ = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  uint32_t      keepalive_ms_;
+  Slot          slots_[MAX_SLOTS];
+  size_t        num_slots_ = 0;
+  SkDeltaWriter writer_;
+  String        payload_;
+
+  void tick() {
+    const uint32_t now = millis();
+
+    auto ws = sensesp_app->get_ws_client();
+    const bool direct = ws && ws->is_connected();
+
+    if (direct) {
+      sync_paths();
+    }
+
+    writer_.start();
+
+    for (size_t i = 0; i < num_slots_; i++) {
+      Slot& s = slots_[i];
+      if (!s.gate_.due(now)) {
+        continue;  // rate-limited: keep the pending value for later
+      }
+
+      const float v = s.pending_ ? s.value_ : s.gate_.last_sent;
+
+      if (s.gate_.should_send(s.pending_, v, now, keepalive_ms_)) {
+        switch (sk_send_route(direct, s.template_id_ >= 0, s.replayed_)) {
+          case SK_ROUTE_DIRECT:
+            if (!writer_.append(s.template_id_, v)) {
+              flush(ws.get());                      // buffer full: split
+              writer_.append(s.template_id_, v);
+            }
+            break;
+          case SK_ROUTE_OUTPUT:
+            s.output_->set(v);
+            break;
+          case SK_ROUTE_DROP:
+            break;
+        }
+        s.gate_.mark_sent(v, now);
+      }
+
+      // Within the deadband: nothing lost, next change compares to last sent
+      s.pending_ = false;
+    }
+
+    if (direct && writer_.count() > 0) {
+      flush(ws.get());
+    }
+  }
+
+  // A path edited in the UI: rebuild every template (rare; ids are reassigned)
+  void sync_paths() {
+    bool stale = false;
+    for (size_t i = 0; i < num_slots_ && !stale; i++) {
+      const Slot& s = slots_[i];
+      stale = s.template_id_ >= 0 &&
+              !writer_.has_path(s.template_id_, s.output_->get_sk_path().c_str());
+    }
+    if (!stale) return;
+
+    writer_.clear_paths();
+    for (size_t i = 0; i < num_slots_; i++) {
+      Slot& s = slots_[i];
+      s.template_id_ = writer_.add_path(s.output_->get_sk_path().c_str());
+      if (s.template_id_ < 0) {
+        ESP_LOGE("SkBatch", "No template room, %s sent via SKOutput",
+                 s.output_->get_sk_path().c_str());
+      }
+    }
+    ESP_LOGI("SkBatch", "Signal K path changed, templates rebuilt");
+  }
+
+  template <typename WsClient>
+  void flush(WsClient* ws) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+
+    payload_ = writer_.finish(tv.tv_sec,
+                              static_cast<unsigned>(tv.tv_usec / 1000));
+    ws->sendTXT(payload_);
+    writer_.start();
+  }
+};
+
+// ----------------------------------------------------------------------------
+// Batcher slot for `output`, or `output` itself when there is no batcher
+// (or it is full) — always safe to connect_to()
+// ----------------------------------------------------------------------------
+inline ValueConsumer<float>* batched(SkOutputBatcher* batcher,
+                                     SKOutputFloat* output,
+                                     uint32_t min_interval_ms = 0,
+                                     float deadband = 0.0f) {
+  ValueConsumer<float>* slot =
+      batcher ? batcher->add(output, min_interval_ms, deadband) : nullptr;
+  return slot ? slot : output;
+}
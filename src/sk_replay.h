@@ -0,0 +1,270 @@
+#pragma once
+
+// ============================================================================
+// SkReplay — store-and-forward of engine data across Signal K outages
+// ============================================================================
+//
+// • The DataLogger keeps recording while the websocket is down; SkReplay
+//   marks the ring position when the connection drops (and at boot, before
+//   the first connect) and, after reconnect, replays every record written
+//   since then as its own delta carrying the ORIGINAL timestamp
+// • Rate-capped: at most RECORDS_PER_TICK deltas every REPLAY_INTERVAL_MS,
+//   interleaved with the live 5 Hz batcher ticks — live values are never
+//   queued behind the backlog
+// • A drop during a replay extends the pending range instead of restarting
+//   it (nothing is sent twice)
+// • Records stamped before the clock was set are placed on the wall clock
+//   through their uptime (same boot); if the clock is still unset they are
+//   skipped — a delta without a timestamp would be stored as "now"
+// • Resolution is the logger's (interval_ms, default 1 s); paths are taken
+//   from the bound SKOutputFloat objects (UI path edits picked up before
+//   each replay batch)
+// • Bound outputs must not also reach SensESP's delta queue while
+//   disconnected (main.cpp: SkOutputBatcher::set_replayed() once active())
+// ============================================================================
+
+#include <Arduino.h>
+#include <cmath>
+#include <ctime>
+#include <esp_log.h>
+
+#include <sys/time.h>
+
+#include <sensesp/signalk/signalk_output.h>
+
+#include "sensesp_app.h"
+
+#include "data_log.h"
+#include "data_logger.h"
+#include "sk_delta_writer.h"
+
+using namespace sensesp;
+
+// ============================================================================
+// Record → Signal K (no SensESP dependency)
+// ============================================================================
+enum SkReplayChannel {
+  REPLAY_REVOLUTIONS = 0,   // rev/s
+  REPLAY_COOLANT,           // K
+  REPLAY_OIL_PRESSURE,      // Pa
+  REPLAY_TEMP_ENGINE_ROOM,  // K
+  REPLAY_TEMP_EXHAUST,      // K
+  REPLAY_TEMP_ALTERNATOR,   // K
+  REPLAY_FUEL_RATE,         // m³/s
+  REPLAY_LOAD,              // ratio
+  REPLAY_NUM_CHANNELS
+};
+
+// Channel values in Signal K units, NaN where the record has none
+inline void log_record_to_sk(const LogRecord& r, float out[REPLAY_NUM_CHANNELS]) {
+  out[REPLAY_REVOLUTIONS]  = LogRecord::unscale(r.rev_s, LOG_RES_REV_S);
+  out[REPLAY_COOLANT]      = LogRecord::unscale(r.coolant_K, LOG_RES_TEMP);
+  out[REPLAY_OIL_PRESSURE] = LogRecord::unscale(r.oil_hPa, LOG_RES_OIL);
+  for (size_t i = 0; i < LogRecord::NUM_TEMPS; i++) {
+    out[REPLAY_TEMP_ENGINE_ROOM + i] =
+        LogRecord::unscale(r.temp_K[i], LOG_RES_TEMP);
+  }
+  out[REPLAY_FUEL_RATE]    =
+      LogRecord::unscale(r.fuel_lph, LOG_RES_FUEL) / 1000.0f / 3600.0f;
+  out[REPLAY_LOAD]         = LogRecord::unscale(r.load, LOG_RES_LOAD);
+}
+
+// Wall-clock time of a record written during this boot; false when it
+// cannot be placed (clock unset now, or an uptime stamp from the future)
+inline bool log_record_unix_time(const LogRecord& r,
+                                 time_t now_s, unsigned now_ms,
+                                 uint32_t uptime_ms,
+                                 time_t& out_s, unsigned& out_ms) {
+  if (r.flags & LogRecord::CLOCK_VALID) {
+    out_s  = static_cast<time_t>(r.time_s);
+    out_ms = r.time_ms;
+    return true;
+  }
+
+  if (now_s < 1577836800) {   // 2020-01-01: clock not set yet
+    return false;
+  }
+
+  const int64_t rec_uptime_ms =
+      static_cast<int64_t>(r.time_s) * 1000 + r.time_ms;
+  const int64_t age_ms = static_cast<int64_t>(uptime_ms) - rec_uptime_ms;
+  if (age_ms < 0) {
+    return false;
+  }
+
+  const int64_t unix_ms =
+      static_cast<int64_t>(now_s) * 1000 + now_ms - age_ms;
+  out_s  = static_cast<time_t>(unix_ms / 1000);
+  out_ms = static_cast<unsigned>(unix_ms % 1000);
+  return true;
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+class SkReplay {
+ public:
+  static constexpr uint32_t REPLAY_INTERVAL_MS = 100;
+  static constexpr size_t   RECORDS_PER_TICK   = 4;     // ≤ 40 deltas/s
+
+  explicit SkReplay(DataLogger* logger) : logger_(logger) {
+    for (size_t i = 0; i < REPLAY_NUM_CHANNELS; i++) {
+      outputs_[i] = nullptr;
+      ids_[i]     = -1;
+    }
+  }
+
+  // Before start(): which output's path a channel is replayed on
+  void bind(SkReplayChannel channel, SKOutputFloat* output) {
+    if (channel < REPLAY_NUM_CHANNELS) {
+      outputs_[channel] = output;
+    }
+  }
+
+  // After DataLogger::start(): build templates, mark boot, start polling
+  void start() {
+    if (!logger_ || !logger_->ready()) {
+      ESP_LOGW("SkReplay", "No data log, replay disabled");
+      return;
+    }
+
+    writer_.begin(sensesp_app->get_hostname().c_str());
+    build_templates();
+    payload_.reserve(SkDeltaWriter::BUF_BYTES);
+
+    // Not connected yet: everything from boot on is replayed
+    from_   = logger_->mark();
+    gap_    = true;
+    active_ = true;
+
+    sensesp_app->get_event_loop()->onRepeat(
+        REPLAY_INTERVAL_MS,
+        [this]() { this->tick(); });
+  }
+
+  // Started with a data log: bound outputs are covered across outages
+  bool active() const { return active_; }
+
+  SKOutputFloat* output(SkReplayChannel channel) const {
+    return (channel < REPLAY_NUM_CHANNELS) ? outputs_[channel] : nullptr;
+  }
+
+  bool     replaying() const { return replaying_; }
+  uint32_t replayed() const  { return replayed_; }
+
+ private:
+  DataLogger*     logger_;
+  SKOutputFloat*  outputs_[REPLAY_NUM_CHANNELS];
+  int             ids_[REPLAY_NUM_CHANNELS];
+  SkDeltaWriter   writer_;
+  String          payload_;
+
+  RingLog::Mark   from_;
+  RingLog::Cursor cursor_;
+  bool            active_    = false;
+  bool            connected_ = false;
+  bool            gap_       = false;   // from_ marks an unreplayed outage
+  bool            replaying_ = false;
+  uint32_t        replayed_  = 0;
+
+  LogRecord       records_[RECORDS_PER_TICK];
+
+  void build_templates() {
+    writer_.clear_paths();
+    for (size_t i = 0; i < REPLAY_NUM_CHANNELS; i++) {
+      ids_[i] = outputs_[i]
+                    ? writer_.add_path(outputs_[i]->get_sk_path().c_str())
+                    : -1;
+    }
+  }
+
+  // A path edited in the UI since the templates were built
+  bool paths_stale() const {
+    for (size_t i = 0; i < REPLAY_NUM_CHANNELS; i++) {
+      if (ids_[i] >= 0 &&
+          !writer_.has_path(ids_[i], outputs_[i]->get_sk_path().c_str())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void tick() {
+    auto ws = sensesp_app->get_ws_client();
+    const bool connected = ws && ws->is_connected();
+
+    if (!connected) {
+      if (connected_ && !replaying_) {
+        from_ = logger_->mark();   // outage starts here
+      }
+      gap_       = gap_ || connected_;
+      connected_ = false;
+      return;
+    }
+
+    if (!connected_) {
+      connected_ = true;
+      if (gap_) {
+        const RingLog::Mark to = logger_->mark();
+        if (replaying_) {
+          cursor_.max_seq  = to.seq;    // interrupted replay: extend it
+          cursor_.end_slot = to.slot;
+        } else {
+          cursor_ = logger_->range(from_, to);
+        }
+        gap_       = false;
+        replaying_ = true;
+      }
+    }
+
+    if (replaying_) {
+      replay_some(ws.get());
+    }
+  }
+
+  template <typename WsClient>
+  void replay_some(WsClient* ws) {
+    const size_t n = logger_->read(cursor_, records_, RECORDS_PER_TICK);
+    if (n == 0) {
+      replaying_ = false;
+      ESP_LOGI("SkReplay", "Replay complete, %u records",
+               static_cast<unsigned>(replayed_));
+      return;
+    }
+
+    if (paths_stale()) {
+      build_templates();
+    }
+
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    const uint32_t uptime = millis();
+
+    float values[REPLAY_NUM_CHANNELS];
+    for (size_t i = 0; i < n; i++) {
+      time_t   t_s;
+      unsigned t_ms;
+      if (!log_record_unix_time(records_[i], tv.tv_sec,
+                                static_cast<unsigned>(tv.tv_usec / 1000),
+                                uptime, t_s, t_ms)) {
+        continue;
+      }
+
+      log_record_to_sk(records_[i], values);
+
+      writer_.start();
+      for (size_t c = 0; c < REPLAY_NUM_CHANNELS; c++) {
+        if (std::isfinite(values[c])) {
+          writer_.append(ids_[c], values[c]);
+        }
+      }
+      if (writer_.count() == 0) {
+        continue;
+      }
+
+      payload_ = writer_.finish(t_s, t_ms);
+      ws->sendTXT(payload_);
+      replayed_++;
+    }
+  }
+};
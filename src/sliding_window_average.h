@@ -0,0 +1,90 @@
+#pragma once
+
+// ============================================================================
+// SlidingWindowAverage<N> — fixed-capacity, time-windowed running mean
+// ============================================================================
+//
+// • Statically sized ring buffer (N samples) — no heap, no std::deque
+// • Incremental running sum → push / evict / mean are O(1)
+// • Time-based eviction: samples older than window_ms are dropped
+// • When full, the oldest sample is overwritten (window shrinks, never grows)
+//
+// Header-only and free of SensESP/Arduino dependencies so it can be reused
+// for any windowed filter (and unit-tested off the pipeline).
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+template <size_t N>
+class SlidingWindowAverage {
+  static_assert(N > 0, "SlidingWindowAverage capacity must be > 0");
+
+ public:
+  explicit SlidingWindowAverage(uint32_t window_ms = 1000)
+      : window_ms_(window_ms) {}
+
+  void set_window_ms(uint32_t window_ms) { window_ms_ = window_ms; }
+  uint32_t window_ms() const { return window_ms_; }
+
+  // -------------------------------------------------------------------------
+  // Add a sample (oldest is overwritten when the buffer is full)
+  // -------------------------------------------------------------------------
+  void push(float value, uint32_t t_ms) {
+    if (count_ == N) {
+      pop_front();
+    }
+
+    const size_t tail = (head_ + count_) % N;
+    values_[tail] = value;
+    times_[tail]  = t_ms;
+    sum_ += value;
+    count_++;
+  }
+
+  // -------------------------------------------------------------------------
+  // Drop samples older than the window (relative to now_ms, wrap-safe)
+  // -------------------------------------------------------------------------
+  void evict(uint32_t now_ms) {
+    while (count_ > 0 && (now_ms - times_[head_]) > window_ms_) {
+      pop_front();
+    }
+  }
+
+  void clear() {
+    head_  = 0;
+    count_ = 0;
+    sum_   = 0.0;
+  }
+
+  bool   empty() const { return count_ == 0; }
+  size_t size() const { return count_; }
+  static constexpr size_t capacity() { return N; }
+
+  double sum() const { return sum_; }
+
+  // Mean of samples currently in the window (NAN when empty)
+  float mean() const {
+    return (count_ == 0) ? NAN : static_cast<float>(sum_ / count_);
+  }
+
+ private:
+  float    values_[N] = {};
+  uint32_t times_[N]  = {};
+  size_t   head_      = 0;
+  size_t   count_     = 0;
+  double   sum_       = 0.0;   // double: no drift over weeks of add/subtract
+  uint32_t window_ms_;
+
+  void pop_front() {
+    sum_ -= values_[head_];
+    head_ = (head_ + 1) % N;
+    count_--;
+
+    // Re-anchor when empty so rounding error cannot accumulate
+    if (count_ == 0) {
+      sum_ = 0.0;
+    }
+  }
+};
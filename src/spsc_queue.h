@@ -0,0 +1,67 @@
+#pragma once
+
+// ============================================================================
+// SpscQueue<T, N> — lock-free single-producer / single-consumer ring
+// ============================================================================
+//
+// • Exactly one producer (push) and one consumer (pop), any two contexts —
+//   e.g. the acquisition task and the SensESP event loop on another
+//   priority / core
+// • No locks, no allocation: head/tail are atomics with acquire/release
+//   ordering, the slot array is fixed at compile time
+// • N must be a power of two; capacity is N - 1
+// • push() never blocks: it returns false when full (caller counts drops)
+// ============================================================================
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be a power of two");
+
+ public:
+  // Producer side
+  bool push(const T& item) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t next = (head + 1) & MASK;
+
+    if (next == tail_.load(std::memory_order_acquire)) {
+      return false;  // full
+    }
+
+    slots_[head] = item;
+    head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool pop(T& out) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;  // empty
+    }
+
+    out = slots_[tail];
+    tail_.store((tail + 1) & MASK, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when called concurrently (exact from either side at rest)
+  size_t size() const {
+    return (head_.load(std::memory_order_acquire) -
+            tail_.load(std::memory_order_acquire)) & MASK;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  static constexpr size_t capacity() { return N - 1; }
+
+ private:
+  static constexpr size_t MASK = N - 1;
+
+  T                   slots_[N];
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
@@ -0,0 +1,282 @@
+#pragma once
+
+// ============================================================================
+// SystemDiagnostics — heap, fragmentation and task stack telemetry
+// ============================================================================
+//
+// • Setup: mark_setup(name) after each subsystem is built records the
+//   allocations it made (heap block count + bytes, from heap_caps_get_info)
+//   — logged once by start() and shown on the status page
+// • Every SAMPLE_INTERVAL_MS:
+//     free heap, largest free block, minimum-ever free heap,
+//     fragmentation = 1 − largest / free, allocated block count
+//     stack high-water mark (bytes never used) of loopTask, wifi, acquire
+//   → debug.system.* (batched, ENABLE_DEBUG_OUTPUTS) and the web UI
+//     status page (always)
+// • A block count that keeps growing at runtime means something allocates
+//   per update; a rising fragmentation with stable free heap means
+//   long-lived allocations interleave with short-lived ones
+// ============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// ============================================================================
+// Snapshots / setup accounting (no SensESP dependency)
+// ============================================================================
+struct HeapSnapshot {
+  uint32_t free_bytes       = 0;
+  uint32_t largest_block    = 0;
+  uint32_t min_free_bytes   = 0;
+  uint32_t allocated_bytes  = 0;
+  uint32_t allocated_blocks = 0;
+};
+
+// 0 = one contiguous free region, → 1 = free heap in small pieces
+inline float heap_fragmentation(const HeapSnapshot& s) {
+  if (s.free_bytes == 0) return 0.0f;
+  const float f = 1.0f - static_cast<float>(s.largest_block) /
+                             static_cast<float>(s.free_bytes);
+  return (f < 0.0f) ? 0.0f : f;
+}
+
+class SetupAllocTracker {
+ public:
+  // main.cpp setup(): board-wide marks ("app", "acq start", …, 9 today),
+  // per-engine marks ("rpm", "oil", "coolant", "hours") for MAX_ENGINES
+  // and one per deferred boot step (DeferredBootQueue::MAX_STEPS) —
+  // checked against both in main.cpp. Marks past MAX_STAGES are summed
+  // into an "other" row
+  static constexpr size_t BOARD_STAGES      = 10;
+  static constexpr size_t STAGES_PER_ENGINE = 4;
+  static constexpr size_t MAX_SETUP_ENGINES = 2;
+  static constexpr size_t MAX_BOOT_STEPS    = 16;
+  static constexpr size_t MAX_STAGES =
+      BOARD_STAGES + STAGES_PER_ENGINE * MAX_SETUP_ENGINES + MAX_BOOT_STEPS;
+
+  struct Stage {
+    const char* name   = "";
+    int32_t     blocks = 0;   // net heap blocks allocated by the stage
+    int32_t     bytes  = 0;   // net heap bytes
+  };
+
+  void begin(const HeapSnapshot& now) {
+    last_       = now;
+    first_      = now;
+    num_stages_ = 0;
+    overflow_   = 0;
+  }
+
+  // Everything allocated since the previous mark belongs to `name`
+  void mark(const char* name, const HeapSnapshot& now) {
+    const int32_t blocks =
+        static_cast<int32_t>(now.allocated_blocks - last_.allocated_blocks);
+    const int32_t bytes =
+        static_cast<int32_t>(now.allocated_bytes - last_.allocated_bytes);
+    last_ = now;
+
+    if (num_stages_ < MAX_STAGES) {
+      Stage& s = stages_[num_stages_++];
+      s.name   = name;
+      s.blocks = blocks;
+      s.bytes  = bytes;
+      return;
+    }
+
+    // Table full: one "other" row after the last stage
+    Stage& other = stages_[MAX_STAGES];
+    if (overflow_++ == 0) {
+      other       = Stage();
+      other.name  = "other";
+      num_stages_ = MAX_STAGES + 1;
+    }
+    other.blocks += blocks;
+    other.bytes  += bytes;
+  }
+
+  // Marks summed into the "other" row
+  size_t       overflow() const { return overflow_; }
+  size_t       size() const { return num_stages_; }
+  const Stage& operator[](size_t i) const { return stages_[i]; }
+
+  int32_t total_blocks() const {
+    return static_cast<int32_t>(last_.allocated_blocks - first_.allocated_blocks);
+  }
+  int32_t total_bytes() const {
+    return static_cast<int32_t>(last_.allocated_bytes - first_.allocated_bytes);
+  }
+
+ private:
+  Stage        stages_[MAX_STAGES + 1];   // + "other"
+  size_t       num_stages_ = 0;
+  size_t       overflow_   = 0;
+  HeapSnapshot first_;
+  HeapSnapshot last_;
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/ui/status_page_item.h>
+
+#include "sensesp_app.h"
+
+#include "acquisition_task.h"
+#include "sk_output_batcher.h"
+
+using namespace sensesp;
+
+extern SkOutputBatcher* g_sk_batcher;
+
+// Arduino loop / ESP-IDF WiFi / core-1 sampling task
+static const char* const DIAG_TASK_NAMES[] = {
+  "loopTask", "wifi", ACQUISITION_TASK_NAME
+};
+
+inline HeapSnapshot take_heap_snapshot() {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+
+  HeapSnapshot s;
+  s.free_bytes       = static_cast<uint32_t>(info.total_free_bytes);
+  s.largest_block    = static_cast<uint32_t>(info.largest_free_block);
+  s.min_free_bytes   = static_cast<uint32_t>(heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT));
+  s.allocated_bytes  = static_cast<uint32_t>(info.total_allocated_bytes);
+  s.allocated_blocks = static_cast<uint32_t>(info.allocated_blocks);
+  return s;
+}
+
+class SystemDiagnostics {
+ public:
+  static constexpr uint32_t SAMPLE_INTERVAL_MS = 30000;
+  static constexpr size_t   NUM_TASKS          =
+      sizeof(DIAG_TASK_NAMES) / sizeof(DIAG_TASK_NAMES[0]);
+
+  // Construct first in setup(): the baseline for the setup accounting
+  SystemDiagnostics() { setup_.begin(take_heap_snapshot()); }
+
+  void mark_setup(const char* name) { setup_.mark(name, take_heap_snapshot()); }
+
+  // After the last mark_setup(): log the setup table, start sampling
+  void start() {
+    if (setup_.overflow() > 0) {
+      ESP_LOGW("Diag", "Setup table full, %u stages summed as \"other\"",
+               static_cast<unsigned>(setup_.overflow()));
+    }
+    for (size_t i = 0; i < setup_.size(); i++) {
+      ESP_LOGI("Diag", "setup %-16s %5d blocks %7d bytes",
+               setup_[i].name, static_cast<int>(setup_[i].blocks),
+               static_cast<int>(setup_[i].bytes));
+    }
+    ESP_LOGI("Diag", "setup total            %5d blocks %7d bytes",
+             static_cast<int>(setup_.total_blocks()),
+             static_cast<int>(setup_.total_bytes()));
+
+    char summary[48];
+    snprintf(summary, sizeof(summary), "%d blocks, %d bytes",
+             static_cast<int>(setup_.total_blocks()),
+             static_cast<int>(setup_.total_bytes()));
+    new StatusPageItem<String>("Setup allocations", String(summary),
+                               "Memory", 0);
+
+    sk_free_      = output("debug.system.heap.free");
+    sk_largest_   = output("debug.system.heap.largestFreeBlock");
+    sk_min_free_  = output("debug.system.heap.minFree");
+    sk_frag_      = output("debug.system.heap.fragmentation");
+    sk_blocks_    = output("debug.system.heap.allocatedBlocks");
+
+    ui_free_      = new StatusPageItem<int>("Free heap", 0, "Memory", 1);
+    ui_largest_   = new StatusPageItem<int>("Largest free block", 0, "Memory", 2);
+    ui_min_free_  = new StatusPageItem<int>("Minimum free heap", 0, "Memory", 3);
+    ui_frag_      = new StatusPageItem<float>("Fragmentation", 0.0f, "Memory", 4);
+    ui_blocks_    = new StatusPageItem<int>("Allocated blocks", 0, "Memory", 5);
+
+    for (size_t i = 0; i < NUM_TASKS; i++) {
+      tasks_[i].sk = output(String("debug.system.stack.") + DIAG_TASK_NAMES[i]);
+      tasks_[i].ui = new StatusPageItem<int>(
+          String("Stack free: ") + DIAG_TASK_NAMES[i], 0, "Memory",
+          static_cast<int>(10 + i));
+    }
+
+    sensesp_app->get_event_loop()->onRepeat(
+        SAMPLE_INTERVAL_MS,
+        [this]() { this->sample(); });
+    sample();
+  }
+
+ private:
+  struct TaskProbe {
+    TaskHandle_t            handle = nullptr;
+    ValueConsumer<float>*   sk     = nullptr;
+    StatusPageItem<int>*    ui     = nullptr;
+  };
+
+  SetupAllocTracker setup_;
+
+  ValueConsumer<float>* sk_free_     = nullptr;
+  ValueConsumer<float>* sk_largest_  = nullptr;
+  ValueConsumer<float>* sk_min_free_ = nullptr;
+  ValueConsumer<float>* sk_frag_     = nullptr;
+  ValueConsumer<float>* sk_blocks_   = nullptr;
+
+  StatusPageItem<int>*   ui_free_     = nullptr;
+  StatusPageItem<int>*   ui_largest_  = nullptr;
+  StatusPageItem<int>*   ui_min_free_ = nullptr;
+  StatusPageItem<float>* ui_frag_     = nullptr;
+  StatusPageItem<int>*   ui_blocks_   = nullptr;
+
+  TaskProbe tasks_[NUM_TASKS];
+
+  static ValueConsumer<float>* output(const String& path) {
+#if ENABLE_DEBUG_OUTPUTS
+    return batched(g_sk_batcher, new SKOutputFloat(path),
+                   SK_DEBUG_MIN_INTERVAL_MS);
+#else
+    (void)path;
+    return nullptr;
+#endif
+  }
+
+  static void emit(ValueConsumer<float>* sk, float value) {
+    if (sk) sk->set(value);
+  }
+
+  void sample() {
+    const HeapSnapshot h = take_heap_snapshot();
+    const float frag = heap_fragmentation(h);
+
+    emit(sk_free_, static_cast<float>(h.free_bytes));
+    emit(sk_largest_, static_cast<float>(h.largest_block));
+    emit(sk_min_free_, static_cast<float>(h.min_free_bytes));
+    emit(sk_frag_, frag);
+    emit(sk_blocks_, static_cast<float>(h.allocated_blocks));
+
+    ui_free_->set(static_cast<int>(h.free_bytes));
+    ui_largest_->set(static_cast<int>(h.largest_block));
+    ui_min_free_->set(static_cast<int>(h.min_free_bytes));
+    ui_frag_->set(frag);
+    ui_blocks_->set(static_cast<int>(h.allocated_blocks));
+
+    for (size_t i = 0; i < NUM_TASKS; i++) {
+      TaskProbe& t = tasks_[i];
+      if (!t.handle) {
+        t.handle = xTaskGetHandle(DIAG_TASK_NAMES[i]);   // created late / not at all
+      }
+      if (!t.handle) continue;
+
+      // ESP-IDF reports the watermark in bytes
+      const UBaseType_t free_bytes = uxTaskGetStackHighWaterMark(t.handle);
+      emit(t.sk, static_cast<float>(free_bytes));
+      t.ui->set(static_cast<int>(free_bytes));
+    }
+  }
+};
+
+#endif  // ARDUINO
@@ -0,0 +1,541 @@
+#pragma once
+
+// ============================================================================
+// ThermalAnomalyMonitor — learned coolant / exhaust baseline per RPM × load
+// ============================================================================
+//
+// • Operating point: the engine's smoothed RPM × load (EngineInstance
+//   rev_s_smooth / load) → one of RPM_BINS × LOAD_BINS bins
+// • Per bin: incremental mean / variance (Welford), O(1) per sample. The
+//   count saturates at n_max, after which the update is an exponentially
+//   weighted one — the baseline follows slow seasonal / fouling drift
+// • Only steady-state samples count (1 Hz): engine warm (warmup_s since
+//   start) and the same bin for settle_s — temperatures lag load changes
+// • z = (T − mean) / max(σ, MIN_SIGMA_K) once a bin has min_samples;
+//   |z| ≥ warn_sigma / alarm_sigma for debounce_s consecutive samples
+//   → Signal K notification (warn / alarm), e.g. a failing raw-water
+//   impeller long before the gauge redlines
+// • Anomalous samples are not learned (the fault is not absorbed)
+// • Tables persist in NVS: 6 bytes per bin (count, mean, σ in 0.01 K),
+//   written every SAVE_INTERVAL_MS while learning and at engine stop
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "crc32.h"
+
+// ============================================================================
+// Baseline / detector (no SensESP dependency)
+// ============================================================================
+enum AnomalyLevel : uint8_t {
+  ANOMALY_NORMAL = 0,
+  ANOMALY_WARN,
+  ANOMALY_ALARM
+};
+
+class ThermalBaseline {
+ public:
+  static constexpr size_t RPM_BINS  = 8;      // 500 … 3700 RPM, 400 wide
+  static constexpr size_t LOAD_BINS = 5;      // 0 … 1, 0.2 wide
+  static constexpr size_t NUM_BINS  = RPM_BINS * LOAD_BINS;
+
+  static constexpr float RPM_MIN   = 500.0f;
+  static constexpr float RPM_WIDTH = 400.0f;
+
+  struct Bin {
+    float n    = 0.0f;
+    float mean = 0.0f;
+    float var  = 0.0f;   // population variance
+  };
+
+  // Compact NVS layout (0.01 K)
+  struct PackedBin {
+    uint16_t n;
+    uint16_t mean_cK;
+    uint16_t sigma_cK;
+  };
+
+  // -1 → not running / unknown operating point
+  static int bin_index(float rpm, float load) {
+    if (!(rpm >= RPM_MIN) || std::isnan(load)) return -1;
+
+    int r = static_cast<int>((rpm - RPM_MIN) / RPM_WIDTH);
+    if (r >= static_cast<int>(RPM_BINS)) r = RPM_BINS - 1;
+
+    int l = static_cast<int>(load * LOAD_BINS);
+    if (l < 0) l = 0;
+    if (l >= static_cast<int>(LOAD_BINS)) l = LOAD_BINS - 1;
+
+    return r * static_cast<int>(LOAD_BINS) + l;
+  }
+
+  // Exact Welford below n_max, exponentially weighted (1/n_max) above
+  void add(size_t i, float x, float n_max) {
+    if (i >= NUM_BINS) return;
+    Bin& b = bins_[i];
+    if (b.n < n_max) b.n += 1.0f;
+
+    const float a = 1.0f / b.n;
+    const float d = x - b.mean;
+    b.mean += a * d;
+    b.var   = (1.0f - a) * (b.var + a * d * d);
+  }
+
+  // NaN for an empty bin
+  float z(size_t i, float x, float min_sigma) const {
+    if (i >= NUM_BINS || bins_[i].n < 1.0f) return NAN;
+    float sigma = std::sqrt(bins_[i].var);
+    if (sigma < min_sigma) sigma = min_sigma;
+    return (x - bins_[i].mean) / sigma;
+  }
+
+  const Bin& operator[](size_t i) const { return bins_[i]; }
+
+  size_t learned(float min_samples) const {
+    size_t n = 0;
+    for (size_t i = 0; i < NUM_BINS; i++) {
+      if (bins_[i].n >= min_samples) n++;
+    }
+    return n;
+  }
+
+  void clear() {
+    for (size_t i = 0; i < NUM_BINS; i++) bins_[i] = Bin();
+  }
+
+  void pack(PackedBin* out) const {
+    for (size_t i = 0; i < NUM_BINS; i++) {
+      out[i].n        = static_cast<uint16_t>(bins_[i].n);
+      out[i].mean_cK  = to_cK(bins_[i].mean);
+      out[i].sigma_cK = to_cK(std::sqrt(bins_[i].var));
+    }
+  }
+
+  void unpack(const PackedBin* in) {
+    for (size_t i = 0; i < NUM_BINS; i++) {
+      const float sigma = in[i].sigma_cK / 100.0f;
+      bins_[i].n    = in[i].n;
+      bins_[i].mean = in[i].mean_cK / 100.0f;
+      bins_[i].var  = sigma * sigma;
+    }
+  }
+
+ private:
+  Bin bins_[NUM_BINS];
+
+  static uint16_t to_cK(float k) {
+    const float c = std::round(k * 100.0f);
+    if (!(c > 0.0f)) return 0;
+    return (c >= 65535.0f) ? 65535 : static_cast<uint16_t>(c);
+  }
+};
+
+struct ThermalAnomalyParams {
+  float    warn_sigma  = 3.0f;
+  float    alarm_sigma = 5.0f;
+  float    min_samples = 300.0f;    // 5 min of steady running per bin
+  float    n_max       = 3600.0f;   // ≈ 1 h memory once saturated
+  uint32_t warmup_ms   = 600000;    // thermostat open
+  uint32_t settle_ms   = 120000;    // same bin before a sample counts
+  uint32_t debounce    = 30;        // consecutive samples (1 Hz)
+};
+
+class ThermalAnomalyDetector {
+ public:
+  static constexpr float MIN_SIGMA_K = 0.5f;   // sensor / quantization floor
+
+  ThermalAnomalyParams params;
+
+  // One steady-rate sample (1 Hz); returns the debounced level
+  AnomalyLevel observe(float rpm, float load, float temp_K, uint32_t now_ms) {
+    const int bin = ThermalBaseline::bin_index(rpm, load);
+    last_z_ = NAN;
+
+    if (bin < 0 || std::isnan(temp_K)) {
+      running_ = false;
+      bin_     = -1;
+      reset_level();
+      return level_;
+    }
+
+    if (!running_) {
+      running_          = true;
+      running_since_ms_ = now_ms;
+    }
+    if (bin != bin_) {
+      bin_            = bin;
+      bin_since_ms_   = now_ms;
+    }
+
+    if ((now_ms - running_since_ms_) < params.warmup_ms ||
+        (now_ms - bin_since_ms_) < params.settle_ms) {
+      return level_;
+    }
+
+    const size_t i = static_cast<size_t>(bin);
+    AnomalyLevel raw = ANOMALY_NORMAL;
+
+    if (baseline_[i].n >= params.min_samples) {
+      last_z_ = baseline_.z(i, temp_K, MIN_SIGMA_K);
+      const float a = std::fabs(last_z_);
+      if (a >= params.alarm_sigma)      raw = ANOMALY_ALARM;
+      else if (a >= params.warn_sigma)  raw = ANOMALY_WARN;
+    }
+
+    if (raw == ANOMALY_NORMAL) {
+      baseline_.add(i, temp_K, params.n_max);
+      dirty_ = true;
+    }
+
+    debounce(raw);
+    return level_;
+  }
+
+  AnomalyLevel level() const { return level_; }
+  float last_z() const { return last_z_; }      // NaN → not evaluated
+  int bin() const { return bin_; }
+  bool running() const { return running_; }
+
+  ThermalBaseline& baseline() { return baseline_; }
+  const ThermalBaseline& baseline() const { return baseline_; }
+
+  bool dirty() const { return dirty_; }
+  void clear_dirty() { dirty_ = false; }
+
+ private:
+  ThermalBaseline baseline_;
+
+  AnomalyLevel level_     = ANOMALY_NORMAL;
+  AnomalyLevel candidate_ = ANOMALY_NORMAL;
+  uint32_t     count_     = 0;
+  float        last_z_    = NAN;
+
+  bool     running_          = false;
+  uint32_t running_since_ms_ = 0;
+  int      bin_              = -1;
+  uint32_t bin_since_ms_     = 0;
+  bool     dirty_            = false;
+
+  void debounce(AnomalyLevel raw) {
+    if (raw == candidate_) {
+      if (count_ < params.debounce) count_++;
+    } else {
+      candidate_ = raw;
+      count_     = 1;
+    }
+    if (count_ >= params.debounce) level_ = candidate_;
+  }
+
+  void reset_level() {
+    level_     = ANOMALY_NORMAL;
+    candidate_ = ANOMALY_NORMAL;
+    count_     = 0;
+  }
+};
+
+// NVS blob: versioned, CRC-checked (survives firmware updates)
+struct ThermalBaselineRecord {
+  static constexpr uint32_t MAGIC = 0x54424c31u;   // "TBL1"
+
+  uint32_t magic = 0;
+  ThermalBaseline::PackedBin bins[ThermalBaseline::NUM_BINS];
+  uint32_t crc   = 0;
+
+  void seal() {
+    magic = MAGIC;
+    crc   = crc32_ieee(bins, sizeof(bins));
+  }
+
+  bool valid() const {
+    return magic == MAGIC && crc == crc32_ieee(bins, sizeof(bins));
+  }
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_log.h>
+
+#include <sensesp/signalk/signalk_output.h>
+#include <sensesp/system/valueproducer.h>
+#include <sensesp/transforms/transform.h>
+#include <sensesp/ui/config_item.h>
+
+#include "boot_stage.h"
+#include "engine_instance.h"
+#include "pipeline_profiler.h"
+#include "sk_output_batcher.h"
+
+using namespace sensesp;
+
+extern SkOutputBatcher* g_sk_batcher;
+
+class ThermalAnomalyMonitor : public Transform<float, String> {
+ public:
+  static constexpr const char* NVS_NAMESPACE      = "anomaly";
+  static constexpr uint32_t    SAMPLE_INTERVAL_MS = 1000;
+  static constexpr uint32_t    SAVE_INTERVAL_MS   = 600000;   // 10 min
+
+  // label: message text ("Coolant"); nvs_key: ≤ 15 characters
+  ThermalAnomalyMonitor(const EngineInstance* engine,
+                        const char* label, const String& nvs_key,
+                        const String& config_path = "")
+      : Transform<float, String>(config_path),
+        engine_(engine),
+        label_(label),
+        nvs_key_(nvs_key),
+        perf_id_(perf_stage(engine ? engine->perf_name("thermal_anomaly")
+                                   : "thermal_anomaly")) {
+    this->load();
+    load_tables();
+  }
+
+  // Temperature (K) at any rate; evaluated at SAMPLE_INTERVAL_MS
+  void set(const float& temp_K) override {
+    const uint32_t now = millis();
+    if (sampled_ && (now - last_sample_ms_) < SAMPLE_INTERVAL_MS) return;
+    sampled_        = true;
+    last_sample_ms_ = now;
+
+    PerfScope perf(perf_id_);
+
+    // load stays nullptr until the (deferred) load model is built
+    const float rps  = engine_->rev_s_smooth ? engine_->rev_s_smooth->get() : NAN;
+    const float load = engine_->load ? engine_->load->get() : NAN;
+    const float rpm  = rps * 60.0f;
+
+    const bool was_running = detector_.running();
+    const AnomalyLevel level = detector_.observe(rpm, load, temp_K, now);
+
+    if (sk_sigma_ && !std::isnan(detector_.last_z())) {
+      sk_sigma_->set(detector_.last_z());
+    }
+
+    // Engine stop, or periodically while learning
+    if (detector_.dirty() &&
+        ((was_running && !detector_.running()) ||
+         (now - last_save_ms_) >= SAVE_INTERVAL_MS)) {
+      save_tables();
+      last_save_ms_ = now;
+    }
+
+    update(level, rpm, load);
+  }
+
+  void set_debug_output(ValueConsumer<float>* sk_sigma) { sk_sigma_ = sk_sigma; }
+
+  // -------------------------------------------------------------------------
+  // SensESP configuration persistence
+  // -------------------------------------------------------------------------
+  bool to_json(JsonObject& json) override {
+    const ThermalAnomalyParams& p = detector_.params;
+    json["warn_sigma"]  = p.warn_sigma;
+    json["alarm_sigma"] = p.alarm_sigma;
+    json["min_samples"] = p.min_samples;
+    json["warmup_s"]    = p.warmup_ms / 1000;
+    json["settle_s"]    = p.settle_ms / 1000;
+    json["debounce_s"]  = p.debounce;
+    json["learned_bins"] =
+        static_cast<int>(detector_.baseline().learned(p.min_samples));
+    json["reset"]       = false;
+    return true;
+  }
+
+  bool from_json(const JsonObject& json) override {
+    ThermalAnomalyParams& p = detector_.params;
+    if (json["warn_sigma"].is<float>()) {
+      p.warn_sigma = json["warn_sigma"].as<float>();
+    }
+    if (json["alarm_sigma"].is<float>()) {
+      p.alarm_sigma = json["alarm_sigma"].as<float>();
+    }
+    if (p.alarm_sigma < p.warn_sigma) {
+      p.alarm_sigma = p.warn_sigma;
+    }
+    if (json["min_samples"].is<float>()) {
+      p.min_samples = json["min_samples"].as<float>();
+    }
+    if (json["warmup_s"].is<uint32_t>()) {
+      p.warmup_ms = json["warmup_s"].as<uint32_t>() * 1000;
+    }
+    if (json["settle_s"].is<uint32_t>()) {
+      p.settle_ms = json["settle_s"].as<uint32_t>() * 1000;
+    }
+    if (json["debounce_s"].is<int>()) {
+      const int n = json["debounce_s"].as<int>();
+      p.debounce = (n < 1) ? 1 : static_cast<uint32_t>(n);
+    }
+    if (json["reset"].is<bool>() && json["reset"].as<bool>()) {
+      detector_.baseline().clear();
+      save_tables();
+      ESP_LOGI("Anomaly", "%s baseline cleared", label_);
+    }
+    return true;
+  }
+
+ private:
+  const EngineInstance*  engine_;
+  const char*            label_;
+  String                 nvs_key_;
+  ThermalAnomalyDetector detector_;
+
+  bool         sampled_        = false;
+  uint32_t     last_sample_ms_ = 0;
+  uint32_t     last_save_ms_   = 0;
+  bool         published_      = false;
+  AnomalyLevel published_level_ = ANOMALY_NORMAL;
+  int          perf_id_;
+
+  ValueConsumer<float>* sk_sigma_ = nullptr;
+
+  void load_tables() {
+    ThermalBaselineRecord r;
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) return;
+    const size_t got = prefs.getBytes(nvs_key_.c_str(), &r, sizeof(r));
+    prefs.end();
+
+    if (got == sizeof(r) && r.valid()) {
+      detector_.baseline().unpack(r.bins);
+      ESP_LOGI("Anomaly", "%s baseline: %u learned bins", label_,
+               static_cast<unsigned>(
+                   detector_.baseline().learned(detector_.params.min_samples)));
+    }
+  }
+
+  void save_tables() {
+    ThermalBaselineRecord r;
+    detector_.baseline().pack(r.bins);
+    r.seal();
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) return;
+    prefs.putBytes(nvs_key_.c_str(), &r, sizeof(r));
+    prefs.end();
+    detector_.clear_dirty();
+  }
+
+  // Notification value only when the level changes
+  void update(AnomalyLevel level, float rpm, float load) {
+    if (published_ && level == published_level_) return;
+    published_       = true;
+    published_level_ = level;
+
+    char buf[200];
+    if (level == ANOMALY_NORMAL) {
+      snprintf(buf, sizeof(buf),
+               "{\"state\":\"normal\",\"method\":[],"
+               "\"message\":\"%s temperature normal\"}", label_);
+    } else {
+      const float z = detector_.last_z();
+      snprintf(buf, sizeof(buf),
+               "{\"state\":\"%s\",\"method\":[\"visual\"%s],"
+               "\"message\":\"%s temperature %.1f sigma %s normal "
+               "at %.0f RPM / %.0f %% load\"}",
+               (level == ANOMALY_ALARM) ? "alarm" : "warn",
+               (level == ANOMALY_ALARM) ? ",\"sound\"" : "",
+               label_, std::fabs(z), (z >= 0.0f) ? "above" : "below",
+               rpm, load * 100.0f);
+      ESP_LOGW("Anomaly", "%s", buf);
+    }
+    this->emit(String(buf));
+  }
+};
+
+inline String ConfigSchema(const ThermalAnomalyMonitor&) {
+  return R"JSON({
+    "type": "object",
+    "properties": {
+      "warn_sigma": {
+        "title": "Warn at (sigma)",
+        "type": "number",
+        "description": "Deviation from the learned baseline for a warning"
+      },
+      "alarm_sigma": {
+        "title": "Alarm at (sigma)",
+        "type": "number",
+        "description": "Deviation from the learned baseline for an alarm"
+      },
+      "min_samples": {
+        "title": "Samples before evaluating a bin",
+        "type": "number",
+        "description": "Steady-state seconds learned per RPM / load bin first"
+      },
+      "warmup_s": {
+        "title": "Warm-up (s)",
+        "type": "integer",
+        "description": "Running time after start before learning / evaluating"
+      },
+      "settle_s": {
+        "title": "Settle time (s)",
+        "type": "integer",
+        "description": "Time in one RPM / load bin before samples count"
+      },
+      "debounce_s": {
+        "title": "Debounce (s)",
+        "type": "integer",
+        "description": "Consecutive deviating samples required to notify"
+      },
+      "learned_bins": {
+        "title": "Learned bins",
+        "type": "integer",
+        "readOnly": true
+      },
+      "reset": {
+        "title": "Reset baseline",
+        "type": "boolean",
+        "description": "Forget everything learned (e.g. after a cooling system overhaul)"
+      }
+    }
+  })JSON";
+}
+
+// ----------------------------------------------------------------------------
+// Monitor one temperature (K) of engine e: notification on
+// notifications.propulsion.<id>.<leaf> + optional debug sigma output
+// ----------------------------------------------------------------------------
+inline ThermalAnomalyMonitor* setup_thermal_anomaly(
+    EngineInstance& e,
+    ValueProducer<float>* temp_K,
+    const char* label,
+    const char* key,
+    const char* leaf,
+    int sort_order) {
+  const String k(key);
+
+  auto* monitor = new ThermalAnomalyMonitor(
+      &e, label, e.nvs_name(key),
+      e.config_path(("/config/sensors/anomaly/" + k).c_str()));
+
+  auto* sk_notify = new SKOutputRawJson(
+      e.notification_path(leaf),
+      e.config_path(("/config/outputs/sk/anomaly_" + k).c_str()));
+
+  temp_K->connect_to(monitor)->connect_to(sk_notify);
+
+#if ENABLE_DEBUG_OUTPUTS
+  monitor->set_debug_output(batched(
+      g_sk_batcher,
+      new SKOutputFloat(e.debug_path(("anomaly." + k + ".sigma").c_str())),
+      SK_DEBUG_MIN_INTERVAL_MS));
+#endif
+
+  ConfigItem(monitor)
+      ->set_title(e.ui_title((String(label) + " Temperature Anomaly").c_str()))
+      ->set_description(
+          "Learns the normal temperature per RPM / load bin and notifies "
+          "on sustained deviations")
+      ->set_sort_order(e.sort_order(sort_order));
+
+  ConfigItem(sk_notify)
+      ->set_title(e.ui_title((String(label) + " Anomaly SK Path").c_str()))
+      ->set_sort_order(e.sort_order(sort_order + 1));
+
+  return monitor;
+}
+
+#endif  // ARDUINO
@@ -0,0 +1,142 @@
+#pragma once
+
+// ============================================================================
+// VesselStateListener — coalesced STW / SOG / AWS / AWA ingestion
+// ============================================================================
+//
+// • One owner for the four vessel paths the fuel model needs. Each path is
+//   a bare SKListener (SensESP dispatches per path) whose parse_value()
+//   stores one float — no LambdaTransform / observer chain per delta
+// • All four go out in SensESP's single subscribe message; the per-path
+//   period (SUBSCRIBE_PERIOD_MS) is the server-side rate hint
+// • Deltas that arrive together (one SK update usually carries several
+//   paths) are coalesced: VesselState is emitted once per event-loop tick
+//   at most, and no more often than min_period_ms (decimation for 10 Hz+
+//   servers) — the fuel model re-runs once per coalesced update
+// • VesselState.fresh marks the fields updated since the previous emit;
+//   staleness of the others is the consumer's hold logic (CombineLatest)
+// • SK paths stay editable via the original /config/inputs/* files
+// ============================================================================
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// State / coalescing (no SensESP dependency)
+// ============================================================================
+enum VesselField : uint8_t {
+  VESSEL_STW = 0,   // m/s
+  VESSEL_SOG,       // m/s
+  VESSEL_AWS,       // m/s
+  VESSEL_AWA,       // rad
+  VESSEL_NUM_FIELDS
+};
+
+struct VesselState {
+  float   value[VESSEL_NUM_FIELDS];
+  uint8_t fresh = 0;   // bit f set → value[f] updated since the last emit
+
+  VesselState() {
+    for (size_t f = 0; f < VESSEL_NUM_FIELDS; f++) value[f] = NAN;
+  }
+
+  bool is_fresh(VesselField f) const { return (fresh >> f) & 1u; }
+};
+
+class VesselStateCoalescer {
+ public:
+  explicit VesselStateCoalescer(uint32_t min_period_ms = 0)
+      : min_period_ms_(min_period_ms) {}
+
+  void update(VesselField f, float value) {
+    if (f >= VESSEL_NUM_FIELDS) return;
+    state_.value[f] = value;
+    state_.fresh |= static_cast<uint8_t>(1u << f);
+    updates_++;
+  }
+
+  // True (and the state in `out`) when something changed and the
+  // decimation period has passed; clears the fresh bits
+  bool take(uint32_t now_ms, VesselState& out) {
+    if (state_.fresh == 0) return false;
+    if (emitted_ && (now_ms - last_emit_ms_) < min_period_ms_) return false;
+
+    out           = state_;
+    state_.fresh  = 0;
+    last_emit_ms_ = now_ms;
+    emitted_      = true;
+    emits_++;
+    return true;
+  }
+
+  uint32_t updates() const { return updates_; }   // deltas parsed
+  uint32_t emits() const { return emits_; }       // coalesced notifications
+
+ private:
+  VesselState state_;
+  uint32_t    min_period_ms_;
+  uint32_t    last_emit_ms_ = 0;
+  bool        emitted_      = false;
+  uint32_t    updates_      = 0;
+  uint32_t    emits_        = 0;
+};
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+
+#include <sensesp/signalk/signalk_listener.h>
+#include <sensesp/system/valueproducer.h>
+
+#include "sensesp_app.h"
+
+using namespace sensesp;
+
+class VesselStateListener : public ValueProducer<VesselState> {
+ public:
+  static constexpr int SUBSCRIBE_PERIOD_MS = 1000;
+
+  explicit VesselStateListener(uint32_t min_period_ms = 1000)
+      : coalescer_(min_period_ms),
+        stw_(this, VESSEL_STW, "navigation.speedThroughWater", "/config/inputs/stw"),
+        sog_(this, VESSEL_SOG, "navigation.speedOverGround",   "/config/inputs/sog"),
+        aws_(this, VESSEL_AWS, "environment.wind.speedApparent", "/config/inputs/aws"),
+        awa_(this, VESSEL_AWA, "environment.wind.angleApparent", "/config/inputs/awa") {
+    sensesp_app->get_event_loop()->onTick([this]() { this->flush(); });
+  }
+
+  const VesselStateCoalescer& stats() const { return coalescer_; }
+
+ private:
+  class PathListener : public SKListener {
+   public:
+    PathListener(VesselStateListener* owner, VesselField field,
+                 const String& sk_path, const String& config_path)
+        : SKListener(sk_path, SUBSCRIBE_PERIOD_MS, config_path),
+          owner_(owner),
+          field_(field) {}
+
+    void parse_value(const JsonObject& json) override {
+      JsonVariant v = json["value"];
+      owner_->coalescer_.update(field_, v.is<float>() ? v.as<float>() : NAN);
+    }
+
+   private:
+    VesselStateListener* owner_;
+    VesselField          field_;
+  };
+
+  VesselStateCoalescer coalescer_;
+  PathListener         stw_;
+  PathListener         sog_;
+  PathListener         aws_;
+  PathListener         awa_;
+
+  void flush() {
+    VesselState s;
+    if (coalescer_.take(millis(), s)) this->emit(s);
+  }
+};
+
+#endif  // ARDUINO
@@ -0,0 +1,70 @@
+#pragma once
+
+// ============================================================================
+// Benchmark harness (host-native)
+// ============================================================================
+//
+// bench_run(name, ops, op) reports for one operation `float op(uint32_t i)`:
+//   • ns/op      — mean over `ops` back-to-back calls (after a warm-up)
+//   • max ns     — worst single call over LATENCY_SAMPLES individually
+//                  timed calls (includes ~20–50 ns of clock overhead)
+//   • allocs/op  — operator new calls per op (counted by the runner)
+// The op's return value is accumulated into a volatile sink so the
+// compiler cannot drop the work.
+// ============================================================================
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Incremented by the runner's global operator new
+extern size_t g_bench_allocs;
+
+struct BenchResult {
+  double ns_per_op     = 0.0;
+  double max_ns        = 0.0;
+  double allocs_per_op = 0.0;
+};
+
+static constexpr uint32_t LATENCY_SAMPLES = 20000;
+
+static volatile float g_bench_sink = 0.0f;
+
+template <typename Op>
+BenchResult bench_run(const char* name, uint32_t ops, Op op) {
+  typedef std::chrono::steady_clock Clock;
+  BenchResult r;
+
+  for (uint32_t i = 0; i < ops / 10; i++) {
+    g_bench_sink = g_bench_sink + op(i);   // warm caches / branch predictors
+  }
+
+  // Throughput + allocations
+  const size_t allocs0 = g_bench_allocs;
+  const Clock::time_point t0 = Clock::now();
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < ops; i++) {
+    acc += op(i);
+  }
+  const Clock::time_point t1 = Clock::now();
+  g_bench_sink = g_bench_sink + acc;
+
+  r.ns_per_op = std::chrono::duration<double, std::nano>(t1 - t0).count() / ops;
+  r.allocs_per_op =
+      static_cast<double>(g_bench_allocs - allocs0) / static_cast<double>(ops);
+
+  // Worst case: every call timed on its own
+  for (uint32_t i = 0; i < LATENCY_SAMPLES; i++) {
+    const Clock::time_point a = Clock::now();
+    g_bench_sink = g_bench_sink + op(i);
+    const Clock::time_point b = Clock::now();
+
+    const double ns = std::chrono::duration<double, std::nano>(b - a).count();
+    if (ns > r.max_ns) r.max_ns = ns;
+  }
+
+  printf("BENCH %-26s %10.1f ns/op %10.0f ns max %8.3f allocs/op\n",
+         name, r.ns_per_op, r.max_ns, r.allocs_per_op);
+  return r;
+}
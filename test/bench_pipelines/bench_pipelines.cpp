@@ -0,0 +1,194 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#include "../../src/engine_eval.h"
+#include "../../src/engine_model.h"
+#include "../../src/flat_curve.h"
+#include "../../src/rev_smoother.h"
+
+#include "bench_harness.h"
+
+// Host-native benchmarks for the signal pipelines (pio test -e native).
+// Timings are host numbers — compare before/after on the same machine;
+// allocation counts carry over to the target unchanged.
+
+// ============================================================================
+// Allocation counter
+// ============================================================================
+size_t g_bench_allocs = 0;
+
+void* operator new(size_t n) {
+    g_bench_allocs++;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+static constexpr uint32_t OPS = 1000000;
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// BENCH: Fuel model (EngineModel, underway with STW + wind correction)
+// ============================================================================
+
+struct ModelSink : public ValueConsumer<EngineModelOutput> {
+    void set(const EngineModelOutput& o) override { last = o; }
+    EngineModelOutput last;
+};
+
+void bench_engine_model_underway(void) {
+    static Linear use_stw(1.0f, 0.0f);
+    use_stw.set(1.0f);
+
+    static EngineModel model(&use_stw);
+    static ModelSink sink;
+    model.connect_to(&sink);
+
+    static EngineInputs in;
+    in[IN_STW_KTS] = 4.0f;    // below baseline → STW factor
+    in[IN_SOG_KTS] = 4.2f;
+    in[IN_AWS_KTS] = 18.0f;   // wind correction active
+    in[IN_AWA_RAD] = 0.6f;
+
+    const BenchResult r = bench_run("engine_model_underway", OPS,
+        [](uint32_t i) -> float {
+            in[IN_RPM] = 1000.0f + static_cast<float>(i % 2900);
+            model.set(in);
+            return sink.last.fuel_lph;
+        });
+
+    TEST_ASSERT_TRUE(std::isfinite(sink.last.fuel_lph));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocs_per_op);
+}
+
+// ============================================================================
+// BENCH: Fuel / load batch (engine_eval_batch, log replay; ns/op per batch)
+// ============================================================================
+
+static constexpr size_t BATCH = 1024;
+
+void bench_engine_eval_batch(void) {
+    static EngineCurveTable table;
+    TEST_ASSERT_TRUE(table.build_default());
+
+    static float rpm[BATCH], stw[BATCH], sog[BATCH], aws[BATCH], awa[BATCH];
+    static float fuel[BATCH], load[BATCH];
+    for (size_t i = 0; i < BATCH; i++) {
+        rpm[i] = static_cast<float>((i * 7) % 4000);
+        stw[i] = (i % 8) ? 4.0f : NAN;
+        sog[i] = 4.2f;
+        aws[i] = static_cast<float>(i % 30);
+        awa[i] = -3.1f + 0.006f * static_cast<float>(i);
+    }
+
+    static const EngineEvalConfig cfg;
+    const BenchResult r = bench_run("engine_eval_batch_1k", OPS / BATCH,
+        [](uint32_t i) -> float {
+            rpm[0] = static_cast<float>(i % 4000);
+            engine_eval_batch(table, cfg, EngineBatchInputs{rpm, stw, sog, aws, awa},
+                              EngineBatchOutputs{fuel, load}, BATCH);
+            return fuel[0] + load[BATCH - 1];
+        });
+
+    printf("BENCH %-26s %10.1f ns/sample\n", "engine_eval_batch",
+           r.ns_per_op / BATCH);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocs_per_op);
+}
+
+// ============================================================================
+// BENCH: RPM smoother (canonical rev/s, 20 Hz samples, 1 s window)
+// ============================================================================
+
+void bench_rev_smoother(void) {
+    static RevSmoother<32> smoother(1000, 4000);
+
+    const BenchResult r = bench_run("rev_smoother_20hz", OPS,
+        [](uint32_t i) -> float {
+            return smoother.update(30.0f + 0.1f * (i % 7), i * 50);
+        });
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocs_per_op);
+}
+
+// ============================================================================
+// BENCH: Curve interpolation (binary search vs dense LUT)
+// ============================================================================
+
+void bench_flat_curve_interpolate(void) {
+    const BenchResult r = bench_run("flat_curve_interpolate", OPS,
+        [](uint32_t i) -> float {
+            return baseline_fuel_curve.interpolate(static_cast<float>(i % 4000));
+        });
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocs_per_op);
+}
+
+void bench_uniform_lut_lookup(void) {
+    static UniformCurveLut<4096> lut;
+    lut.build(baseline_fuel_curve, 0.0f, 4000.0f);
+
+    const BenchResult r = bench_run("uniform_lut_lookup", OPS,
+        [](uint32_t i) -> float {
+            return lut.lookup(static_cast<float>(i % 4000));
+        });
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, baseline_fuel_curve.interpolate(2500.0f),
+                             lut.lookup(2500.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocs_per_op);
+}
+
+// ============================================================================
+// BENCH: Wind load factor
+// ============================================================================
+
+void bench_wind_load_factor(void) {
+    const BenchResult r = bench_run("wind_load_factor", OPS,
+        [](uint32_t i) -> float {
+            const float aws = 5.0f + static_cast<float>(i % 30);
+            const float awa = -3.1f + 0.01f * static_cast<float>(i % 620);
+            return wind_load_factor(aws, awa);
+        });
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.allocs_per_op);
+}
+
+// ============================================================================
+// MAIN - Run all benchmarks
+// ============================================================================
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    // Fuel model
+    RUN_TEST(bench_engine_model_underway);
+    RUN_TEST(bench_engine_eval_batch);
+
+    // RPM smoother
+    RUN_TEST(bench_rev_smoother);
+
+    // Curve interpolation
+    RUN_TEST(bench_flat_curve_interpolate);
+    RUN_TEST(bench_uniform_lut_lookup);
+
+    // Wind correction
+    RUN_TEST(bench_wind_load_factor);
+
+    return UNITY_END();
+}
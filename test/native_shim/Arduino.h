@@ -0,0 +1,42 @@
+#pragma once
+
+// ============================================================================
+// Native shim — the Arduino subset used by the pure pipeline headers
+// ============================================================================
+//
+// Only for [env:native] (benchmarks on the host). Time comes from the host
+// steady clock; String is a std::string with Arduino's const char* ctor.
+// ============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+class String : public std::string {
+ public:
+  String() {}
+  String(const char* s) : std::string(s ? s : "") {}
+  String(const std::string& s) : std::string(s) {}
+};
+
+inline uint32_t micros() {
+  static const auto t0 = std::chrono::steady_clock::now();
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - t0).count());
+}
+
+inline uint32_t millis() { return micros() / 1000; }
+
+inline void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+#ifndef constrain
+#define constrain(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+
+// Native shim: SensESP ValueConsumer<T> (set() only)
+
+namespace sensesp {
+
+template <typename T>
+class ValueConsumer {
+ public:
+  virtual ~ValueConsumer() {}
+  virtual void set(const T& value) { (void)value; }
+};
+
+}  // namespace sensesp
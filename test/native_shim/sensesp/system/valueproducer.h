@@ -0,0 +1,48 @@
+#pragma once
+
+// ============================================================================
+// Native shim: SensESP ValueProducer<T>
+// ============================================================================
+//
+// • emit() stores the value and calls each connected consumer's set()
+//   directly — no std::function observers, so benchmarks measure the
+//   transform itself, not SensESP's dispatch
+// • connect_to() allocates (vector growth) at setup, never per emit
+// ============================================================================
+
+#include <vector>
+
+#include "valueconsumer.h"
+
+namespace sensesp {
+
+template <typename T>
+class ValueProducer {
+ public:
+  ValueProducer() : output_() {}
+  explicit ValueProducer(const T& initial) : output_(initial) {}
+  virtual ~ValueProducer() {}
+
+  virtual const T& get() const { return output_; }
+
+  template <typename VConsumer>
+  VConsumer* connect_to(VConsumer* consumer) {
+    consumers_.push_back(consumer);
+    return consumer;
+  }
+
+  void emit(const T& value) {
+    output_ = value;
+    for (size_t i = 0; i < consumers_.size(); i++) {
+      consumers_[i]->set(value);
+    }
+  }
+
+ protected:
+  T output_;
+
+ private:
+  std::vector<ValueConsumer<T>*> consumers_;
+};
+
+}  // namespace sensesp
@@ -0,0 +1,24 @@
+#pragma once
+
+// Native shim: SensESP Linear (y = multiplier * x + offset)
+
+#include "transform.h"
+
+namespace sensesp {
+
+class Linear : public Transform<float, float> {
+ public:
+  Linear(float multiplier, float offset, const String& config_path = "")
+      : Transform<float, float>(config_path),
+        multiplier_(multiplier), offset_(offset) {}
+
+  void set(const float& input) override {
+    this->emit(multiplier_ * input + offset_);
+  }
+
+ private:
+  float multiplier_;
+  float offset_;
+};
+
+}  // namespace sensesp
@@ -0,0 +1,22 @@
+#pragma once
+
+// Native shim: SensESP Transform<C, P> (no config persistence)
+
+#include <Arduino.h>
+
+#include "../system/valueconsumer.h"
+#include "../system/valueproducer.h"
+
+namespace sensesp {
+
+template <typename C, typename P>
+class Transform : public ValueConsumer<C>, public ValueProducer<P> {
+ public:
+  explicit Transform(const String& config_path = "")
+      : config_path_(config_path) {}
+
+ protected:
+  String config_path_;
+};
+
+}  // namespace sensesp
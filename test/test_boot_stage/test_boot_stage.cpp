@@ -0,0 +1,140 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/boot_stage.h"
+#include "../../src/boot_cache.h"
+
+// Tests for the staged startup: deferred step release (network up or
+// timeout) and the build-bound NVS cache record framing.
+
+static const uint32_t TIMEOUT_MS = 10000;
+
+static const uint8_t BUILD_A[BOOT_CACHE_BUILD_ID_BYTES] = {1, 2, 3, 4, 5, 6, 7, 8};
+static const uint8_t BUILD_B[BOOT_CACHE_BUILD_ID_BYTES] = {1, 2, 3, 4, 5, 6, 7, 9};
+
+struct TestPayload {
+    uint32_t coeff_a;
+    uint32_t coeff_b;
+    uint8_t  rom[8];
+};
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Deferred steps
+// ============================================================================
+
+void test_steps_wait_for_network(void) {
+    DeferredBootQueue q(TIMEOUT_MS);
+    int runs = 0;
+    q.add("a", [&runs]() { runs++; });
+
+    TEST_ASSERT_NULL(q.poll(100, false));
+    TEST_ASSERT_NULL(q.poll(TIMEOUT_MS - 1, false));
+    TEST_ASSERT_EQUAL_INT(0, runs);
+    TEST_ASSERT_FALSE(q.released());
+
+    TEST_ASSERT_EQUAL_STRING("a", q.poll(1500, true));
+    TEST_ASSERT_EQUAL_INT(1, runs);
+    TEST_ASSERT_EQUAL_UINT32(1500, q.released_ms());
+    TEST_ASSERT_TRUE(q.done());
+}
+
+void test_timeout_releases_without_network(void) {
+    DeferredBootQueue q(TIMEOUT_MS);
+    int runs = 0;
+    q.add("a", [&runs]() { runs++; });
+
+    TEST_ASSERT_EQUAL_STRING("a", q.poll(TIMEOUT_MS, false));
+    TEST_ASSERT_EQUAL_INT(1, runs);
+}
+
+void test_one_step_per_poll_in_order(void) {
+    DeferredBootQueue q(TIMEOUT_MS);
+    int order[3] = {0, 0, 0};
+    int n = 0;
+    q.add("first",  [&]() { order[n++] = 1; });
+    q.add("second", [&]() { order[n++] = 2; });
+    q.add("third",  [&]() { order[n++] = 3; });
+
+    TEST_ASSERT_EQUAL_STRING("first", q.poll(2000, true));
+    TEST_ASSERT_EQUAL_INT(1, n);
+    TEST_ASSERT_EQUAL_STRING("second", q.poll(2020, true));
+    TEST_ASSERT_FALSE(q.done());
+    TEST_ASSERT_EQUAL_STRING("third", q.poll(2040, true));
+    TEST_ASSERT_NULL(q.poll(2060, true));
+
+    TEST_ASSERT_EQUAL_INT(1, order[0]);
+    TEST_ASSERT_EQUAL_INT(2, order[1]);
+    TEST_ASSERT_EQUAL_INT(3, order[2]);
+    TEST_ASSERT_TRUE(q.done());
+}
+
+// ============================================================================
+// TEST: Cache records
+// ============================================================================
+
+void test_record_roundtrip_for_same_build(void) {
+    BootCacheRecord<TestPayload> r;
+    memset(&r.payload, 0, sizeof(r.payload));
+    r.payload.coeff_a = 53840;
+    r.payload.coeff_b = 142;
+    r.payload.rom[0]  = 0x28;
+    r.seal(BUILD_A);
+
+    // As read back from NVS
+    BootCacheRecord<TestPayload> copy;
+    memcpy(static_cast<void*>(&copy), &r, sizeof(r));
+
+    TEST_ASSERT_TRUE(copy.valid(BUILD_A));
+    TEST_ASSERT_EQUAL_UINT32(53840, copy.payload.coeff_a);
+    TEST_ASSERT_EQUAL_UINT8(0x28, copy.payload.rom[0]);
+}
+
+void test_record_rejects_other_build_and_corruption(void) {
+    BootCacheRecord<TestPayload> r;
+    memset(&r.payload, 0, sizeof(r.payload));
+    r.payload.coeff_a = 53840;
+    r.seal(BUILD_A);
+
+    // Firmware update: recharacterize / search again
+    TEST_ASSERT_FALSE(r.valid(BUILD_B));
+
+    r.payload.coeff_a ^= 1;
+    TEST_ASSERT_FALSE(r.valid(BUILD_A));
+
+    // Never written (erased NVS reads back as zeros)
+    BootCacheRecord<TestPayload> empty;
+    memset(static_cast<void*>(&empty), 0, sizeof(empty));
+    TEST_ASSERT_FALSE(empty.valid(BUILD_A));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Deferred step tests
+    RUN_TEST(test_steps_wait_for_network);
+    RUN_TEST(test_timeout_releases_without_network);
+    RUN_TEST(test_one_step_per_poll_in_order);
+
+    // Cache record tests
+    RUN_TEST(test_record_roundtrip_for_same_build);
+    RUN_TEST(test_record_rejects_other_build_and_corruption);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,106 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/combine_latest.h"
+#include <cmath>
+
+// Tests for the CombineLatest input slots (hold timeouts, NaN ride-through,
+// expire values). Time is passed in — no event loop needed.
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Latest value
+// ============================================================================
+
+void test_unset_input_reads_expire_value(void) {
+    LatestSlots<2> s;
+    s.configure(0, 4000, 0.0f);
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.value(0, 1000));
+    TEST_ASSERT_TRUE(std::isnan(s.value(1, 1000)));
+}
+
+void test_latest_value_wins(void) {
+    LatestSlots<1> s;
+    s.configure(0, 4000);
+
+    s.update(0, 5.0f, 1000);
+    s.update(0, 5.5f, 1100);
+
+    TEST_ASSERT_EQUAL_FLOAT(5.5f, s.value(0, 1200));
+}
+
+// ============================================================================
+// TEST: Hold / expiry
+// ============================================================================
+
+void test_nan_rides_through_within_hold(void) {
+    LatestSlots<1> s;
+    s.configure(0, 4000);
+
+    s.update(0, 6.0f, 1000);
+    s.update(0, NAN, 2000);   // transient dropout
+
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, s.value(0, 4999));
+}
+
+void test_stale_value_expires(void) {
+    LatestSlots<2> s;
+    s.configure(0, 4000, 0.0f);   // RPM: engine off when stale
+    s.configure(1, 4000);         // STW: unknown when stale
+
+    s.update(0, 1800.0f, 1000);
+    s.update(1, 5.0f, 1000);
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, s.value(0, 5001));
+    TEST_ASSERT_TRUE(std::isnan(s.value(1, 5001)));
+
+    // Fresh value revives the input
+    s.update(1, 4.0f, 6000);
+    TEST_ASSERT_EQUAL_FLOAT(4.0f, s.value(1, 6000));
+}
+
+void test_snapshot_and_no_hold(void) {
+    LatestSlots<3> s;
+    s.configure(0, 0);        // never stale
+    s.configure(1, 1000);
+
+    s.update(0, 1.0f, 1000);
+    s.update(1, 2.0f, 1000);
+
+    const LatestValues<3> v = s.snapshot(100000);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, v[0]);
+    TEST_ASSERT_TRUE(std::isnan(v[1]));
+    TEST_ASSERT_TRUE(std::isnan(v[2]));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Latest value tests
+    RUN_TEST(test_unset_input_reads_expire_value);
+    RUN_TEST(test_latest_value_wins);
+
+    // Hold / expiry tests
+    RUN_TEST(test_nan_rides_through_within_hold);
+    RUN_TEST(test_stale_value_expires);
+    RUN_TEST(test_snapshot_and_no_hold);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
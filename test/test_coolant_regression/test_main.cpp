@@ -1,74 +1,68 @@
 #include <Arduino.h>
 #include <unity.h>
 
-// We want access to the coolant simulator math helpers.
-// Ensure the header content is enabled during unit tests.
-#ifndef COOLANT_SIMULATOR
-#define COOLANT_SIMULATOR 1
-#endif
+// The bench simulator drives the coolant ADC with the inverse of the
+// pipeline's own curve (sender_curves.h), so a commanded temperature must
+// read back as the same temperature. These tests pin that round trip.
 
-#include "coolant_simulator.h"
+#include "../../src/engine_simulator.h"
+#include "../../src/sender_curves.h"
 
-// If you later wrapped your simulator in a namespace, change calls like:
-//   ohms_for_temp(...) -> coolant_sim::ohms_for_temp(...)
-
-static void test_ohms_endpoints() {
-  // Endpoints from your curve table (should match closely)
-  TEST_ASSERT_FLOAT_WITHIN(0.5f, 1352.0f, ohms_for_temp(12.7f));
-  TEST_ASSERT_FLOAT_WITHIN(0.5f,  207.0f, ohms_for_temp(56.0f));
-  TEST_ASSERT_FLOAT_WITHIN(0.5f,   97.0f, ohms_for_temp(80.0f));
-  TEST_ASSERT_FLOAT_WITHIN(0.5f,   85.5f, ohms_for_temp(85.0f));
-  TEST_ASSERT_FLOAT_WITHIN(0.5f,   45.0f, ohms_for_temp(100.0f));
-  TEST_ASSERT_FLOAT_WITHIN(0.5f,   29.6f, ohms_for_temp(121.0f));
+static void test_inverse_hits_curve_points() {
+  // Anchors straight from kCoolantAdcToTempC
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.257f, coolant_adc_to_temp.inverse(121.0f));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.766f, coolant_adc_to_temp.inverse(80.0f));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.040f, coolant_adc_to_temp.inverse(60.0f));
+  TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.392f, coolant_adc_to_temp.inverse(10.0f));
 }
 
-static void test_ohms_monotonic_decreasing() {
-  // Hotter -> lower ohms (non-increasing)
-  float prev = ohms_for_temp(12.7f);
-  for (float t = 15.0f; t <= 95.0f; t += 5.0f) {
-    float now = ohms_for_temp(t);
-    TEST_ASSERT_TRUE_MESSAGE(now <= (prev + 1e-3f), "ohms should not increase as temp rises");
-    prev = now;
+static void test_round_trip_temperature() {
+  for (float t = 12.0f; t <= 120.0f; t += 1.0f) {
+    const float v = coolant_adc_to_temp.inverse(t);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, t, coolant_adc_to_temp.interpolate(v));
   }
 }
 
-static void test_adc_volts_sane_range() {
-  for (float t = 12.0f; t <= 95.0f; t += 5.0f) {
-    float v = adc_volts_for_temp(t);
-    TEST_ASSERT_TRUE_MESSAGE(v >= 0.0f, "ADC volts must be >= 0");
-    TEST_ASSERT_TRUE_MESSAGE(v <= 3.3f, "ADC volts must be <= 3.3");
+static void test_volts_inside_valid_domain() {
+  // Out-of-table temperatures clamp to the end points, never to NaN volts
+  for (float t = 0.0f; t <= 130.0f; t += 5.0f) {
+    const float v = coolant_adc_to_temp.inverse(t);
+    TEST_ASSERT_TRUE_MESSAGE(v >= ADC_MIN_VALID_V, "ADC volts below valid domain");
+    TEST_ASSERT_TRUE_MESSAGE(v <= ADC_MAX_VALID_V, "ADC volts above valid domain");
   }
 }
 
-static void test_adc_volts_monotonic_decreasing() {
-  // Hotter -> lower sender resistance -> lower sender node voltage -> lower ADC volts
-  float prev = adc_volts_for_temp(12.7f);
-  for (float t = 15.0f; t <= 95.0f; t += 5.0f) {
-    float now = adc_volts_for_temp(t);
+static void test_volts_monotonic_decreasing() {
+  // Hotter -> lower sender resistance -> lower ADC volts
+  float prev = coolant_adc_to_temp.inverse(10.0f);
+  for (float t = 15.0f; t <= 120.0f; t += 5.0f) {
+    const float now = coolant_adc_to_temp.inverse(t);
     TEST_ASSERT_TRUE_MESSAGE(now <= (prev + 1e-4f), "ADC volts should not increase as temp rises");
     prev = now;
   }
 }
 
-static void test_adc_known_points() {
-  // These anchors validate the full math:
-  // Vsupply=13.5V, Rgauge=1180Ω, divider gain=5.0
-  // Expected ADC-pin volts (approx):
-  TEST_ASSERT_FLOAT_WITHIN(0.03f, 1.44f, adc_volts_for_temp(12.7f));
-  TEST_ASSERT_FLOAT_WITHIN(0.03f, 0.403f, adc_volts_for_temp(56.0f));
-  TEST_ASSERT_FLOAT_WITHIN(0.03f, 0.205f, adc_volts_for_temp(80.0f));
-  TEST_ASSERT_FLOAT_WITHIN(0.03f, 0.099f, adc_volts_for_temp(100.0f));
+static void test_dac_and_pwm_quantization() {
+  // 8-bit DAC (12.9 mV steps): 80 °C reads back within 1 °C
+  const uint32_t code = sim_volts_code(coolant_adc_to_temp.inverse(80.0f), 8);
+  const float    v    = code * 3.3f / 255.0f;
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 80.0f, coolant_adc_to_temp.interpolate(v));
+
+  // 10-bit oil PWM: 300 kPa within 2 kPa
+  const uint32_t duty = sim_volts_code(oil_adc_to_pa.inverse(300000.0f), 10);
+  TEST_ASSERT_FLOAT_WITHIN(2000.0f, 300000.0f,
+                           oil_adc_to_pa.interpolate(duty * 3.3f / 1023.0f));
 }
 
 void setup() {
   delay(1500); // give Serial time to come up on some boards
 
   UNITY_BEGIN();
-  RUN_TEST(test_ohms_endpoints);
-  RUN_TEST(test_ohms_monotonic_decreasing);
-  RUN_TEST(test_adc_volts_sane_range);
-  RUN_TEST(test_adc_volts_monotonic_decreasing);
-  RUN_TEST(test_adc_known_points);
+  RUN_TEST(test_inverse_hits_curve_points);
+  RUN_TEST(test_round_trip_temperature);
+  RUN_TEST(test_volts_inside_valid_domain);
+  RUN_TEST(test_volts_monotonic_decreasing);
+  RUN_TEST(test_dac_and_pwm_quantization);
   UNITY_END();
 }
 
@@ -0,0 +1,273 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/data_log.h"
+
+// Tests for the engine data ring log (RAM-backed NOR flash)
+
+// NOR semantics: erase → 0xFF, program can only clear bits
+class RamFlash : public JournalFlash {
+ public:
+    void reset(size_t sectors) {
+        size_   = sectors * SECTOR_BYTES;
+        writes  = 0;
+        memset(mem_, 0x00, sizeof(mem_));   // unerased garbage
+    }
+
+    size_t size() const override { return size_; }
+
+    bool read(size_t off, void* dst, size_t len) override {
+        if (off + len > size_) return false;
+        memcpy(dst, mem_ + off, len);
+        return true;
+    }
+
+    bool write(size_t off, const void* src, size_t len) override {
+        if (off + len > size_) return false;
+        const uint8_t* s = static_cast<const uint8_t*>(src);
+        for (size_t i = 0; i < len; i++) mem_[off + i] &= s[i];
+        writes++;
+        return true;
+    }
+
+    bool erase_sector(size_t off) override {
+        if (off % SECTOR_BYTES || off >= size_) return false;
+        memset(mem_ + off, 0xFF, SECTOR_BYTES);
+        return true;
+    }
+
+    uint8_t* raw(size_t off) { return mem_ + off; }
+
+    int writes = 0;
+
+ private:
+    size_t  size_ = 0;
+    uint8_t mem_[3 * SECTOR_BYTES];
+};
+
+// Static: too large for the test task stack
+static RamFlash ram_flash;
+static RamFlash* flash = &ram_flash;
+static LogRecord out[400];
+
+static LogRecord make_record(uint32_t i) {
+    LogRecord r;
+    memset(&r, 0xFF, sizeof(r));
+    r.time_s  = i;
+    r.time_ms = 0;
+    r.flags   = 0;
+    r.rev_s   = LogRecord::scale(i * 0.01f, LOG_RES_REV_S);
+    return r;
+}
+
+void setUp(void) {
+    flash->reset(3);
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Record
+// ============================================================================
+
+void test_scale_round_trip_and_na(void) {
+    const uint16_t k = LogRecord::scale(363.15f, LOG_RES_TEMP);
+
+    TEST_ASSERT_EQUAL(36315, k);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 363.15f, LogRecord::unscale(k, LOG_RES_TEMP));
+    TEST_ASSERT_EQUAL(LogRecord::NA, LogRecord::scale(NAN, LOG_RES_TEMP));
+    TEST_ASSERT_EQUAL(LogRecord::NA, LogRecord::scale(-1000.0f, LOG_RES_OIL));
+    TEST_ASSERT_TRUE(std::isnan(LogRecord::unscale(LogRecord::NA, LOG_RES_OIL)));
+}
+
+// ============================================================================
+// TEST: Write / Read
+// ============================================================================
+
+void test_records_read_back_in_order(void) {
+    RingLog log(flash);
+    TEST_ASSERT_TRUE(log.begin());
+
+    for (uint32_t i = 1; i <= 20; i++) {
+        TEST_ASSERT_TRUE(log.append(make_record(i)));
+    }
+    log.flush();
+
+    RingLog::Cursor c = log.oldest();
+    TEST_ASSERT_EQUAL(20, log.read(c, out, 400));
+    for (uint32_t i = 0; i < 20; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i + 1, out[i].time_s);
+    }
+    TEST_ASSERT_EQUAL(0, log.read(c, out, 400));
+}
+
+void test_programs_whole_pages(void) {
+    RingLog log(flash);
+    log.begin();
+
+    // Slot 0 is the header → the first page holds 7 records
+    for (uint32_t i = 1; i <= 6; i++) log.append(make_record(i));
+    TEST_ASSERT_EQUAL(1, flash->writes);   // header only, records in RAM
+
+    log.append(make_record(7));
+    TEST_ASSERT_EQUAL(2, flash->writes);   // one page program
+
+    for (uint32_t i = 8; i <= 15; i++) log.append(make_record(i));
+    TEST_ASSERT_EQUAL(3, flash->writes);
+}
+
+void test_resume_after_reboot(void) {
+    RingLog log(flash);
+    log.begin();
+    for (uint32_t i = 1; i <= 10; i++) log.append(make_record(i));
+    log.flush();
+
+    RingLog rebooted(flash);
+    rebooted.begin();
+    for (uint32_t i = 11; i <= 15; i++) rebooted.append(make_record(i));
+    rebooted.flush();
+
+    RingLog::Cursor c = rebooted.oldest();
+    TEST_ASSERT_EQUAL(15, rebooted.read(c, out, 400));
+    TEST_ASSERT_EQUAL_UINT32(1, out[0].time_s);
+    TEST_ASSERT_EQUAL_UINT32(15, out[14].time_s);
+}
+
+// ============================================================================
+// TEST: Range (store-and-forward)
+// ============================================================================
+
+void test_range_returns_records_between_marks(void) {
+    RingLog log(flash);
+    log.begin();
+    for (uint32_t i = 1; i <= 10; i++) log.append(make_record(i));
+
+    const RingLog::Mark from = log.mark();
+    for (uint32_t i = 11; i <= 15; i++) log.append(make_record(i));
+    log.flush();
+    const RingLog::Mark to = log.mark();
+    for (uint32_t i = 16; i <= 20; i++) log.append(make_record(i));
+    log.flush();
+
+    RingLog::Cursor c = log.range(from, to);
+    TEST_ASSERT_EQUAL(5, log.read(c, out, 400));
+    TEST_ASSERT_EQUAL_UINT32(11, out[0].time_s);
+    TEST_ASSERT_EQUAL_UINT32(15, out[4].time_s);
+    TEST_ASSERT_EQUAL(0, log.read(c, out, 400));
+}
+
+void test_range_spans_sectors(void) {
+    RingLog log(flash);
+    log.begin();
+
+    const uint32_t per = RingLog::RECORDS_PER_SECTOR;
+    for (uint32_t i = 1; i <= per - 2; i++) log.append(make_record(i));
+
+    const RingLog::Mark from = log.mark();
+    for (uint32_t i = per - 1; i <= per + 10; i++) log.append(make_record(i));
+    log.flush();
+
+    // Read in small batches, as the replay does
+    RingLog::Cursor c = log.range(from, log.mark());
+    size_t total = 0;
+    size_t n;
+    while ((n = log.read(c, out + total, 4)) > 0) total += n;
+
+    TEST_ASSERT_EQUAL(12, total);
+    TEST_ASSERT_EQUAL_UINT32(per - 1, out[0].time_s);
+    TEST_ASSERT_EQUAL_UINT32(per + 10, out[11].time_s);
+}
+
+void test_until_snapshot_excludes_later_records(void) {
+    RingLog log(flash);
+    log.begin();
+    for (uint32_t i = 1; i <= 12; i++) log.append(make_record(i));
+    log.flush();
+
+    // Snapshot, then keep recording while it is read back
+    RingLog::Cursor c = log.until(log.mark());
+    for (uint32_t i = 13; i <= 20; i++) log.append(make_record(i));
+    log.flush();
+
+    TEST_ASSERT_EQUAL(12, log.read(c, out, 400));
+    TEST_ASSERT_EQUAL_UINT32(1, out[0].time_s);
+    TEST_ASSERT_EQUAL_UINT32(12, out[11].time_s);
+    TEST_ASSERT_EQUAL(0, log.read(c, out, 400));
+}
+
+// ============================================================================
+// TEST: Ring / Power Fail
+// ============================================================================
+
+void test_ring_overwrites_oldest_sector(void) {
+    RingLog log(flash);
+    log.begin();
+
+    const uint32_t per = RingLog::RECORDS_PER_SECTOR;
+    for (uint32_t i = 1; i <= 3 * per + 5; i++) log.append(make_record(i));
+    log.flush();
+
+    // Sector 0 re-opened: the first 127 records are gone
+    RingLog::Cursor c = log.oldest();
+    const size_t n = log.read(c, out, 400);
+
+    TEST_ASSERT_EQUAL(2 * per + 5, n);
+    TEST_ASSERT_EQUAL_UINT32(per + 1, out[0].time_s);
+    TEST_ASSERT_EQUAL_UINT32(3 * per + 5, out[n - 1].time_s);
+}
+
+void test_torn_record_skipped(void) {
+    RingLog log(flash);
+    log.begin();
+    for (uint32_t i = 1; i <= 7; i++) log.append(make_record(i));   // page 0
+
+    flash->raw(3 * RingLog::RECORD_BYTES)[4] ^= 0x01;   // corrupt record 3
+
+    RingLog::Cursor c = log.oldest();
+    TEST_ASSERT_EQUAL(6, log.read(c, out, 400));
+    TEST_ASSERT_EQUAL_UINT32(2, out[1].time_s);
+    TEST_ASSERT_EQUAL_UINT32(4, out[2].time_s);
+}
+
+void test_too_small_flash_rejected(void) {
+    flash->reset(1);
+    RingLog log(flash);
+
+    TEST_ASSERT_FALSE(log.begin());
+    TEST_ASSERT_FALSE(log.append(make_record(1)));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Record tests
+    RUN_TEST(test_scale_round_trip_and_na);
+
+    // Write / read tests
+    RUN_TEST(test_records_read_back_in_order);
+    RUN_TEST(test_programs_whole_pages);
+    RUN_TEST(test_resume_after_reboot);
+
+    // Range tests
+    RUN_TEST(test_range_returns_records_between_marks);
+    RUN_TEST(test_range_spans_sectors);
+    RUN_TEST(test_until_snapshot_excludes_later_records);
+
+    // Ring / power fail tests
+    RUN_TEST(test_ring_overwrites_oldest_sector);
+    RUN_TEST(test_torn_record_skipped);
+    RUN_TEST(test_too_small_flash_rejected);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,192 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/engine_eval.h"
+#include <cmath>
+
+// Tests for the pure fuel / load model (engine_eval.h): single sample,
+// structure-of-arrays batch, and the shared-axis curve table.
+
+static EngineCurveTable table;
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+static EngineModelOutput eval(float rpm, float stw, float sog,
+                              float aws = NAN, float awa = NAN,
+                              bool use_stw = true) {
+    EngineEvalConfig cfg;
+    cfg.use_stw = use_stw;
+    return engine_eval(table, cfg, rpm, stw, sog, aws, awa);
+}
+
+// ============================================================================
+// TEST: Engine off / docked
+// ============================================================================
+
+void test_engine_off_zero_fuel_and_load(void) {
+    const float rpms[] = { 0.0f, 400.0f, -10.0f, NAN };
+
+    for (float rpm : rpms) {
+        const EngineModelOutput o = eval(rpm, 5.0f, 5.0f);
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, o.fuel_lph);
+        TEST_ASSERT_EQUAL_FLOAT(0.0f, engine_load_fraction(o));
+        TEST_ASSERT_FALSE(std::isnan(o.rpm));
+    }
+}
+
+void test_docked_uses_idle_curve(void) {
+    // Idle: 0.6 L/h at 800 RPM → 1.4 L/h at 3600 RPM
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.6f, eval(800.0f, NAN, 0.1f).fuel_lph);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, eval(2200.0f, NAN, 0.1f).fuel_lph);
+
+    // STW at the dock counts only with "use STW" on
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, eval(2200.0f, 0.0f, NAN).fuel_lph);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.85f,
+                             eval(2200.0f, 0.0f, NAN, NAN, NAN, false).fuel_lph);
+}
+
+// ============================================================================
+// TEST: Underway
+// ============================================================================
+
+void test_underway_follows_baseline_curves(void) {
+    const EngineModelOutput o = eval(2500.0f, NAN, NAN);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.60f, o.fuel_lph);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 6.40f, o.expected_stw_kts);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 25.15f, o.max_kW);   // 2400 ↔ 2800
+
+    // 2.6 L/h × 0.84 kg/L / 240 g/kWh = 9.1 kW
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 9.1f / 25.15f, engine_load_fraction(o));
+
+    // Above the last breakpoint: hold last value
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 29.83f, eval(4500.0f, NAN, NAN).max_kW);
+}
+
+void test_stw_shortfall_and_wind_raise_fuel(void) {
+    // 2000 RPM: base 1.5 L/h, baseline STW 4.5 kts, rated cap 1.8 L/h
+    const float expected = 1.5f * powf(4.5f / 4.0f, 0.6f);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, expected, eval(2000.0f, 4.0f, 4.2f).fuel_lph);
+
+    // "Use STW" off, or an implausible STW → no correction
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.5f,
+                             eval(2000.0f, 4.0f, 4.2f, NAN, NAN, false).fuel_lph);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.5f, eval(2000.0f, 0.5f, 4.2f).fuel_lph);
+
+    // Head wind, half strength: × 1.15
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.725f,
+                             eval(2000.0f, NAN, 4.2f, 18.5f, 0.0f).fuel_lph);
+
+    // Full head wind would exceed the rated curve → capped
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.8f,
+                             eval(2000.0f, NAN, 4.2f, 30.0f, 0.0f).fuel_lph);
+}
+
+void test_inline_math_matches_libm(void) {
+    for (int i = 0; i <= 1000; i++) {
+        const float x = 3.14159265f * i / 1000.0f;
+        float c, s;
+        cos_sin_half_turn(x, c, s);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, cosf(x), c);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, sinf(x), s);
+
+        const float r = 1.0f + 2.2f * i / 1000.0f;
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, powf(r, 0.6f), pow_0_6(r));
+    }
+}
+
+// ============================================================================
+// TEST: Batch
+// ============================================================================
+
+void test_batch_matches_single_sample(void) {
+    static const size_t N = 64;
+    float rpm[N], stw[N], sog[N], aws[N], awa[N], fuel[N], load[N];
+
+    for (size_t i = 0; i < N; i++) {
+        rpm[i] = (i % 11 == 0) ? NAN : static_cast<float>(i * 65);
+        stw[i] = (i % 5 == 0) ? NAN : 0.15f * static_cast<float>(i % 40);
+        sog[i] = (i % 7 == 0) ? NAN : 6.0f - 0.1f * static_cast<float>(i % 60);
+        aws[i] = (i % 3 == 0) ? NAN : static_cast<float>(i % 35);
+        awa[i] = -3.0f + 0.1f * static_cast<float>(i % 60);
+    }
+
+    for (int use_stw = 0; use_stw < 2; use_stw++) {
+        EngineEvalConfig cfg;
+        cfg.use_stw = use_stw != 0;
+
+        const EngineBatchInputs  in  = { rpm, stw, sog, aws, awa };
+        const EngineBatchOutputs out = { fuel, load };
+        engine_eval_batch(table, cfg, in, out, N);
+
+        for (size_t i = 0; i < N; i++) {
+            const EngineModelOutput o =
+                engine_eval(table, cfg, rpm[i], stw[i], sog[i], aws[i], awa[i]);
+            // libm (single) vs. inline cos / sin / x^0.6 (batch)
+            TEST_ASSERT_FLOAT_WITHIN(1e-5f, o.fuel_lph, fuel[i]);
+            TEST_ASSERT_FLOAT_WITHIN(1e-5f, engine_load_fraction(o), load[i]);
+            TEST_ASSERT_FALSE(std::isnan(fuel[i]));
+            TEST_ASSERT_FALSE(std::isnan(load[i]));
+        }
+    }
+}
+
+// ============================================================================
+// TEST: Curve table
+// ============================================================================
+
+void test_curve_table_reports_overflow(void) {
+    static CurvePoint pts[40];
+    for (int i = 0; i < 40; i++) {
+        pts[i].x = 100.0f * (i + 1);
+        pts[i].y = 0.1f * i;
+    }
+    const FlatCurve wide(pts);
+
+    EngineCurveTable t;
+    TEST_ASSERT_FALSE(t.build(wide, baseline_fuel_curve, rated_fuel_curve,
+                              idle_fuel_curve, max_power_curve));
+    TEST_ASSERT_EQUAL(EngineCurveTable::MAX_AXIS_POINTS, t.size());
+    TEST_ASSERT_TRUE(t.dropped() > 0);
+
+    TEST_ASSERT_TRUE(table.size() >= 2);
+    TEST_ASSERT_EQUAL(0, table.dropped());
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    table.build_default();
+
+    UNITY_BEGIN();
+
+    // Engine off / docked tests
+    RUN_TEST(test_engine_off_zero_fuel_and_load);
+    RUN_TEST(test_docked_uses_idle_curve);
+
+    // Underway tests
+    RUN_TEST(test_underway_follows_baseline_curves);
+    RUN_TEST(test_stw_shortfall_and_wind_raise_fuel);
+    RUN_TEST(test_inline_math_matches_libm);
+
+    // Batch tests
+    RUN_TEST(test_batch_matches_single_sample);
+
+    // Curve table tests
+    RUN_TEST(test_curve_table_reports_overflow);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,168 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/engine_instance.h"
+#include <cstring>
+
+// Tests for the per-engine Signal K / config / NVS naming. Engine 0 with
+// the id "engine" must produce exactly the single-engine names.
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Single-engine (legacy) names
+// ============================================================================
+
+void test_default_engine_keeps_single_engine_names(void) {
+    EngineNaming e(LEGACY_ENGINE_ID, 0);
+    char buf[96];
+
+    TEST_ASSERT_TRUE(e.primary());
+    TEST_ASSERT_TRUE(e.legacy_paths());
+
+    TEST_ASSERT_TRUE(e.sk(buf, sizeof(buf), "revolutions"));
+    TEST_ASSERT_EQUAL_STRING("propulsion.engine.revolutions", buf);
+
+    TEST_ASSERT_TRUE(e.notification(buf, sizeof(buf), "coolantTemperature"));
+    TEST_ASSERT_EQUAL_STRING("notifications.propulsion.engine.coolantTemperature", buf);
+
+    TEST_ASSERT_TRUE(e.debug(buf, sizeof(buf), "engine.rpm"));
+    TEST_ASSERT_EQUAL_STRING("debug.engine.rpm", buf);
+
+    TEST_ASSERT_TRUE(e.config(buf, sizeof(buf), "/config/sensors/rpm/pcnt"));
+    TEST_ASSERT_EQUAL_STRING("/config/sensors/rpm/pcnt", buf);
+
+    TEST_ASSERT_TRUE(e.nvs(buf, sizeof(buf), "engine_runtime"));
+    TEST_ASSERT_EQUAL_STRING("engine_runtime", buf);
+
+    TEST_ASSERT_TRUE(e.title(buf, sizeof(buf), "Fuel"));
+    TEST_ASSERT_EQUAL_STRING("Fuel", buf);
+    TEST_ASSERT_EQUAL(750, e.sort_order(750));
+}
+
+// ============================================================================
+// TEST: Second engine names
+// ============================================================================
+
+void test_second_engine_paths_use_its_id(void) {
+    EngineNaming e("starboard", 1);
+    char buf[96];
+
+    TEST_ASSERT_FALSE(e.primary());
+    TEST_ASSERT_FALSE(e.legacy_paths());
+
+    TEST_ASSERT_TRUE(e.sk(buf, sizeof(buf), "fuel.rate"));
+    TEST_ASSERT_EQUAL_STRING("propulsion.starboard.fuel.rate", buf);
+
+    TEST_ASSERT_TRUE(e.notification(buf, sizeof(buf), "oilPressure"));
+    TEST_ASSERT_EQUAL_STRING("notifications.propulsion.starboard.oilPressure", buf);
+
+    TEST_ASSERT_TRUE(e.debug(buf, sizeof(buf), "engine.rpm"));
+    TEST_ASSERT_EQUAL_STRING("debug.starboard.engine.rpm", buf);
+}
+
+void test_second_engine_config_paths_are_scoped(void) {
+    EngineNaming e("starboard", 1);
+    char buf[96];
+
+    TEST_ASSERT_TRUE(e.config(buf, sizeof(buf), "/config/sensors/rpm/pcnt"));
+    TEST_ASSERT_EQUAL_STRING("/config/starboard/sensors/rpm/pcnt", buf);
+
+    // Paths outside /config are moved under it
+    TEST_ASSERT_TRUE(e.config(buf, sizeof(buf), "/Engine/OilPressure/ADC"));
+    TEST_ASSERT_EQUAL_STRING("/config/starboard/Engine/OilPressure/ADC", buf);
+
+    TEST_ASSERT_TRUE(e.title(buf, sizeof(buf), "Fuel"));
+    TEST_ASSERT_EQUAL_STRING("starboard: Fuel", buf);
+    TEST_ASSERT_EQUAL(750 + ENGINE_SORT_STRIDE, e.sort_order(750));
+}
+
+void test_profiler_stage_names_per_engine(void) {
+    // The profiler merges equal stage names: engines must not collide
+    EngineNaming e0(LEGACY_ENGINE_ID, 0);
+    EngineNaming e1("starboard", 1);
+    char buf[PERF_NAME_MAX_LEN];
+
+    TEST_ASSERT_TRUE(e0.perf(buf, sizeof(buf), "rpm_smooth"));
+    TEST_ASSERT_EQUAL_STRING("rpm_smooth", buf);
+
+    TEST_ASSERT_TRUE(e1.perf(buf, sizeof(buf), "rpm_smooth"));
+    TEST_ASSERT_EQUAL_STRING("starboard.rpm_smooth", buf);
+
+    // Longest id + longest stage name in the tree still fits
+    EngineNaming e2("0123456789abcdef", 1);
+    TEST_ASSERT_TRUE(e2.perf(buf, sizeof(buf), "thermal_anomaly"));
+}
+
+// ============================================================================
+// TEST: NVS names and truncation
+// ============================================================================
+
+void test_nvs_names_get_index_and_length_limit(void) {
+    EngineNaming e("port", 1);
+    char buf[32];
+
+    TEST_ASSERT_TRUE(e.nvs(buf, sizeof(buf), "engine_runtime"));
+    TEST_ASSERT_EQUAL_STRING("engine_runtime1", buf);
+    TEST_ASSERT_EQUAL(NVS_NAME_MAX_LEN, strlen(buf));
+
+    // 15-character base name + index no longer fits an NVS key
+    TEST_ASSERT_FALSE(e.nvs(buf, sizeof(buf), "anomaly_coolant"));
+
+    // Too small an output buffer is reported, result still terminated
+    char small[12];
+    TEST_ASSERT_FALSE(e.sk(small, sizeof(small), "revolutions"));
+    TEST_ASSERT_EQUAL(sizeof(small) - 1, strlen(small));
+}
+
+// ============================================================================
+// TEST: Engine id validation
+// ============================================================================
+
+void test_engine_id_validation(void) {
+    TEST_ASSERT_TRUE(engine_id_valid("engine"));
+    TEST_ASSERT_TRUE(engine_id_valid("port"));
+    TEST_ASSERT_TRUE(engine_id_valid("wing_2"));
+    TEST_ASSERT_TRUE(engine_id_valid("0123456789abcdef"));     // 16 chars
+
+    TEST_ASSERT_FALSE(engine_id_valid(nullptr));
+    TEST_ASSERT_FALSE(engine_id_valid(""));
+    TEST_ASSERT_FALSE(engine_id_valid("0123456789abcdefg"));   // 17 chars
+    TEST_ASSERT_FALSE(engine_id_valid("port.main"));           // path separator
+    TEST_ASSERT_FALSE(engine_id_valid("star board"));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Single-engine names
+    RUN_TEST(test_default_engine_keeps_single_engine_names);
+
+    // Second engine names
+    RUN_TEST(test_second_engine_paths_use_its_id);
+    RUN_TEST(test_second_engine_config_paths_are_scoped);
+    RUN_TEST(test_profiler_stage_names_per_engine);
+
+    // NVS names and truncation
+    RUN_TEST(test_nvs_names_get_index_and_length_limit);
+
+    // Engine id validation
+    RUN_TEST(test_engine_id_validation);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,163 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/engine_simulator.h"
+#include <cmath>
+#include <cstring>
+
+// Tests for the bench simulator's profiles, log replay pacing and the
+// step-settle / missed-edge measurements (no LEDC / DAC involved).
+
+static const float TEETH = 116.0f;
+
+static LogRecord make_record(uint32_t time_s, uint16_t time_ms, float rev_s) {
+    LogRecord r;
+    memset(&r, 0xFF, sizeof(r));
+    r.time_s    = time_s;
+    r.time_ms   = time_ms;
+    r.flags     = 0;
+    r.rev_s     = LogRecord::scale(rev_s, LOG_RES_REV_S);
+    r.coolant_K = LogRecord::scale(353.15f, LOG_RES_TEMP);
+    r.oil_hPa   = LogRecord::scale(300000.0f, LOG_RES_OIL);
+    return r;
+}
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Profiles
+// ============================================================================
+
+void test_sweep_profile_ramps_rpm_and_coolant(void) {
+    SimTarget t0 = sim_profile_target(SIM_SWEEP, 0, TEETH);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f / 60.0f, t0.rev_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 273.15f + 12.0f, t0.coolant_K);
+
+    SimTarget mid = sim_profile_target(SIM_SWEEP, 5000, TEETH);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1750.0f / 60.0f, mid.rev_s);
+    TEST_ASSERT_TRUE(mid.oil_Pa > t0.oil_Pa);
+
+    // RPM sawtooth restarts after 10 s
+    SimTarget wrap = sim_profile_target(SIM_SWEEP, 10000, TEETH);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.0f / 60.0f, wrap.rev_s);
+}
+
+void test_stress_profiles(void) {
+    // Max RPM: 7 kHz tooth edges
+    SimTarget max = sim_profile_target(SIM_MAX_RPM, 123456, TEETH);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, SIM_MAX_EDGE_HZ, max.rev_s * TEETH);
+
+    // Throttle steps: low / high every 3 s
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 800.0f / 60.0f,
+                             sim_profile_target(SIM_THROTTLE_STEPS, 2999, TEETH).rev_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 3000.0f / 60.0f,
+                             sim_profile_target(SIM_THROTTLE_STEPS, 3000, TEETH).rev_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 800.0f / 60.0f,
+                             sim_profile_target(SIM_THROTTLE_STEPS, 6000, TEETH).rev_s);
+
+    // Replay is not a synthetic profile
+    TEST_ASSERT_TRUE(std::isnan(sim_profile_target(SIM_LOG_REPLAY, 0, TEETH).rev_s));
+}
+
+// ============================================================================
+// TEST: Log replay
+// ============================================================================
+
+void test_record_target_and_pacing(void) {
+    const LogRecord a = make_record(100, 0, 20.0f);
+    const LogRecord b = make_record(100, 250, NAN);   // stopped
+    const LogRecord c = make_record(3600, 0, 20.0f);  // long gap
+    const LogRecord d = make_record(1, 0, 20.0f);     // reboot (uptime clock)
+
+    SimTarget t = sim_record_target(a);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, t.rev_s);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 353.15f, t.coolant_K);
+    TEST_ASSERT_FLOAT_WITHIN(100.0f, 300000.0f, t.oil_Pa);
+    TEST_ASSERT_TRUE(std::isnan(sim_record_target(b).rev_s));
+
+    TEST_ASSERT_EQUAL_UINT32(250, sim_record_gap_ms(a, b, 2000));
+    TEST_ASSERT_EQUAL_UINT32(2000, sim_record_gap_ms(b, c, 2000));
+    TEST_ASSERT_EQUAL_UINT32(2000, sim_record_gap_ms(c, d, 2000));
+}
+
+void test_output_codes(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, sim_volts_code(0.0f, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, sim_volts_code(NAN, 8));
+    TEST_ASSERT_EQUAL_UINT32(255, sim_volts_code(3.3f, 8));
+    TEST_ASSERT_EQUAL_UINT32(255, sim_volts_code(5.0f, 8));
+    TEST_ASSERT_EQUAL_UINT32(512, sim_volts_code(1.65f, 10));
+}
+
+// ============================================================================
+// TEST: Measurements
+// ============================================================================
+
+void test_step_response_settle_time(void) {
+    StepResponse s(0.02f, 5000);
+
+    s.command(800.0f / 60.0f, 0);
+    s.measure(800.0f / 60.0f, 100);
+    s.command(3000.0f / 60.0f, 3000);
+    s.measure(30.0f, 3200);                 // still accelerating
+    s.measure(49.5f, 3450);                 // within 2 %
+    s.command(3010.0f / 60.0f, 3500);       // < 2 %: same step
+
+    TEST_ASSERT_EQUAL_UINT32(2, s.stats().count);
+    TEST_ASSERT_EQUAL_UINT32(100, s.stats().min);
+    TEST_ASSERT_EQUAL_UINT32(450, s.stats().max);
+
+    // Never reaches the target → counted as unsettled after the timeout
+    s.command(10.0f, 10000);
+    s.measure(20.0f, 15001);
+    TEST_ASSERT_EQUAL_UINT32(1, s.unsettled());
+    TEST_ASSERT_EQUAL_UINT32(2, s.stats().count);
+}
+
+void test_edge_audit_counts_missed_edges(void) {
+    EdgeAudit a;
+
+    a.command(7000.0f, 0);
+    a.measure(6993.0f, 0);      // 0.1 % of the edges not counted
+    a.advance(10000);
+
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 70000.0f, a.commanded());
+    TEST_ASSERT_EQUAL(70, a.missed());
+
+    a.reset();
+    a.measure(7100.0f, 10000);  // sensor high → nothing missed
+    a.advance(11000);
+    TEST_ASSERT_EQUAL(0, a.missed());
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Profile tests
+    RUN_TEST(test_sweep_profile_ramps_rpm_and_coolant);
+    RUN_TEST(test_stress_profiles);
+
+    // Log replay tests
+    RUN_TEST(test_record_target_and_pacing);
+    RUN_TEST(test_output_codes);
+
+    // Measurement tests
+    RUN_TEST(test_step_response_settle_time);
+    RUN_TEST(test_edge_audit_counts_missed_edges);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,151 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/flat_curve.h"
+#include <cmath>
+
+// Tests for constexpr flat-array curves and the dense LUT
+
+static constexpr CurvePoint kTestCurve[] = {
+    { 1.0f, 10.0f },
+    { 2.0f, 30.0f },
+    { 4.0f, 10.0f }
+};
+
+static constexpr FlatCurve test_curve(kTestCurve);
+
+static UniformCurveLut<4096> test_lut;   // 16 KB — keep out of the stack
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Compile-Time Table
+// ============================================================================
+
+void test_constexpr_curve_size_and_points(void) {
+    static_assert(test_curve.size() == 3, "size must be known at compile time");
+    static_assert(flat_curve_sorted(kTestCurve), "table must be sorted");
+
+    TEST_ASSERT_EQUAL(3, test_curve.size());
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, test_curve[1].x);
+}
+
+void test_unsorted_table_detected(void) {
+    static constexpr CurvePoint unsorted[] = { { 2.0f, 0.0f }, { 1.0f, 0.0f } };
+
+    TEST_ASSERT_FALSE(flat_curve_sorted(unsorted));
+}
+
+// ============================================================================
+// TEST: Interpolation (CurveInterpolator semantics)
+// ============================================================================
+
+void test_exact_points(void) {
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, test_curve.interpolate(1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 30.0f, test_curve.interpolate(2.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, test_curve.interpolate(4.0f));
+}
+
+void test_between_points(void) {
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.0f, test_curve.interpolate(1.5f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.0f, test_curve.interpolate(3.0f));
+}
+
+void test_below_first_point_interpolates_from_origin(void) {
+    // CurveInterpolator starts from (0, 0)
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 5.0f, test_curve.interpolate(0.5f));
+}
+
+void test_above_last_point_holds_last_value(void) {
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, test_curve.interpolate(100.0f));
+}
+
+void test_nan_input_propagates(void) {
+    TEST_ASSERT_TRUE(std::isnan(test_curve.interpolate(NAN)));
+}
+
+void test_inverse_rising_and_falling_tables(void) {
+    static constexpr CurvePoint rising[]  = { { 0.25f, 0.0f }, { 2.25f, 100.0f } };
+    static constexpr CurvePoint falling[] = { { 0.2f, 120.0f }, { 0.8f, 80.0f },
+                                              { 1.4f, 10.0f } };
+    static constexpr FlatCurve up(rising);
+    static constexpr FlatCurve down(falling);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.25f, up.inverse(50.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.5f, down.inverse(100.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.1f, down.inverse(45.0f));
+
+    // Round trip, end points clamped (no implicit origin)
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 63.0f, down.interpolate(down.inverse(63.0f)));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.2f, down.inverse(200.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.4f, down.inverse(0.0f));
+    TEST_ASSERT_TRUE(std::isnan(down.inverse(NAN)));
+}
+
+// ============================================================================
+// TEST: Dense LUT
+// ============================================================================
+
+void test_uniform_lut_matches_curve(void) {
+    test_lut.build(test_curve, 0.0f, 4.0f);
+
+    for (float x = 0.0f; x <= 4.0f; x += 0.013f) {
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, test_curve.interpolate(x), test_lut.lookup(x));
+    }
+}
+
+void test_uniform_lut_clamps_out_of_range(void) {
+    test_lut.build(test_curve, 0.0f, 4.0f);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, test_lut.lookup(-1.0f));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.0f, test_lut.lookup(9.0f));
+}
+
+void test_keyed_lut_raw_code_lookup(void) {
+    // Raw 12-bit code → volts (ideal 3.3 V / 4095) → curve
+    test_lut.build_keyed([](size_t code) {
+        return test_curve.interpolate(code * (3.3f / 4095.0f));
+    });
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, test_curve.interpolate(1241 * (3.3f / 4095.0f)),
+                             test_lut.at(1241));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, test_lut.at(4095), test_lut.at(9999));  // clamped
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Compile-time table tests
+    RUN_TEST(test_constexpr_curve_size_and_points);
+    RUN_TEST(test_unsorted_table_detected);
+
+    // Interpolation tests
+    RUN_TEST(test_exact_points);
+    RUN_TEST(test_between_points);
+    RUN_TEST(test_below_first_point_interpolates_from_origin);
+    RUN_TEST(test_above_last_point_holds_last_value);
+    RUN_TEST(test_nan_input_propagates);
+    RUN_TEST(test_inverse_rising_and_falling_tables);
+
+    // Dense LUT tests
+    RUN_TEST(test_uniform_lut_matches_curve);
+    RUN_TEST(test_uniform_lut_clamps_out_of_range);
+    RUN_TEST(test_keyed_lut_raw_code_lookup);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,134 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/fuel_totalizer.h"
+#include <cmath>
+
+// Tests for the fuel integrator (integer mL counters, trip reset, rolling
+// L/h and L/nm window). Time is passed in as tick durations.
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// 1 Hz ticks for `seconds`
+static void run(FuelIntegrator& f, uint32_t seconds, float lph, float sog_ms) {
+    for (uint32_t i = 0; i < seconds; i++) f.tick(1000, lph, sog_ms);
+}
+
+// ============================================================================
+// TEST: Integration
+// ============================================================================
+
+void test_one_hour_at_constant_rate(void) {
+    FuelIntegrator f;
+    run(f, 3600, 3.6f, NAN);
+
+    // 1 mL/s, no float drift over an hour of 1 s steps
+    TEST_ASSERT_UINT32_WITHIN(1, 3600, f.total_ml());
+    TEST_ASSERT_UINT32_WITHIN(1, 3600, f.trip_ml());
+}
+
+void test_sub_ml_steps_accumulate(void) {
+    FuelIntegrator f;
+    run(f, 1000, 0.6f, NAN);   // idle: 0.1667 mL per tick
+
+    TEST_ASSERT_UINT32_WITHIN(1, 166, f.total_ml());
+}
+
+// ============================================================================
+// TEST: Trip
+// ============================================================================
+
+void test_trip_reset_keeps_lifetime(void) {
+    FuelIntegrator f;
+    f.set_counters(500000, 12000, 40000);   // restored from flash
+    run(f, 100, 3.6f, 3.0f);
+
+    f.reset_trip();
+    run(f, 10, 3.6f, 3.0f);
+
+    TEST_ASSERT_UINT32_WITHIN(1, 500110, f.total_ml());
+    TEST_ASSERT_UINT32_WITHIN(1, 10, f.trip_ml());
+    TEST_ASSERT_UINT32_WITHIN(1, 30, f.trip_m());
+}
+
+void test_distance_only_counts_with_fuel_flowing(void) {
+    FuelIntegrator f;
+    run(f, 600, 0.0f, 3.0f);   // sailing, engine off
+
+    TEST_ASSERT_EQUAL_UINT32(0, f.trip_m());
+    TEST_ASSERT_TRUE(std::isnan(f.trip_l_per_nm()));
+}
+
+// ============================================================================
+// TEST: Economy
+// ============================================================================
+
+void test_rolling_rate_and_economy(void) {
+    FuelIntegrator f;
+    TEST_ASSERT_TRUE(std::isnan(f.rolling_lph()));
+
+    // 10 min at 3 L/h over 10 min at 6 L/h: window holds only the last 5 min
+    run(f, 600, 3.0f, 2.0f);
+    run(f, 600, 6.0f, 3.0864f);   // 6 kts
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 6.0f, f.rolling_lph());
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 1.0f, f.rolling_l_per_nm());   // 6 L/h / 6 kts
+
+    // Trip: (0.5 + 1.0) L over (1.2 + 1.0) km
+    const float expect = 1.5f / ((1200.0f + 1851.8f) / 1852.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, expect, f.trip_l_per_nm());
+}
+
+void test_rolling_sums_do_not_drift(void) {
+    FuelIntegrator f;
+
+    // A week of changing rate and speed (non-round per-tick amounts)
+    for (uint32_t i = 0; i < 7 * 86400; i++) {
+        const float lph = 0.6f + 19.4f * static_cast<float>((i * 7919u) % 1000u) / 999.0f;
+        const float sog = 0.1f + 3.9f * static_cast<float>((i * 104729u) % 1000u) / 999.0f;
+        f.tick(1000, lph, sog);
+    }
+
+    // Rate after the window has turned over: only the recent 5 min count
+    run(f, 600, 5.0f, 2.5f);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 5.0f, f.rolling_lph());
+    TEST_ASSERT_FLOAT_WITHIN(0.0002f, 5.0f / (2.5f * 3600.0f / 1852.0f),
+                             f.rolling_l_per_nm());
+
+    // Engine stopped: exactly zero, not the rounding left in the sums
+    run(f, 600, 0.0f, NAN);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, f.rolling_lph());
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Integration tests
+    RUN_TEST(test_one_hour_at_constant_rate);
+    RUN_TEST(test_sub_ml_steps_accumulate);
+
+    // Trip tests
+    RUN_TEST(test_trip_reset_keeps_lifetime);
+    RUN_TEST(test_distance_only_counts_with_fuel_flowing);
+
+    // Economy tests
+    RUN_TEST(test_rolling_rate_and_economy);
+    RUN_TEST(test_rolling_sums_do_not_drift);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
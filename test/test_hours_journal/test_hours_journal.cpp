@@ -0,0 +1,217 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/hours_journal.h"
+
+// Tests for the append-only engine hours journal (RAM-backed NOR flash)
+
+// NOR semantics: erase → 0xFF, program can only clear bits
+class RamFlash : public JournalFlash {
+ public:
+    void reset(size_t sectors) {
+        size_   = sectors * SECTOR_BYTES;
+        erases  = 0;
+        memset(mem_, 0x00, sizeof(mem_));   // unerased garbage
+    }
+
+    size_t size() const override { return size_; }
+
+    bool read(size_t off, void* dst, size_t len) override {
+        if (off + len > size_) return false;
+        memcpy(dst, mem_ + off, len);
+        return true;
+    }
+
+    bool write(size_t off, const void* src, size_t len) override {
+        if (off + len > size_) return false;
+        const uint8_t* s = static_cast<const uint8_t*>(src);
+        for (size_t i = 0; i < len; i++) mem_[off + i] &= s[i];
+        return true;
+    }
+
+    bool erase_sector(size_t off) override {
+        if (off % SECTOR_BYTES || off >= size_) return false;
+        memset(mem_ + off, 0xFF, SECTOR_BYTES);
+        erases++;
+        return true;
+    }
+
+    uint8_t* raw(size_t off) { return mem_ + off; }
+
+    int erases = 0;
+
+ private:
+    size_t  size_ = 0;
+    uint8_t mem_[4 * SECTOR_BYTES];
+};
+
+// Static: too large for the test task stack
+static RamFlash ram_flash;
+static RamFlash* flash = &ram_flash;
+
+void setUp(void) {
+    flash->reset(2);
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Basic Operation
+// ============================================================================
+
+void test_crc32_reference_vector(void) {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32_ieee("123456789", 9));
+}
+
+void test_empty_flash_has_no_record(void) {
+    HoursJournal j(flash);
+
+    TEST_ASSERT_TRUE(j.begin());
+    TEST_ASSERT_FALSE(j.has_record());
+}
+
+void test_latest_record_recovered_after_reboot(void) {
+    HoursJournal j(flash);
+    j.begin();
+    TEST_ASSERT_TRUE(j.append(100));
+    TEST_ASSERT_TRUE(j.append(110));
+    TEST_ASSERT_TRUE(j.append(120));
+
+    HoursJournal rebooted(flash);
+    rebooted.begin();
+
+    TEST_ASSERT_TRUE(rebooted.has_record());
+    TEST_ASSERT_EQUAL_UINT32(120, rebooted.seconds());
+    TEST_ASSERT_EQUAL_UINT32(3, rebooted.sequence());
+    TEST_ASSERT_EQUAL(3 * HoursJournal::RECORD_BYTES, rebooted.write_offset());
+}
+
+void test_large_counts_keep_full_resolution(void) {
+    HoursJournal j(flash);
+    j.begin();
+    j.append(36000001u);   // 10000 h + 1 s (float hours would lose the second)
+
+    HoursJournal rebooted(flash);
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT32(36000001u, rebooted.seconds());
+}
+
+// ============================================================================
+// TEST: Ring / Wear
+// ============================================================================
+
+void test_ring_wraps_with_one_erase_per_sector(void) {
+    HoursJournal j(flash);
+    j.begin();
+
+    const uint32_t per_sector = JournalFlash::SECTOR_BYTES / HoursJournal::RECORD_BYTES;
+    const uint32_t n = 2 * per_sector + 10;   // wraps into sector 0 again
+
+    for (uint32_t i = 1; i <= n; i++) {
+        TEST_ASSERT_TRUE(j.append(i * 10));
+    }
+    TEST_ASSERT_EQUAL(3, flash->erases);
+
+    HoursJournal rebooted(flash);
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT32(n * 10, rebooted.seconds());
+    TEST_ASSERT_EQUAL_UINT32(n, rebooted.sequence());
+}
+
+// ============================================================================
+// TEST: Power Fail
+// ============================================================================
+
+void test_torn_write_falls_back_and_is_skipped(void) {
+    HoursJournal j(flash);
+    j.begin();
+    j.append(500);
+    j.append(510);
+
+    // Power lost mid-program of a third record: only some bits cleared
+    uint8_t* torn = flash->raw(2 * HoursJournal::RECORD_BYTES);
+    torn[0] = 0x31;
+    torn[4] = 0x03;
+
+    HoursJournal rebooted(flash);
+    rebooted.begin();
+    TEST_ASSERT_EQUAL_UINT32(510, rebooted.seconds());
+    TEST_ASSERT_EQUAL(3 * HoursJournal::RECORD_BYTES, rebooted.write_offset());
+
+    TEST_ASSERT_TRUE(rebooted.append(520));
+
+    HoursJournal again(flash);
+    again.begin();
+    TEST_ASSERT_EQUAL_UINT32(520, again.seconds());
+}
+
+void test_too_small_flash_rejected(void) {
+    flash->reset(1);
+    HoursJournal j(flash);
+
+    TEST_ASSERT_FALSE(j.begin());
+    TEST_ASSERT_FALSE(j.append(1));
+}
+
+// ============================================================================
+// TEST: Shared partition
+// ============================================================================
+
+void test_slices_hold_independent_journals(void) {
+    flash->reset(4);
+    JournalFlashSlice lo(flash, 0, 2 * JournalFlash::SECTOR_BYTES);
+    JournalFlashSlice hi(flash, 2 * JournalFlash::SECTOR_BYTES, 8 * JournalFlash::SECTOR_BYTES);
+
+    TEST_ASSERT_EQUAL(2 * JournalFlash::SECTOR_BYTES, hi.size());   // clipped
+
+    HoursJournal a(&lo);
+    HoursJournal b(&hi);
+    a.begin();
+    b.begin();
+    for (uint32_t i = 1; i <= 300; i++) a.append(i);   // wraps into sector 1
+    b.append(777);
+
+    HoursJournal a2(&lo);
+    HoursJournal b2(&hi);
+    TEST_ASSERT_TRUE(a2.begin());
+    TEST_ASSERT_TRUE(b2.begin());
+    TEST_ASSERT_EQUAL_UINT32(300, a2.seconds());
+    TEST_ASSERT_EQUAL_UINT32(777, b2.seconds());
+
+    // Outside the window is rejected, not forwarded
+    uint8_t byte;
+    TEST_ASSERT_FALSE(lo.read(2 * JournalFlash::SECTOR_BYTES, &byte, 1));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Basic operation tests
+    RUN_TEST(test_crc32_reference_vector);
+    RUN_TEST(test_empty_flash_has_no_record);
+    RUN_TEST(test_latest_record_recovered_after_reboot);
+    RUN_TEST(test_large_counts_keep_full_resolution);
+
+    // Ring / wear tests
+    RUN_TEST(test_ring_wraps_with_one_erase_per_sector);
+
+    // Power fail tests
+    RUN_TEST(test_torn_write_falls_back_and_is_skipped);
+    RUN_TEST(test_too_small_flash_rejected);
+
+    // Shared partition tests
+    RUN_TEST(test_slices_hold_independent_journals);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
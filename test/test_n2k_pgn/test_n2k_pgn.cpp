@@ -0,0 +1,164 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/n2k_pgn.h"
+
+// Tests for NMEA 2000 engine PGN encoding and fast-packet framing
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: CAN Identifier
+// ============================================================================
+
+void test_can_id_pdu2(void) {
+    const uint32_t id = n2k::can_id(2, n2k::PGN_ENGINE_RAPID, 150);
+
+    TEST_ASSERT_EQUAL_HEX32(0x09F20096, id);
+    TEST_ASSERT_EQUAL(n2k::PGN_ENGINE_RAPID, n2k::id_pgn(id));
+    TEST_ASSERT_EQUAL(150, n2k::id_source(id));
+}
+
+void test_can_id_pdu1_destination(void) {
+    const uint32_t id = n2k::can_id(6, n2k::PGN_ISO_ADDRESS_CLAIM, 150,
+                                    n2k::ADDRESS_GLOBAL);
+
+    TEST_ASSERT_EQUAL_HEX32(0x18EEFF96, id);
+    TEST_ASSERT_EQUAL(n2k::PGN_ISO_ADDRESS_CLAIM, n2k::id_pgn(id));
+    TEST_ASSERT_EQUAL(255, n2k::id_destination(id));
+}
+
+// ============================================================================
+// TEST: PGN 127488 / 127489
+// ============================================================================
+
+void test_engine_rapid_speed(void) {
+    uint8_t d[n2k::ENGINE_RAPID_LEN];
+
+    n2k::encode_engine_rapid(d, 0, 2000.0f / 60.0f);   // 2000 rpm
+
+    TEST_ASSERT_EQUAL_HEX8(0x00, d[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x40, d[1]);   // 8000 × 0.25 rpm
+    TEST_ASSERT_EQUAL_HEX8(0x1F, d[2]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, d[3]);   // boost n/a
+    TEST_ASSERT_EQUAL_HEX8(0xFF, d[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x7F, d[5]);   // trim n/a
+}
+
+void test_engine_rapid_nan_not_available(void) {
+    uint8_t d[n2k::ENGINE_RAPID_LEN];
+
+    n2k::encode_engine_rapid(d, 0, NAN);
+
+    TEST_ASSERT_EQUAL_HEX8(0xFF, d[1]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, d[2]);
+}
+
+void test_engine_dynamic_fields(void) {
+    n2k::EngineDynamic e;
+    e.oil_pressure_Pa = 300000.0f;   // 3000 × 100 Pa
+    e.coolant_K       = 353.15f;     // 35315 × 0.01 K
+    e.fuel_rate_lph   = 2.5f;        // 25 × 0.1 L/h
+    e.hours           = 1.5f;        // 5400 s
+    e.load_ratio      = 0.42f;       // 42 %
+
+    uint8_t d[n2k::ENGINE_DYNAMIC_LEN];
+    n2k::encode_engine_dynamic(d, 1, e);
+
+    TEST_ASSERT_EQUAL_HEX8(0x01, d[0]);
+    TEST_ASSERT_EQUAL(3000, d[1] | (d[2] << 8));
+    TEST_ASSERT_EQUAL(0xFFFF, d[3] | (d[4] << 8));     // oil temp n/a
+    TEST_ASSERT_EQUAL(35315, d[5] | (d[6] << 8));
+    TEST_ASSERT_EQUAL(25, d[9] | (d[10] << 8));
+    TEST_ASSERT_EQUAL(5400, d[11] | (d[12] << 8) | (d[13] << 16) | (d[14] << 24));
+    TEST_ASSERT_EQUAL(42, d[24]);
+    TEST_ASSERT_EQUAL_HEX8(0x7F, d[25]);                // torque n/a
+}
+
+void test_engine_dynamic_missing_fields(void) {
+    n2k::EngineDynamic e;   // all NaN
+
+    uint8_t d[n2k::ENGINE_DYNAMIC_LEN];
+    n2k::encode_engine_dynamic(d, 0, e);
+
+    TEST_ASSERT_EQUAL(0xFFFF, d[1] | (d[2] << 8));
+    TEST_ASSERT_EQUAL(0xFFFF, d[5] | (d[6] << 8));
+    TEST_ASSERT_EQUAL(0x7FFF, d[9] | (d[10] << 8));
+    TEST_ASSERT_EQUAL_HEX8(0xFF, d[11]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, d[14]);
+    TEST_ASSERT_EQUAL_HEX8(0x7F, d[24]);
+}
+
+// ============================================================================
+// TEST: Fast Packet / NAME
+// ============================================================================
+
+void test_fast_packet_framing(void) {
+    uint8_t data[n2k::ENGINE_DYNAMIC_LEN];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = static_cast<uint8_t>(i);
+
+    uint8_t frames[4][8];
+    const size_t n = n2k::fast_packet_encode(frames, 4, 3, data, sizeof(data));
+
+    TEST_ASSERT_EQUAL(4, n);
+    TEST_ASSERT_EQUAL_HEX8(0x60, frames[0][0]);   // seq 3, frame 0
+    TEST_ASSERT_EQUAL(26, frames[0][1]);
+    TEST_ASSERT_EQUAL(0, frames[0][2]);
+    TEST_ASSERT_EQUAL(5, frames[0][7]);
+    TEST_ASSERT_EQUAL_HEX8(0x61, frames[1][0]);
+    TEST_ASSERT_EQUAL(6, frames[1][1]);
+    TEST_ASSERT_EQUAL_HEX8(0x63, frames[3][0]);
+    TEST_ASSERT_EQUAL(25, frames[3][6]);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, frames[3][7]);   // padding
+
+    // Not enough room → nothing written
+    TEST_ASSERT_EQUAL(0, n2k::fast_packet_encode(frames, 3, 0, data, sizeof(data)));
+}
+
+void test_name_round_trip(void) {
+    n2k::Name name;
+    name.unique_number = 0x123456;   // truncated to 21 bits
+
+    uint8_t d[8];
+    n2k::encode_name(d, name.value());
+
+    TEST_ASSERT_EQUAL_HEX32(0x123456 & 0x1FFFFF, d[0] | (d[1] << 8) | ((d[2] & 0x1F) << 16));
+    TEST_ASSERT_EQUAL(140, d[5]);                  // device function: engine
+    TEST_ASSERT_EQUAL_HEX8(0xC0, d[7] & 0xF0);     // arbitrary address + marine
+    TEST_ASSERT_TRUE(n2k::decode_name(d) == name.value());
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // CAN identifier tests
+    RUN_TEST(test_can_id_pdu2);
+    RUN_TEST(test_can_id_pdu1_destination);
+
+    // PGN payload tests
+    RUN_TEST(test_engine_rapid_speed);
+    RUN_TEST(test_engine_rapid_nan_not_available);
+    RUN_TEST(test_engine_dynamic_fields);
+    RUN_TEST(test_engine_dynamic_missing_fields);
+
+    // Fast packet / NAME tests
+    RUN_TEST(test_fast_packet_framing);
+    RUN_TEST(test_name_round_trip);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
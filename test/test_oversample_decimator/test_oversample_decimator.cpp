@@ -0,0 +1,173 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/oversample_decimator.h"
+#include <cmath>
+
+// Tests for single-pass burst oversampling / outlier rejection
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// Feed `n` samples alternating around `center` by ±1 code
+static void feed_burst(OversampleDecimator& d, uint16_t center, int n) {
+    for (int i = 0; i < n; i++) {
+        d.add((i & 1) ? center + 1 : center - 1);
+    }
+}
+
+// ============================================================================
+// TEST: Basic Decimation
+// ============================================================================
+
+void test_empty_burst_returns_nan(void) {
+    OversampleDecimator d;
+
+    TEST_ASSERT_TRUE(std::isnan(d.decimate()));
+    TEST_ASSERT_TRUE(std::isnan(d.last()));
+}
+
+void test_mean_has_sub_code_resolution(void) {
+    OversampleDecimator d;
+
+    // 64 samples: half 1000, half 1001 → 1000.5
+    for (int i = 0; i < 64; i++) {
+        d.add((i & 1) ? 1001 : 1000);
+    }
+
+    TEST_ASSERT_EQUAL(64, d.count());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1000.5f, d.decimate());
+    TEST_ASSERT_EQUAL(0, d.count());  // new burst started
+}
+
+void test_first_burst_trims_min_and_max(void) {
+    OversampleDecimator d;
+
+    // No reference yet: a single spike is trimmed, not averaged in
+    feed_burst(d, 2000, 62);
+    d.add(4095);
+    d.add(0);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 2000.0f, d.decimate());
+}
+
+// ============================================================================
+// TEST: Outlier Rejection
+// ============================================================================
+
+void test_spikes_rejected_against_previous_output(void) {
+    OversampleDecimator d(64.0f);
+
+    feed_burst(d, 1500, 64);
+    d.decimate();
+
+    // Second burst with several spikes (more than trim alone can remove)
+    feed_burst(d, 1500, 60);
+    d.add(3000);
+    d.add(3100);
+    d.add(200);
+    d.add(4095);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1500.0f, d.decimate());
+    TEST_ASSERT_EQUAL(4, d.rejected());
+}
+
+void test_step_change_reanchors_in_one_burst(void) {
+    OversampleDecimator d(64.0f);
+
+    feed_burst(d, 1000, 64);
+    d.decimate();
+
+    // Real step: every sample is outside the gate
+    feed_burst(d, 2500, 64);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 2500.0f, d.decimate());
+
+    // Gate now follows the new level
+    feed_burst(d, 2500, 64);
+    d.add(1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 2500.0f, d.decimate());
+    TEST_ASSERT_EQUAL(1, d.rejected());
+}
+
+void test_gate_disabled_keeps_all_samples(void) {
+    OversampleDecimator d(0.0f);
+
+    feed_burst(d, 1000, 64);
+    d.decimate();
+
+    for (int i = 0; i < 10; i++) d.add(1000);
+    for (int i = 0; i < 10; i++) d.add(1100);
+
+    TEST_ASSERT_EQUAL(0, d.rejected());
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1050.0f, d.decimate());
+}
+
+void test_step_inside_burst_latency(void) {
+    // Oil pressure loss half-way through a 50 ms burst
+    OversampleDecimator gated(64.0f);
+    OversampleDecimator trim_only(0.0f);
+
+    feed_burst(gated, 2000, 64);
+    feed_burst(trim_only, 2000, 64);
+    gated.decimate();
+    trim_only.decimate();
+
+    feed_burst(gated, 2000, 32);
+    feed_burst(gated, 500, 32);
+    feed_burst(trim_only, 2000, 32);
+    feed_burst(trim_only, 500, 32);
+
+    // Gated: the new level is dropped, seen one burst later
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 2000.0f, gated.decimate());
+
+    // Trim only: the step shows in the burst that contains it
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1250.0f, trim_only.decimate());
+
+    feed_burst(trim_only, 500, 64);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 500.0f, trim_only.decimate());
+}
+
+void test_reset_forgets_reference(void) {
+    OversampleDecimator d(64.0f);
+
+    feed_burst(d, 1000, 64);
+    d.decimate();
+    d.reset();
+
+    feed_burst(d, 3000, 8);
+    d.add(1000);   // no reference gate any more — only trimmed
+
+    TEST_ASSERT_TRUE(d.decimate() > 2700.0f);
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Basic decimation tests
+    RUN_TEST(test_empty_burst_returns_nan);
+    RUN_TEST(test_mean_has_sub_code_resolution);
+    RUN_TEST(test_first_burst_trims_min_and_max);
+
+    // Outlier rejection tests
+    RUN_TEST(test_spikes_rejected_against_previous_output);
+    RUN_TEST(test_step_change_reanchors_in_one_burst);
+    RUN_TEST(test_gate_disabled_keeps_all_samples);
+    RUN_TEST(test_step_inside_burst_latency);
+    RUN_TEST(test_reset_forgets_reference);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
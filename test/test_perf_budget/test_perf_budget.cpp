@@ -0,0 +1,499 @@
+#include <unity.h>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ReactESP.h>
+#include <esp_cpu.h>
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <sensesp/transforms/lambda_transform.h>
+
+#include "../../src/acquisition_task.h"
+#include "../../src/engine_model.h"
+#include "../../src/engine_simulator.h"
+#include "../../src/pcnt_rpm_sensor.h"
+#include "../../src/period_rpm_sensor.h"
+#include "../../src/pipeline_profiler.h"
+#include "../../src/rev_smoother.h"
+#include "../../src/sk_delta_writer.h"
+#include "../../src/sk_output_batcher.h"
+
+// On-target go / no-go performance budgets for the signal pipelines.
+// The real transforms run on a synthetic input stream; every metric is
+// printed as one "PERF {json}" line (see perf_format_json) and fails the
+// test when over budget:
+//
+//   pio test -f test_perf_budget -v | grep '^PERF '
+//
+// The 7 kHz tests need the bench simulator jumper GPIO27 → GPIO25 and are
+// ignored without it. Tag the results with
+//   PLATFORMIO_BUILD_FLAGS='-DPERF_BUILD_ID=\"<version>\"'
+
+#ifndef PERF_BUILD_ID
+#define PERF_BUILD_ID __DATE__ " " __TIME__
+#endif
+
+#if ENABLE_PIPELINE_PROFILER
+PipelineProfiler* g_profiler = nullptr;   // stages not recorded here
+#endif
+
+// ============================================================================
+// Budgets (240 MHz, WiFi off)
+// ============================================================================
+static constexpr float FUEL_LOAD_MAX_US     = 50.0f;    // one fuel + load pass
+static constexpr float SMOOTHER_MAX_US      = 20.0f;    // one RevSmoother update
+static constexpr float SK_EMIT_MAX_US       = 150.0f;   // one 4-value delta
+static constexpr float LOOP_JITTER_MAX_MS   = 2.0f;     // drain timer overrun
+// Acquisition period (20 Hz) + drain (5 ms) + batcher tick (200 ms) + slack
+static constexpr float EDGE_TO_EMIT_MAX_MS  = 300.0f;
+
+static constexpr uint32_t EVAL_OPS       = 10000;
+static constexpr uint32_t WARMUP_OPS     = 1000;
+static constexpr uint32_t JITTER_RUN_MS  = 10000;
+static constexpr int      LATENCY_TRIALS = 10;
+
+// Board wiring (main.cpp PIN_RPM / RPM_TEETH)
+static constexpr uint8_t  PIN_RPM       = 25;
+static constexpr float    RPM_TEETH     = 116.0f;
+static constexpr uint8_t  TOOTH_CHANNEL = 0;
+
+// ============================================================================
+// Allocation counters
+// ============================================================================
+static std::atomic<uint32_t> g_perf_allocs{0};
+
+void* operator new(size_t n) {
+    g_perf_allocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(n ? n : 1);
+    if (!p) abort();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+static uint32_t allocs() {
+    return g_perf_allocs.load(std::memory_order_relaxed);
+}
+
+// Live heap blocks (also sees malloc from C code, e.g. newlib)
+static size_t heap_blocks() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    return info.allocated_blocks;
+}
+
+static float cycles_per_us() {
+    return static_cast<float>(getCpuFrequencyMhz());
+}
+
+// One PERF line; true when within budget
+static bool report(const char* metric, const char* unit, const PerfStats& s,
+                   float per_unit, float budget) {
+    char buf[192];
+    perf_format_json(buf, sizeof(buf), metric, unit, s, per_unit, budget);
+    Serial.printf("PERF %s\n", buf);
+    return strstr(buf, "\"pass\":true") != nullptr;
+}
+
+// ============================================================================
+// Fixtures
+// ============================================================================
+
+struct FloatSink : public ValueConsumer<float> {
+    void set(const float& v) override { last = v; }
+    float last = NAN;
+};
+
+static FloatSink    load_sink;
+static EngineModel* model = nullptr;
+static EngineInputs in;
+
+static SkDeltaWriter writer;   // ~6 KB — keep out of the stack
+static int sk_ids[4];
+
+// Fuel model → load transform, as wired by engine_fuel.h / engine_load.h
+static void build_model() {
+    if (model) return;
+
+    static Linear use_stw(1.0f, 0.0f);
+    use_stw.set(1.0f);
+
+    model = new EngineModel(&use_stw);
+    model->connect_to(new LambdaTransform<EngineModelOutput, float>(
+        [](EngineModelOutput o) -> float { return engine_load_fraction(o); }))
+        ->connect_to(&load_sink);
+
+    writer.begin("perf-test");
+    sk_ids[0] = writer.add_path("propulsion.engine.revolutions");
+    sk_ids[1] = writer.add_path("propulsion.engine.fuel.rate");
+    sk_ids[2] = writer.add_path("propulsion.engine.load");
+    sk_ids[3] = writer.add_path("propulsion.engine.coolantTemperature");
+}
+
+// Synthetic operating point i: idle → max RPM, docked / underway, calm → gale
+static void synthetic_inputs(uint32_t i) {
+    in[IN_RPM]     = 700.0f + static_cast<float>((i * 37) % 3100);
+    in[IN_STW_KTS] = (i % 11 == 0) ? 0.0f : 1.0f + 0.001f * (i % 6000);
+    in[IN_SOG_KTS] = in[IN_STW_KTS] + 0.2f;
+    in[IN_AWS_KTS] = static_cast<float>(i % 31);
+    in[IN_AWA_RAD] = -3.1f + 0.01f * static_cast<float>(i % 620);
+}
+
+static void emit_frame(uint32_t i) {
+    writer.start();
+    writer.append(sk_ids[0], 30.0f + 0.01f * (i % 100));
+    writer.append(sk_ids[1], 0.0000008f);
+    writer.append(sk_ids[2], load_sink.last);
+    writer.append(sk_ids[3], 353.15f);
+    writer.finish(1704067200 + i, i % 1000);
+}
+
+void setUp(void) {
+    build_model();
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Per-Evaluation Cost
+// ============================================================================
+
+void test_fuel_load_evaluation_budget(void) {
+    PerfStats s;
+
+    for (uint32_t i = 0; i < WARMUP_OPS; i++) {
+        synthetic_inputs(i);
+        model->set(in);
+    }
+
+    for (uint32_t i = 0; i < EVAL_OPS; i++) {
+        synthetic_inputs(i);
+        const uint32_t c0 = esp_cpu_get_ccount();
+        model->set(in);   // fuel pass + load transform + consumer
+        s.record(esp_cpu_get_ccount() - c0);
+    }
+
+    TEST_ASSERT_TRUE(std::isfinite(load_sink.last));
+    TEST_ASSERT_TRUE_MESSAGE(
+        report("fuel_load_eval", "us", s, cycles_per_us(), FUEL_LOAD_MAX_US),
+        "fuel / load evaluation over budget");
+}
+
+void test_smoother_and_sk_emit_budget(void) {
+    RevSmoother<32> smoother(200, 4000);   // period-mode window (rpm_sensor.h)
+    PerfStats smooth;
+    PerfStats emit;
+
+    for (uint32_t i = 0; i < WARMUP_OPS; i++) {
+        smoother.update(30.0f, i * 50);
+        emit_frame(i);
+    }
+
+    for (uint32_t i = WARMUP_OPS; i < WARMUP_OPS + EVAL_OPS; i++) {
+        uint32_t c0 = esp_cpu_get_ccount();
+        smoother.update(30.0f + 0.1f * (i % 7), i * 50);
+        smooth.record(esp_cpu_get_ccount() - c0);
+
+        c0 = esp_cpu_get_ccount();
+        emit_frame(i);
+        emit.record(esp_cpu_get_ccount() - c0);
+    }
+
+    const bool smooth_ok =
+        report("rpm_smoother_update", "us", smooth, cycles_per_us(), SMOOTHER_MAX_US);
+    const bool emit_ok =
+        report("sk_delta_emit", "us", emit, cycles_per_us(), SK_EMIT_MAX_US);
+
+    TEST_ASSERT_TRUE_MESSAGE(smooth_ok, "RPM smoother over budget");
+    TEST_ASSERT_TRUE_MESSAGE(emit_ok, "Signal K delta emit over budget");
+}
+
+// ============================================================================
+// TEST: Heap
+// ============================================================================
+
+void test_steady_state_updates_allocate_nothing(void) {
+    RevSmoother<32> smoother(1000, 4000);
+    PerfStats per_update;
+
+    // First pass: newlib's dtoa buffers, lazily built state
+    for (uint32_t i = 0; i < WARMUP_OPS; i++) {
+        synthetic_inputs(i);
+        model->set(in);
+        smoother.update(in[IN_RPM] / 60.0f, i * 50);
+        emit_frame(i);
+    }
+
+    const size_t blocks0 = heap_blocks();
+
+    for (uint32_t i = 0; i < EVAL_OPS; i++) {
+        const uint32_t a0 = allocs();
+        synthetic_inputs(i);
+        model->set(in);
+        smoother.update(in[IN_RPM] / 60.0f, (WARMUP_OPS + i) * 50);
+        emit_frame(i);
+        per_update.record(allocs() - a0);
+    }
+
+    PerfStats blocks;
+    const size_t blocks1 = heap_blocks();
+    blocks.record(blocks1 > blocks0 ? static_cast<uint32_t>(blocks1 - blocks0) : 0);
+
+    const bool new_ok =
+        report("steady_state_allocs", "allocs", per_update, 1.0f, 0.0f);
+    const bool heap_ok =
+        report("steady_state_heap_blocks", "blocks", blocks, 1.0f, 0.0f);
+
+    TEST_ASSERT_TRUE_MESSAGE(new_ok, "operator new in a steady-state update");
+    TEST_ASSERT_TRUE_MESSAGE(heap_ok, "heap blocks grew during steady-state updates");
+}
+
+// ============================================================================
+// Hardware rig: LEDC tooth pulses → PCNT + MCPWM capture → AcquisitionTask
+// → event-loop drain → RevSmoother → batcher-style SK emit
+// ============================================================================
+
+// SkOutputBatcher slot + tick for one path, without the websocket
+class SkEmitProbe : public ValueConsumer<float> {
+ public:
+    SkEmitProbe() {
+        writer_.begin("perf-test");
+        id_ = writer_.add_path("propulsion.engine.revolutions");
+        gate_.deadband = 0.05f;   // RPM_SK_DEADBAND_REV_S (rpm_sensor.h)
+    }
+
+    void set(const float& v) override {
+        value_   = v;
+        pending_ = true;
+    }
+
+    void tick(uint32_t now_ms) {
+        if (!gate_.due(now_ms)) return;
+
+        const float v = pending_ ? value_ : gate_.last_sent;
+        if (gate_.should_send(pending_, v, now_ms,
+                              SkOutputBatcher::DEFAULT_KEEPALIVE_MS)) {
+            writer_.start();
+            writer_.append(id_, v);
+            writer_.finish(0, 0);
+            gate_.mark_sent(v, now_ms);
+
+            last_sent_ = v;
+            if (std::isfinite(v) && v > 0.0f && emit_us_ == 0) {
+                emit_us_ = esp_timer_get_time();
+            }
+        }
+        pending_ = false;
+    }
+
+    // Next finite emit is timestamped
+    void arm() { emit_us_ = 0; }
+
+    int64_t emit_us() const { return emit_us_; }
+    float   last_sent() const { return last_sent_; }
+
+ private:
+    SkDeltaWriter writer_;
+    int           id_ = -1;
+    DeadbandGate  gate_;
+    float         value_     = NAN;
+    bool          pending_   = false;
+    float         last_sent_ = NAN;
+    int64_t       emit_us_   = 0;
+};
+
+struct Rig {
+    AcquisitionTask     acq;
+    PcntRpmSensor       pcnt{PIN_RPM, RPM_TEETH, PCNT_UNIT_0};
+    PeriodRpmSensor     period{PIN_RPM, RPM_TEETH, &pcnt, MCPWM_UNIT_0};
+    RevSmoother<32>     smoother{200, 4000};   // period-mode window
+    SkEmitProbe         probe;
+    reactesp::EventLoop loop;
+
+    bool      measuring = false;
+    uint32_t  last_us   = 0;
+    PerfStats late_us;
+
+    void begin() {
+        ledcSetup(TOOTH_CHANNEL, 1000, 10);
+        ledcAttachPin(SIM_TOOTH_PIN, TOOTH_CHANNEL);
+        ledcWriteTone(TOOTH_CHANNEL, 0);
+
+        // Worst case for the CPU: one capture ISR per tooth edge
+        JsonDocument doc;
+        doc["teeth_per_period"] = 1;
+        const JsonObject cfg = doc.as<JsonObject>();
+        period.from_json(cfg);
+
+        pcnt.enable(&acq);
+        period.enable(&acq);
+
+        period.connect_to(new LambdaTransform<float, float>(
+            [this](float rps) -> float { return smoother.update(rps, millis()); }))
+            ->connect_to(&probe);
+
+        // Same timers as AcquisitionTask::start() / SkOutputBatcher
+        loop.onRepeat(AcquisitionTask::DRAIN_INTERVAL_MS, [this]() {
+            const uint32_t now_us = micros();
+            if (measuring && last_us != 0) {
+                const uint32_t period_us = now_us - last_us;
+                const uint32_t interval_us = AcquisitionTask::DRAIN_INTERVAL_MS * 1000;
+                late_us.record(period_us > interval_us ? period_us - interval_us : 0);
+            }
+            last_us = now_us;
+            acq.drain();
+        });
+        loop.onRepeat(SkOutputBatcher::DEFAULT_TICK_MS,
+                      [this]() { probe.tick(millis()); });
+
+        acq.start_task();
+    }
+
+    void run_for(uint32_t ms) {
+        const uint32_t t0 = millis();
+        while (millis() - t0 < ms) {
+            loop.tick();
+        }
+    }
+
+    // Run until the probe has emitted a finite rev/s (or timeout)
+    bool run_until_emit(uint32_t timeout_ms) {
+        const uint32_t t0 = millis();
+        while (probe.emit_us() == 0 && millis() - t0 < timeout_ms) {
+            loop.tick();
+        }
+        return probe.emit_us() != 0;
+    }
+
+    bool edges_seen() const {
+        return pcnt.latest_rps() * RPM_TEETH > 0.9f * SIM_MAX_EDGE_HZ;
+    }
+};
+
+static Rig* rig = nullptr;
+
+static Rig* get_rig() {
+    if (!rig) {
+        rig = new Rig();
+        rig->begin();
+    }
+    return rig;
+}
+
+// ============================================================================
+// TEST: Event Loop Under 7 kHz Input
+// ============================================================================
+
+void test_loop_jitter_at_7khz(void) {
+    Rig* r = get_rig();
+
+    ledcWriteTone(TOOTH_CHANNEL, SIM_MAX_EDGE_HZ);
+    r->run_for(1000);
+    if (!r->edges_seen()) {
+        ledcWriteTone(TOOTH_CHANNEL, 0);
+        TEST_IGNORE_MESSAGE("No tooth edges on GPIO25 - jumper GPIO27 -> GPIO25");
+    }
+
+    const uint32_t dropped0 = r->acq.dropped();
+    const uint32_t a0       = allocs();
+
+    r->late_us.reset();
+    r->last_us   = 0;
+    r->measuring = true;
+    r->run_for(JITTER_RUN_MS);
+    r->measuring = false;
+
+    PerfStats run_allocs;
+    run_allocs.record(allocs() - a0);
+
+    const bool jitter_ok =
+        report("loop_jitter_7khz", "ms", r->late_us, 1000.0f, LOOP_JITTER_MAX_MS);
+    const bool allocs_ok =
+        report("loop_7khz_allocs", "allocs", run_allocs, 1.0f, 0.0f);
+
+    ledcWriteTone(TOOTH_CHANNEL, 0);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f * SIM_MAX_EDGE_HZ, SIM_MAX_EDGE_HZ,
+                             r->probe.last_sent() * RPM_TEETH);
+    TEST_ASSERT_EQUAL_UINT32(dropped0, r->acq.dropped());
+    TEST_ASSERT_TRUE_MESSAGE(jitter_ok, "event-loop jitter over budget at 7 kHz");
+    TEST_ASSERT_TRUE_MESSAGE(allocs_ok, "heap allocations in the 7 kHz pipeline");
+}
+
+// ============================================================================
+// TEST: Tooth Edge → Signal K Emit
+// ============================================================================
+
+void test_tooth_edge_to_sk_emit_latency(void) {
+    Rig* r = get_rig();
+    PerfStats latency_us;
+
+    for (int trial = 0; trial < LATENCY_TRIALS; trial++) {
+        // Stopped: smoother window empty → NaN sent
+        ledcWriteTone(TOOTH_CHANNEL, 0);
+        r->run_for(1000);
+
+        r->probe.arm();
+        const int64_t t0 = esp_timer_get_time();   // first edge ≤ 143 µs later
+        ledcWriteTone(TOOTH_CHANNEL, SIM_MAX_EDGE_HZ);
+
+        if (!r->run_until_emit(2000)) {
+            ledcWriteTone(TOOTH_CHANNEL, 0);
+            if (trial == 0 && !r->edges_seen()) {
+                TEST_IGNORE_MESSAGE("No tooth edges on GPIO25 - jumper GPIO27 -> GPIO25");
+            }
+            TEST_FAIL_MESSAGE("No Signal K emit within 2 s of the first tooth edge");
+        }
+
+        latency_us.record(static_cast<uint32_t>(r->probe.emit_us() - t0));
+    }
+
+    ledcWriteTone(TOOTH_CHANNEL, 0);
+
+    TEST_ASSERT_TRUE_MESSAGE(
+        report("tooth_edge_to_sk_emit", "ms", latency_us, 1000.0f, EDGE_TO_EMIT_MAX_MS),
+        "tooth edge → Signal K emit over budget");
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Build tag for the PERF lines that follow
+    Serial.printf("PERF {\"build\":\"%s\",\"idf\":\"%s\",\"cpu_mhz\":%u}\n",
+                  PERF_BUILD_ID, esp_get_idf_version(),
+                  static_cast<unsigned>(getCpuFrequencyMhz()));
+
+    // Per-evaluation cost
+    RUN_TEST(test_fuel_load_evaluation_budget);
+    RUN_TEST(test_smoother_and_sk_emit_budget);
+
+    // Heap
+    RUN_TEST(test_steady_state_updates_allocate_nothing);
+
+    // Hardware rig (GPIO27 → GPIO25 jumper)
+    RUN_TEST(test_loop_jitter_at_7khz);
+    RUN_TEST(test_tooth_edge_to_sk_emit_latency);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
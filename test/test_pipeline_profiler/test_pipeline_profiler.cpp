@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/pipeline_profiler.h"
+#include <cmath>
+#include <cstring>
+
+// Tests for the profiler statistics (log2 histogram, summary string).
+// Pure PerfStats — independent of ENABLE_PIPELINE_PROFILER.
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Min / Mean / Max
+// ============================================================================
+
+void test_empty_stats(void) {
+    PerfStats s;
+
+    TEST_ASSERT_EQUAL(0, s.count);
+    TEST_ASSERT_TRUE(std::isnan(s.mean()));
+    TEST_ASSERT_EQUAL_UINT32(0, s.percentile(0.99f));
+}
+
+void test_min_mean_max(void) {
+    PerfStats s;
+    s.record(100);
+    s.record(200);
+    s.record(600);
+
+    TEST_ASSERT_EQUAL(3, s.count);
+    TEST_ASSERT_EQUAL_UINT32(100, s.min);
+    TEST_ASSERT_EQUAL_UINT32(600, s.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 300.0f, s.mean());
+}
+
+// ============================================================================
+// TEST: Percentile
+// ============================================================================
+
+void test_p99_is_bucket_upper_bound(void) {
+    PerfStats s;
+    for (int i = 0; i < 99; i++) s.record(100);   // bucket [64, 128)
+    s.record(5000);                               // bucket [4096, 8192)
+
+    TEST_ASSERT_EQUAL_UINT32(127, s.percentile(0.99f));
+    TEST_ASSERT_EQUAL_UINT32(5000, s.percentile(1.0f));   // clamped to max
+}
+
+void test_percentile_never_exceeds_max(void) {
+    PerfStats s;
+    s.record(70);
+
+    TEST_ASSERT_EQUAL_UINT32(70, s.percentile(0.99f));
+}
+
+// ============================================================================
+// TEST: Summary / Reset
+// ============================================================================
+
+void test_format_in_microseconds_and_reset(void) {
+    PerfStats s;
+    s.record(240);     // 1 µs at 240 MHz
+    s.record(480);
+
+    char buf[64];
+    TEST_ASSERT_TRUE(perf_format(buf, sizeof(buf), s, 240.0f) > 0);
+    TEST_ASSERT_EQUAL_STRING("n=2 min=1.0 avg=1.5 p99=2.0 max=2.0", buf);
+
+    s.reset();
+    perf_format(buf, sizeof(buf), s, 240.0f);
+    TEST_ASSERT_EQUAL_STRING("n=0", buf);
+}
+
+void test_json_line_with_budget(void) {
+    PerfStats s;
+    s.record(240);
+    s.record(480);
+
+    char buf[160];
+    TEST_ASSERT_TRUE(perf_format_json(buf, sizeof(buf), "fuel_load_eval", "us",
+                                      s, 240.0f, 2.0f) > 0);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"metric\":\"fuel_load_eval\",\"unit\":\"us\",\"n\":2,\"min\":1.0,"
+        "\"avg\":1.5,\"p99\":2.0,\"max\":2.0,\"budget\":2.0,\"pass\":true}",
+        buf);
+
+    // Over budget, and no samples at all → fail
+    perf_format_json(buf, sizeof(buf), "x", "us", s, 240.0f, 1.5f);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "\"pass\":false"));
+
+    s.reset();
+    perf_format_json(buf, sizeof(buf), "x", "us", s, 1.0f, 0.0f);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"metric\":\"x\",\"unit\":\"us\",\"n\":0,\"budget\":0.0,\"pass\":false}",
+        buf);
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Min / mean / max tests
+    RUN_TEST(test_empty_stats);
+    RUN_TEST(test_min_mean_max);
+
+    // Percentile tests
+    RUN_TEST(test_p99_is_bucket_upper_bound);
+    RUN_TEST(test_percentile_never_exceeds_max);
+
+    // Summary tests
+    RUN_TEST(test_format_in_microseconds_and_reset);
+    RUN_TEST(test_json_line_with_budget);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
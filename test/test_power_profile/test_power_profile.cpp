@@ -0,0 +1,112 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/power_profile.h"
+#include <cmath>
+
+// Tests for the running / engine-off profile switch that drives the
+// adaptive sample rates (rev/s input, 500 RPM running threshold).
+
+static const uint32_t OFF_DELAY_MS  = 120000;
+static const float    RUNNING_REV_S = 500.0f / 60.0f;
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Boot / engine start
+// ============================================================================
+
+void test_boots_in_running_profile(void) {
+    EngineStateTracker t(OFF_DELAY_MS, RUNNING_REV_S);
+
+    TEST_ASSERT_EQUAL(POWER_RUNNING, t.profile());
+    TEST_ASSERT_FALSE(t.poll(5000));
+    TEST_ASSERT_EQUAL(POWER_RUNNING, t.profile());
+}
+
+void test_engine_off_after_delay_without_samples(void) {
+    EngineStateTracker t(OFF_DELAY_MS, RUNNING_REV_S);
+
+    // Boot with the engine stopped: the timer starts at the first poll
+    TEST_ASSERT_FALSE(t.poll(1000));
+    TEST_ASSERT_FALSE(t.poll(1000 + OFF_DELAY_MS - 1));
+    TEST_ASSERT_TRUE(t.poll(1000 + OFF_DELAY_MS));
+    TEST_ASSERT_EQUAL(POWER_ENGINE_OFF, t.profile());
+
+    // Reported once
+    TEST_ASSERT_FALSE(t.poll(1000 + 2 * OFF_DELAY_MS));
+}
+
+void test_start_switches_to_running_immediately(void) {
+    EngineStateTracker t(OFF_DELAY_MS, RUNNING_REV_S);
+
+    t.poll(0);
+    TEST_ASSERT_TRUE(t.poll(OFF_DELAY_MS));
+
+    // First running sample (900 RPM) → full rates
+    TEST_ASSERT_TRUE(t.update(15.0f, OFF_DELAY_MS + 500));
+    TEST_ASSERT_EQUAL(POWER_RUNNING, t.profile());
+    TEST_ASSERT_FALSE(t.update(15.0f, OFF_DELAY_MS + 1000));
+}
+
+// ============================================================================
+// TEST: Engine stop
+// ============================================================================
+
+void test_stop_needs_continuous_off_delay(void) {
+    EngineStateTracker t(OFF_DELAY_MS, RUNNING_REV_S);
+
+    TEST_ASSERT_FALSE(t.update(30.0f, 1000));
+
+    // Cranking / stalling below 500 RPM, NaN between pulses
+    TEST_ASSERT_FALSE(t.update(NAN, 60000));
+    TEST_ASSERT_FALSE(t.update(5.0f, 90000));
+
+    // Restarted before the delay: the off timer starts over
+    TEST_ASSERT_FALSE(t.update(12.0f, 100000));
+    TEST_ASSERT_FALSE(t.update(NAN, 100000 + OFF_DELAY_MS - 1));
+    TEST_ASSERT_TRUE(t.update(NAN, 100000 + OFF_DELAY_MS));
+    TEST_ASSERT_EQUAL(POWER_ENGINE_OFF, t.profile());
+}
+
+void test_threshold_is_running_rpm(void) {
+    EngineStateTracker t(OFF_DELAY_MS, RUNNING_REV_S);
+
+    t.poll(0);
+    TEST_ASSERT_TRUE(t.poll(OFF_DELAY_MS));
+
+    // 499 RPM stays off, 500 RPM is running
+    TEST_ASSERT_FALSE(t.update(499.0f / 60.0f, OFF_DELAY_MS + 100));
+    TEST_ASSERT_EQUAL(POWER_ENGINE_OFF, t.profile());
+    TEST_ASSERT_TRUE(t.update(RUNNING_REV_S, OFF_DELAY_MS + 200));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Boot / engine start tests
+    RUN_TEST(test_boots_in_running_profile);
+    RUN_TEST(test_engine_off_after_delay_without_samples);
+    RUN_TEST(test_start_switches_to_running_immediately);
+
+    // Engine stop tests
+    RUN_TEST(test_stop_needs_continuous_off_delay);
+    RUN_TEST(test_threshold_is_running_rpm);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
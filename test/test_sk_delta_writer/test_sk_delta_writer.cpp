@@ -0,0 +1,160 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/sk_delta_writer.h"
+#include <cstring>
+
+// Tests for pre-serialized Signal K delta templates
+
+static SkDeltaWriter writer;   // ~6 KB — keep out of the stack
+
+static const time_t T_2024 = 1704067200;   // 2024-01-01T00:00:00Z
+
+void setUp(void) {
+    writer = SkDeltaWriter();
+    writer.begin("esp32-yanmar");
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Frame Layout
+// ============================================================================
+
+void test_single_value_frame(void) {
+    const int id = writer.add_path("propulsion.engine.load");
+
+    writer.start();
+    TEST_ASSERT_TRUE(writer.append(id, 0.25f));
+    const char* f = writer.finish(T_2024, 123);
+
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"updates\":[{\"source\":{\"label\":\"esp32-yanmar\"},"
+        "\"timestamp\":\"2024-01-01T00:00:00.123Z\","
+        "\"values\":[{\"path\":\"propulsion.engine.load\",\"value\":          0.25}]}]}",
+        f);
+}
+
+void test_multi_value_frame(void) {
+    const int a = writer.add_path("a");
+    const int b = writer.add_path("b");
+
+    writer.start();
+    writer.append(a, 1.0f);
+    writer.append(b, 2.0f);
+    const char* f = writer.finish(T_2024, 0);
+
+    TEST_ASSERT_EQUAL(2, writer.count());
+    TEST_ASSERT_NOT_NULL(strstr(f,
+        "\"values\":[{\"path\":\"a\",\"value\":             1},"
+        "{\"path\":\"b\",\"value\":             2}]}]}"));
+}
+
+// ============================================================================
+// TEST: Fixed-Width Patching
+// ============================================================================
+
+void test_frame_length_independent_of_value(void) {
+    const int id = writer.add_path("propulsion.engine.fuel.rate");
+
+    writer.start();
+    writer.append(id, 0.0f);
+    writer.finish(T_2024, 0);
+    const size_t len0 = writer.length();
+
+    writer.start();
+    writer.append(id, -1.234567e-7f);
+    writer.finish(T_2024, 0);
+
+    TEST_ASSERT_EQUAL(len0, writer.length());
+}
+
+void test_nan_written_as_null(void) {
+    const int id = writer.add_path("x");
+
+    writer.start();
+    writer.append(id, NAN);
+    const char* f = writer.finish(T_2024, 0);
+
+    TEST_ASSERT_NOT_NULL(strstr(f, "\"value\":          null}"));
+}
+
+void test_unset_clock_blanks_timestamp(void) {
+    const int id = writer.add_path("x");
+
+    writer.start();
+    writer.append(id, 1.0f);
+    const char* f = writer.finish(0, 0);
+
+    TEST_ASSERT_NULL(strstr(f, "timestamp"));
+    TEST_ASSERT_NOT_NULL(strstr(f, "},                                       \"values\":["));
+}
+
+// ============================================================================
+// TEST: Capacity
+// ============================================================================
+
+void test_invalid_id_rejected(void) {
+    writer.start();
+
+    TEST_ASSERT_FALSE(writer.append(-1, 1.0f));
+    TEST_ASSERT_FALSE(writer.append(5, 1.0f));
+    TEST_ASSERT_EQUAL(0, writer.count());
+}
+
+void test_entry_table_limit(void) {
+    for (size_t i = 0; i < SkDeltaWriter::MAX_ENTRIES; i++) {
+        TEST_ASSERT_TRUE(writer.add_path("p") >= 0);
+    }
+    TEST_ASSERT_EQUAL(-1, writer.add_path("p"));
+}
+
+void test_path_change_rebuilds_templates(void) {
+    const int id = writer.add_path("propulsion.engine.revolutions");
+
+    TEST_ASSERT_TRUE(writer.has_path(id, "propulsion.engine.revolutions"));
+    TEST_ASSERT_FALSE(writer.has_path(id, "propulsion.engine"));
+    TEST_ASSERT_FALSE(writer.has_path(id, "propulsion.port.revolutions"));
+    TEST_ASSERT_FALSE(writer.has_path(-1, "propulsion.engine.revolutions"));
+
+    // UI edit: rebuild from scratch, same id order
+    writer.clear_paths();
+    TEST_ASSERT_EQUAL(0, writer.add_path("propulsion.port.revolutions"));
+    TEST_ASSERT_TRUE(writer.has_path(0, "propulsion.port.revolutions"));
+
+    writer.start();
+    TEST_ASSERT_TRUE(writer.append(0, 12.5f));
+    TEST_ASSERT_NOT_NULL(strstr(writer.finish(0, 0),
+                                "{\"path\":\"propulsion.port.revolutions\",\"value\":"));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Frame layout tests
+    RUN_TEST(test_single_value_frame);
+    RUN_TEST(test_multi_value_frame);
+
+    // Fixed-width patching tests
+    RUN_TEST(test_frame_length_independent_of_value);
+    RUN_TEST(test_nan_written_as_null);
+    RUN_TEST(test_unset_clock_blanks_timestamp);
+
+    // Capacity tests
+    RUN_TEST(test_invalid_id_rejected);
+    RUN_TEST(test_entry_table_limit);
+    RUN_TEST(test_path_change_rebuilds_templates);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
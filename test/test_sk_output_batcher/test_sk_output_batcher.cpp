@@ -0,0 +1,158 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/sk_output_batcher.h"
+#include <cmath>
+
+// Tests for the Signal K batcher send decision (rate limit, deadband,
+// keep-alive, offline routing). Times are passed explicitly — no waiting
+// on millis().
+
+static constexpr uint32_t KEEPALIVE_MS = 10000;
+
+static DeadbandGate make_gate(uint32_t min_interval_ms, float deadband) {
+    DeadbandGate g;
+    g.min_interval_ms = min_interval_ms;
+    g.deadband        = deadband;
+    return g;
+}
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: First Value
+// ============================================================================
+
+void test_first_value_sent_immediately(void) {
+    DeadbandGate g = make_gate(1000, 0.5f);
+
+    TEST_ASSERT_FALSE(g.should_send(false, NAN, 0, KEEPALIVE_MS));
+    TEST_ASSERT_TRUE(g.should_send(true, 350.0f, 0, KEEPALIVE_MS));
+}
+
+// ============================================================================
+// TEST: Rate Limit
+// ============================================================================
+
+void test_min_interval_blocks_fast_changes(void) {
+    DeadbandGate g = make_gate(1000, 0.0f);
+    g.mark_sent(10.0f, 0);
+
+    TEST_ASSERT_FALSE(g.due(500));
+    TEST_ASSERT_FALSE(g.should_send(true, 20.0f, 500, KEEPALIVE_MS));
+    TEST_ASSERT_TRUE(g.should_send(true, 20.0f, 1000, KEEPALIVE_MS));
+}
+
+// ============================================================================
+// TEST: Deadband
+// ============================================================================
+
+void test_change_inside_deadband_suppressed(void) {
+    DeadbandGate g = make_gate(0, 0.1f);
+    g.mark_sent(350.00f, 0);
+
+    TEST_ASSERT_FALSE(g.should_send(true, 350.05f, 200, KEEPALIVE_MS));
+    TEST_ASSERT_TRUE(g.should_send(true, 350.20f, 400, KEEPALIVE_MS));
+}
+
+void test_slow_drift_compares_to_last_sent(void) {
+    DeadbandGate g = make_gate(0, 0.1f);
+    g.mark_sent(350.0f, 0);
+
+    // Each step is tiny, but the total drift vs. the last SENT value counts
+    float v = 350.0f;
+    bool sent = false;
+    for (int i = 1; i <= 20 && !sent; i++) {
+        v += 0.02f;
+        sent = g.should_send(true, v, i * 200, KEEPALIVE_MS);
+    }
+
+    TEST_ASSERT_TRUE(sent);
+    TEST_ASSERT_TRUE(v > 350.1f);
+}
+
+void test_nan_transition_always_sent(void) {
+    DeadbandGate g = make_gate(0, 100.0f);
+    g.mark_sent(1.0f, 0);
+
+    TEST_ASSERT_TRUE(g.should_send(true, NAN, 200, KEEPALIVE_MS));
+
+    g.mark_sent(NAN, 200);
+    TEST_ASSERT_FALSE(g.should_send(true, NAN, 400, KEEPALIVE_MS));
+    TEST_ASSERT_TRUE(g.should_send(true, 1.0f, 600, KEEPALIVE_MS));
+}
+
+// ============================================================================
+// TEST: Keep-Alive
+// ============================================================================
+
+void test_unchanged_value_sent_as_keepalive(void) {
+    DeadbandGate g = make_gate(0, 0.1f);
+    g.mark_sent(350.0f, 0);
+
+    TEST_ASSERT_FALSE(g.should_send(false, 350.0f, 9999, KEEPALIVE_MS));
+    TEST_ASSERT_TRUE(g.should_send(false, 350.0f, 10000, KEEPALIVE_MS));
+}
+
+void test_keepalive_survives_millis_wrap(void) {
+    DeadbandGate g = make_gate(0, 0.1f);
+    g.mark_sent(350.0f, 0xFFFFF000u);
+
+    TEST_ASSERT_FALSE(g.should_send(false, 350.0f, 0x00000100u, KEEPALIVE_MS));
+    TEST_ASSERT_TRUE(g.should_send(false, 350.0f, 0x00002000u, KEEPALIVE_MS));
+}
+
+// ============================================================================
+// TEST: Offline routing
+// ============================================================================
+
+void test_replayed_output_not_queued_offline(void) {
+    // Connected: pre-serialized delta, SKOutput only without a template
+    TEST_ASSERT_EQUAL(SK_ROUTE_DIRECT, sk_send_route(true, true, true));
+    TEST_ASSERT_EQUAL(SK_ROUTE_DIRECT, sk_send_route(true, true, false));
+    TEST_ASSERT_EQUAL(SK_ROUTE_OUTPUT, sk_send_route(true, false, true));
+
+    // Offline: SensESP's queue would flush the outage as "now" on
+    // reconnect, on top of the timestamped replay — replayed paths drop
+    TEST_ASSERT_EQUAL(SK_ROUTE_DROP, sk_send_route(false, true, true));
+    TEST_ASSERT_EQUAL(SK_ROUTE_OUTPUT, sk_send_route(false, true, false));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // First value tests
+    RUN_TEST(test_first_value_sent_immediately);
+
+    // Rate limit tests
+    RUN_TEST(test_min_interval_blocks_fast_changes);
+
+    // Deadband tests
+    RUN_TEST(test_change_inside_deadband_suppressed);
+    RUN_TEST(test_slow_drift_compares_to_last_sent);
+    RUN_TEST(test_nan_transition_always_sent);
+
+    // Keep-alive tests
+    RUN_TEST(test_unchanged_value_sent_as_keepalive);
+    RUN_TEST(test_keepalive_survives_millis_wrap);
+
+    // Offline routing tests
+    RUN_TEST(test_replayed_output_not_queued_offline);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,121 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/sk_replay.h"
+#include <cmath>
+
+// Tests for the outage replay: log record → Signal K values and timestamps
+
+static constexpr time_t NOW_S = 1700000000;   // 2023-11-14, clock set
+
+static LogRecord make_record(void) {
+    LogRecord r;
+    memset(&r, 0xFF, sizeof(r));
+    r.time_s  = 0;
+    r.time_ms = 0;
+    r.flags   = 0;
+    return r;
+}
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Values
+// ============================================================================
+
+void test_values_in_signalk_units(void) {
+    LogRecord r = make_record();
+    r.rev_s     = LogRecord::scale(30.0f, LOG_RES_REV_S);
+    r.coolant_K = LogRecord::scale(355.15f, LOG_RES_TEMP);
+    r.oil_hPa   = LogRecord::scale(300000.0f, LOG_RES_OIL);
+    r.fuel_lph  = LogRecord::scale(3.6f, LOG_RES_FUEL);
+    r.load      = LogRecord::scale(0.5f, LOG_RES_LOAD);
+
+    float v[REPLAY_NUM_CHANNELS];
+    log_record_to_sk(r, v);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, v[REPLAY_REVOLUTIONS]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 355.15f, v[REPLAY_COOLANT]);
+    TEST_ASSERT_FLOAT_WITHIN(100.0f, 300000.0f, v[REPLAY_OIL_PRESSURE]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-9f, 1e-6f, v[REPLAY_FUEL_RATE]);   // m³/s
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.5f, v[REPLAY_LOAD]);
+}
+
+void test_missing_channels_are_nan(void) {
+    float v[REPLAY_NUM_CHANNELS];
+    log_record_to_sk(make_record(), v);
+
+    for (size_t i = 0; i < REPLAY_NUM_CHANNELS; i++) {
+        TEST_ASSERT_TRUE(std::isnan(v[i]));
+    }
+}
+
+// ============================================================================
+// TEST: Timestamps
+// ============================================================================
+
+void test_clock_valid_record_keeps_its_time(void) {
+    LogRecord r = make_record();
+    r.time_s  = NOW_S - 600;
+    r.time_ms = 250;
+    r.flags   = LogRecord::CLOCK_VALID;
+
+    time_t s;
+    unsigned ms;
+    TEST_ASSERT_TRUE(log_record_unix_time(r, NOW_S, 0, 900000, s, ms));
+    TEST_ASSERT_EQUAL(NOW_S - 600, s);
+    TEST_ASSERT_EQUAL(250, ms);
+}
+
+void test_uptime_record_placed_on_wall_clock(void) {
+    LogRecord r = make_record();
+    r.time_s  = 10;    // 10.5 s after boot
+    r.time_ms = 500;
+
+    // Now: 70.0 s after boot → record is 59.5 s old
+    time_t s;
+    unsigned ms;
+    TEST_ASSERT_TRUE(log_record_unix_time(r, NOW_S, 0, 70000, s, ms));
+    TEST_ASSERT_EQUAL(NOW_S - 60, s);
+    TEST_ASSERT_EQUAL(500, ms);
+}
+
+void test_uptime_record_skipped_without_clock(void) {
+    LogRecord r = make_record();
+    r.time_s = 10;
+
+    time_t s;
+    unsigned ms;
+    TEST_ASSERT_FALSE(log_record_unix_time(r, 100, 0, 70000, s, ms));
+    TEST_ASSERT_FALSE(log_record_unix_time(r, NOW_S, 0, 5000, s, ms));  // future
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Value tests
+    RUN_TEST(test_values_in_signalk_units);
+    RUN_TEST(test_missing_channels_are_nan);
+
+    // Timestamp tests
+    RUN_TEST(test_clock_valid_record_keeps_its_time);
+    RUN_TEST(test_uptime_record_placed_on_wall_clock);
+    RUN_TEST(test_uptime_record_skipped_without_clock);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
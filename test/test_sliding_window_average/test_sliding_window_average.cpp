@@ -0,0 +1,187 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/rev_smoother.h"
+#include "../../src/sliding_window_average.h"
+#include <cmath>
+
+// Tests for the fixed-capacity RPM smoother ring buffer (and RevSmoother)
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Mean and Empty Handling
+// ============================================================================
+
+void test_empty_window_mean_is_nan(void) {
+    SlidingWindowAverage<4> avg(1000);
+
+    TEST_ASSERT_TRUE(avg.empty());
+    TEST_ASSERT_TRUE(std::isnan(avg.mean()));
+}
+
+void test_mean_of_samples_in_window(void) {
+    SlidingWindowAverage<8> avg(1000);
+    avg.push(10.0f, 0);
+    avg.push(20.0f, 100);
+    avg.push(30.0f, 200);
+
+    TEST_ASSERT_EQUAL(3, avg.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 20.0f, avg.mean());
+}
+
+// ============================================================================
+// TEST: Time-Based Eviction
+// ============================================================================
+
+void test_evicts_samples_older_than_window(void) {
+    SlidingWindowAverage<8> avg(1000);
+    avg.push(10.0f, 0);
+    avg.push(20.0f, 600);
+    avg.push(30.0f, 1200);
+
+    avg.evict(1200);  // sample @0 is 1200 ms old → dropped
+
+    TEST_ASSERT_EQUAL(2, avg.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 25.0f, avg.mean());
+}
+
+void test_sample_exactly_at_window_edge_is_kept(void) {
+    SlidingWindowAverage<8> avg(1000);
+    avg.push(10.0f, 0);
+
+    avg.evict(1000);
+
+    TEST_ASSERT_EQUAL(1, avg.size());
+}
+
+void test_eviction_is_millis_wrap_safe(void) {
+    SlidingWindowAverage<8> avg(1000);
+    avg.push(10.0f, 0xFFFFFF00u);   // just before millis() wrap
+    avg.push(20.0f, 0x00000100u);   // just after wrap (512 ms later)
+
+    avg.evict(0x00000100u);
+
+    TEST_ASSERT_EQUAL(2, avg.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 15.0f, avg.mean());
+}
+
+void test_full_window_evicts_to_empty_and_resets_sum(void) {
+    SlidingWindowAverage<4> avg(100);
+    avg.push(1.0e6f, 0);
+    avg.push(0.1f, 10);
+
+    avg.evict(1000);
+
+    TEST_ASSERT_TRUE(avg.empty());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, static_cast<float>(avg.sum()));
+}
+
+// ============================================================================
+// TEST: Fixed Capacity
+// ============================================================================
+
+void test_overwrites_oldest_when_full(void) {
+    SlidingWindowAverage<3> avg(10000);
+    avg.push(1.0f, 0);
+    avg.push(2.0f, 1);
+    avg.push(3.0f, 2);
+    avg.push(4.0f, 3);   // drops 1.0
+
+    TEST_ASSERT_EQUAL(3, avg.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.0f, avg.mean());
+}
+
+void test_running_sum_matches_full_resum(void) {
+    SlidingWindowAverage<16> avg(500);
+    uint32_t t = 0;
+
+    for (int i = 0; i < 10000; i++) {
+        float v = 30.0f + 0.37f * (i % 11);
+        avg.push(v, t);
+        avg.evict(t);
+        t += 50;
+    }
+
+    // Last 11 samples (500 ms window @ 50 ms) → recompute directly
+    float expected = 0.0f;
+    int n = 0;
+    for (int i = 10000 - 11; i < 10000; i++) {
+        expected += 30.0f + 0.37f * (i % 11);
+        n++;
+    }
+    expected /= n;
+
+    TEST_ASSERT_EQUAL(11, avg.size());
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, expected, avg.mean());
+}
+
+void test_clear_empties_window(void) {
+    SlidingWindowAverage<4> avg(1000);
+    avg.push(5.0f, 0);
+    avg.clear();
+
+    TEST_ASSERT_TRUE(avg.empty());
+    TEST_ASSERT_TRUE(std::isnan(avg.mean()));
+}
+
+// ============================================================================
+// TEST: RevSmoother (rpm_sensor.h pipeline)
+// ============================================================================
+
+void test_rev_smoother_ignores_invalid_samples(void) {
+    RevSmoother<8> smoother(1000, 4000);
+    smoother.update(30.0f, 0);
+
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, smoother.update(NAN, 50));
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, smoother.update(0.0f, 100));
+    TEST_ASSERT_EQUAL_FLOAT(31.0f, smoother.update(32.0f, 150));
+}
+
+void test_rev_smoother_nan_after_window_without_pulses(void) {
+    RevSmoother<8> smoother(200, 4000);
+    smoother.update(30.0f, 0);
+
+    TEST_ASSERT_EQUAL_FLOAT(30.0f, smoother.update(NAN, 200));
+    TEST_ASSERT_TRUE(std::isnan(smoother.update(NAN, 201)));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Mean / empty tests
+    RUN_TEST(test_empty_window_mean_is_nan);
+    RUN_TEST(test_mean_of_samples_in_window);
+
+    // Eviction tests
+    RUN_TEST(test_evicts_samples_older_than_window);
+    RUN_TEST(test_sample_exactly_at_window_edge_is_kept);
+    RUN_TEST(test_eviction_is_millis_wrap_safe);
+    RUN_TEST(test_full_window_evicts_to_empty_and_resets_sum);
+
+    // Capacity tests
+    RUN_TEST(test_overwrites_oldest_when_full);
+    RUN_TEST(test_running_sum_matches_full_resum);
+    RUN_TEST(test_clear_empties_window);
+
+    // RevSmoother tests
+    RUN_TEST(test_rev_smoother_ignores_invalid_samples);
+    RUN_TEST(test_rev_smoother_nan_after_window_without_pulses);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
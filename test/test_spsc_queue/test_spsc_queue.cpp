@@ -0,0 +1,121 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/spsc_queue.h"
+
+// Tests for the lock-free acquisition → event loop ring
+
+struct TestSample {
+    uint16_t channel;
+    uint32_t t_ms;
+    float    value;
+};
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Basic Operation
+// ============================================================================
+
+void test_empty_queue_pops_nothing(void) {
+    SpscQueue<int, 8> q;
+    int v = 0;
+
+    TEST_ASSERT_TRUE(q.empty());
+    TEST_ASSERT_FALSE(q.pop(v));
+}
+
+void test_fifo_order(void) {
+    SpscQueue<int, 8> q;
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(q.push(i));
+    }
+    TEST_ASSERT_EQUAL(5, q.size());
+
+    for (int i = 0; i < 5; i++) {
+        int v = -1;
+        TEST_ASSERT_TRUE(q.pop(v));
+        TEST_ASSERT_EQUAL(i, v);
+    }
+    TEST_ASSERT_TRUE(q.empty());
+}
+
+void test_samples_keep_fields(void) {
+    SpscQueue<TestSample, 4> q;
+    TestSample in = { 3, 123456u, 12.5f };
+
+    q.push(in);
+
+    TestSample out = {};
+    TEST_ASSERT_TRUE(q.pop(out));
+    TEST_ASSERT_EQUAL(3, out.channel);
+    TEST_ASSERT_EQUAL(123456u, out.t_ms);
+    TEST_ASSERT_EQUAL_FLOAT(12.5f, out.value);
+}
+
+// ============================================================================
+// TEST: Capacity / Wrap
+// ============================================================================
+
+void test_full_queue_rejects_push(void) {
+    SpscQueue<int, 8> q;
+
+    TEST_ASSERT_EQUAL(7, q.capacity());
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_TRUE(q.push(i));
+    }
+    TEST_ASSERT_FALSE(q.push(99));   // dropped, existing data intact
+
+    int v = -1;
+    q.pop(v);
+    TEST_ASSERT_EQUAL(0, v);
+    TEST_ASSERT_TRUE(q.push(99));    // room again
+}
+
+void test_wraps_many_times(void) {
+    SpscQueue<int, 4> q;
+    int expected = 0;
+
+    for (int i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(q.push(i));
+        if (i & 1) {
+            int v = -1;
+            TEST_ASSERT_TRUE(q.pop(v));
+            TEST_ASSERT_EQUAL(expected++, v);
+            TEST_ASSERT_TRUE(q.pop(v));
+            TEST_ASSERT_EQUAL(expected++, v);
+        }
+    }
+    TEST_ASSERT_TRUE(q.empty());
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Basic operation tests
+    RUN_TEST(test_empty_queue_pops_nothing);
+    RUN_TEST(test_fifo_order);
+    RUN_TEST(test_samples_keep_fields);
+
+    // Capacity / wrap tests
+    RUN_TEST(test_full_queue_rejects_push);
+    RUN_TEST(test_wraps_many_times);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,128 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/system_diagnostics.h"
+#include "../../src/boot_stage.h"
+#include "../../src/engine_instance.h"
+
+// Tests for the heap fragmentation metric and the per-stage setup
+// allocation accounting (pure HeapSnapshot arithmetic).
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+static HeapSnapshot snap(uint32_t free_bytes, uint32_t largest,
+                         uint32_t alloc_bytes, uint32_t alloc_blocks) {
+    HeapSnapshot s;
+    s.free_bytes       = free_bytes;
+    s.largest_block    = largest;
+    s.min_free_bytes   = free_bytes;
+    s.allocated_bytes  = alloc_bytes;
+    s.allocated_blocks = alloc_blocks;
+    return s;
+}
+
+// ============================================================================
+// TEST: Fragmentation
+// ============================================================================
+
+void test_fragmentation_contiguous_is_zero(void) {
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f,
+                             heap_fragmentation(snap(100000, 100000, 0, 0)));
+}
+
+void test_fragmentation_split_heap(void) {
+    // Largest block is a quarter of the free heap
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.75f,
+                             heap_fragmentation(snap(100000, 25000, 0, 0)));
+
+    // Empty heap is not reported as fragmented
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 0.0f,
+                             heap_fragmentation(snap(0, 0, 0, 0)));
+}
+
+// ============================================================================
+// TEST: Setup allocation accounting
+// ============================================================================
+
+void test_setup_stage_deltas(void) {
+    SetupAllocTracker t;
+    t.begin(snap(200000, 150000, 10000, 50));
+
+    t.mark("app",     snap(180000, 120000, 30000, 120));
+    t.mark("coolant", snap(178000, 120000, 32048, 131));
+
+    TEST_ASSERT_EQUAL(2, t.size());
+    TEST_ASSERT_EQUAL_STRING("app", t[0].name);
+    TEST_ASSERT_EQUAL_INT32(70, t[0].blocks);
+    TEST_ASSERT_EQUAL_INT32(20000, t[0].bytes);
+    TEST_ASSERT_EQUAL_INT32(11, t[1].blocks);
+    TEST_ASSERT_EQUAL_INT32(2048, t[1].bytes);
+
+    TEST_ASSERT_EQUAL_INT32(81, t.total_blocks());
+    TEST_ASSERT_EQUAL_INT32(22048, t.total_bytes());
+}
+
+void test_setup_stage_can_free(void) {
+    SetupAllocTracker t;
+    t.begin(snap(200000, 150000, 10000, 50));
+
+    // A scratch buffer released during the stage: negative deltas
+    t.mark("adc_scan start", snap(204000, 150000, 6000, 48));
+
+    TEST_ASSERT_EQUAL_INT32(-2, t[0].blocks);
+    TEST_ASSERT_EQUAL_INT32(-4000, t[0].bytes);
+}
+
+void test_setup_table_full_keeps_totals(void) {
+    SetupAllocTracker t;
+    t.begin(snap(200000, 150000, 0, 0));
+
+    for (uint32_t i = 1; i <= SetupAllocTracker::MAX_STAGES + 4; i++) {
+        t.mark("stage", snap(200000, 150000, i * 100, i));
+    }
+
+    // Last four marks summed into one "other" row
+    TEST_ASSERT_EQUAL(SetupAllocTracker::MAX_STAGES + 1, t.size());
+    TEST_ASSERT_EQUAL(4, t.overflow());
+    TEST_ASSERT_EQUAL_STRING("other", t[SetupAllocTracker::MAX_STAGES].name);
+    TEST_ASSERT_EQUAL_INT32(4, t[SetupAllocTracker::MAX_STAGES].blocks);
+    TEST_ASSERT_EQUAL_INT32(400, t[SetupAllocTracker::MAX_STAGES].bytes);
+    TEST_ASSERT_EQUAL_INT32(SetupAllocTracker::MAX_STAGES + 4, t.total_blocks());
+}
+
+void test_setup_table_fits_two_engines(void) {
+    // main.cpp with two engines, profiler and every deferred step
+    const size_t marks = 9 + 4 * MAX_ENGINES + DeferredBootQueue::MAX_STEPS;
+    TEST_ASSERT_TRUE(marks <= SetupAllocTracker::MAX_STAGES);
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Fragmentation tests
+    RUN_TEST(test_fragmentation_contiguous_is_zero);
+    RUN_TEST(test_fragmentation_split_heap);
+
+    // Setup accounting tests
+    RUN_TEST(test_setup_stage_deltas);
+    RUN_TEST(test_setup_stage_can_free);
+    RUN_TEST(test_setup_table_full_keeps_totals);
+    RUN_TEST(test_setup_table_fits_two_engines);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
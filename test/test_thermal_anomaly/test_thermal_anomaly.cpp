@@ -0,0 +1,176 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/thermal_anomaly.h"
+#include <cmath>
+
+// Tests for the learned coolant / exhaust baseline: incremental statistics
+// per RPM × load bin, steady-state gating, sigma notifications and the
+// compact NVS table layout.
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// Short gating for the tests: 10 s warm-up, 5 s settle, 3-sample debounce
+static ThermalAnomalyDetector make_detector() {
+    ThermalAnomalyDetector d;
+    d.params.warmup_ms   = 10000;
+    d.params.settle_ms   = 5000;
+    d.params.min_samples = 50.0f;
+    d.params.debounce    = 3;
+    return d;
+}
+
+// Alternates ±1 K around 353 K (80 °C): mean 353, sigma 1
+static float steady_temp(uint32_t i) {
+    return (i % 2) ? 354.0f : 352.0f;
+}
+
+// ============================================================================
+// TEST: Incremental statistics
+// ============================================================================
+
+void test_welford_matches_batch_statistics(void) {
+    ThermalBaseline b;
+    const float xs[] = {350.0f, 352.5f, 351.0f, 355.0f, 349.5f, 353.0f};
+    const size_t n = sizeof(xs) / sizeof(xs[0]);
+
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+        b.add(3, xs[i], 1000.0f);
+        sum += xs[i];
+    }
+    const float mean = sum / n;
+    float var = 0.0f;
+    for (size_t i = 0; i < n; i++) var += (xs[i] - mean) * (xs[i] - mean);
+    var /= n;
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, mean, b[3].mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, var, b[3].var);
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, b[3].n);
+}
+
+void test_saturated_count_follows_slow_drift(void) {
+    ThermalBaseline b;
+    for (int i = 0; i < 200; i++) b.add(0, 350.0f, 100.0f);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, b[0].n);
+
+    // Cleaner heat exchanger: 2 K cooler from now on
+    for (int i = 0; i < 500; i++) b.add(0, 348.0f, 100.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 348.0f, b[0].mean);
+}
+
+void test_bin_index_by_rpm_and_load(void) {
+    TEST_ASSERT_EQUAL_INT(-1, ThermalBaseline::bin_index(400.0f, 0.5f));
+    TEST_ASSERT_EQUAL_INT(-1, ThermalBaseline::bin_index(NAN, 0.5f));
+    TEST_ASSERT_EQUAL_INT(-1, ThermalBaseline::bin_index(1500.0f, NAN));
+
+    TEST_ASSERT_EQUAL_INT(0, ThermalBaseline::bin_index(500.0f, 0.0f));
+    // 1800 RPM → rpm bin 3, 60 % → load bin 3
+    TEST_ASSERT_EQUAL_INT(3 * 5 + 3, ThermalBaseline::bin_index(1800.0f, 0.6f));
+    // Clamped at the top
+    TEST_ASSERT_EQUAL_INT(ThermalBaseline::NUM_BINS - 1,
+                          ThermalBaseline::bin_index(4200.0f, 1.2f));
+}
+
+// ============================================================================
+// TEST: Detection
+// ============================================================================
+
+void test_no_learning_during_warmup_or_settling(void) {
+    ThermalAnomalyDetector d = make_detector();
+    const int bin = ThermalBaseline::bin_index(1800.0f, 0.6f);
+
+    // 0 … 9 s: warm-up
+    for (uint32_t t = 0; t < 10; t++) d.observe(1800.0f, 0.6f, 353.0f, t * 1000);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, d.baseline()[bin].n);
+
+    // New bin at 12 s: nothing counts before 17 s
+    for (uint32_t t = 10; t < 17; t++) {
+        d.observe(t < 12 ? 1200.0f : 1800.0f, 0.6f, 353.0f, t * 1000);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, d.baseline()[bin].n);
+
+    d.observe(1800.0f, 0.6f, 353.0f, 17000);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, d.baseline()[bin].n);
+}
+
+void test_sustained_deviation_raises_warn_then_alarm(void) {
+    ThermalAnomalyDetector d = make_detector();
+    const int bin = ThermalBaseline::bin_index(1800.0f, 0.6f);
+
+    // Warm, settled, then 60 s of normal running
+    uint32_t t = 0;
+    for (; t < 80; t++) {
+        TEST_ASSERT_EQUAL(ANOMALY_NORMAL,
+                          d.observe(1800.0f, 0.6f, steady_temp(t), t * 1000));
+    }
+    const float learned = d.baseline()[bin].n;
+
+    // +4 sigma: warning after the debounce, not learned
+    for (uint32_t k = 0; k < 2; k++, t++) {
+        TEST_ASSERT_EQUAL(ANOMALY_NORMAL, d.observe(1800.0f, 0.6f, 357.0f, t * 1000));
+    }
+    TEST_ASSERT_EQUAL(ANOMALY_WARN, d.observe(1800.0f, 0.6f, 357.0f, t++ * 1000));
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 4.0f, d.last_z());
+    TEST_ASSERT_EQUAL_FLOAT(learned, d.baseline()[bin].n);
+
+    // +8 sigma (impeller failing)
+    for (uint32_t k = 0; k < 3; k++, t++) d.observe(1800.0f, 0.6f, 361.0f, t * 1000);
+    TEST_ASSERT_EQUAL(ANOMALY_ALARM, d.level());
+
+    // Engine stopped: heat soak is not an anomaly
+    TEST_ASSERT_EQUAL(ANOMALY_NORMAL, d.observe(0.0f, 0.0f, 365.0f, t * 1000));
+}
+
+void test_packed_tables_roundtrip(void) {
+    ThermalAnomalyDetector d = make_detector();
+    for (uint32_t t = 0; t < 80; t++) d.observe(1800.0f, 0.6f, steady_temp(t), t * 1000);
+    const int bin = ThermalBaseline::bin_index(1800.0f, 0.6f);
+
+    ThermalBaselineRecord r;
+    d.baseline().pack(r.bins);
+    r.seal();
+    TEST_ASSERT_TRUE(r.valid());
+    TEST_ASSERT_EQUAL_UINT32(6 * ThermalBaseline::NUM_BINS, sizeof(r.bins));
+
+    ThermalBaseline restored;
+    restored.unpack(r.bins);
+    TEST_ASSERT_EQUAL_FLOAT(d.baseline()[bin].n, restored[bin].n);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, d.baseline()[bin].mean, restored[bin].mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, std::sqrt(d.baseline()[bin].var),
+                             std::sqrt(restored[bin].var));
+
+    r.bins[bin].mean_cK ^= 1;
+    TEST_ASSERT_FALSE(r.valid());
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Incremental statistics tests
+    RUN_TEST(test_welford_matches_batch_statistics);
+    RUN_TEST(test_saturated_count_follows_slow_drift);
+    RUN_TEST(test_bin_index_by_rpm_and_load);
+
+    // Detection tests
+    RUN_TEST(test_no_learning_during_warmup_or_settling);
+    RUN_TEST(test_sustained_deviation_raises_warn_then_alarm);
+    RUN_TEST(test_packed_tables_roundtrip);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,122 @@
+#include <unity.h>
+#include <Arduino.h>
+#include "../../src/vessel_state_listener.h"
+#include <cmath>
+
+// Tests for the inbound vessel-state coalescing (STW / SOG / AWS / AWA):
+// one notification per burst of deltas, decimated to min_period_ms.
+
+void setUp(void) {
+    // Setup
+}
+
+void tearDown(void) {
+    // Cleanup
+}
+
+// ============================================================================
+// TEST: Coalescing
+// ============================================================================
+
+void test_nothing_to_emit_without_updates(void) {
+    VesselStateCoalescer c(1000);
+    VesselState s;
+
+    TEST_ASSERT_FALSE(c.take(1000, s));
+    TEST_ASSERT_EQUAL_UINT32(0, c.emits());
+}
+
+void test_burst_of_deltas_is_one_update(void) {
+    VesselStateCoalescer c(1000);
+    VesselState s;
+
+    // One SK update carrying all four paths
+    c.update(VESSEL_STW, 2.5f);
+    c.update(VESSEL_SOG, 2.6f);
+    c.update(VESSEL_AWS, 6.0f);
+    c.update(VESSEL_AWA, 0.5f);
+
+    TEST_ASSERT_TRUE(c.take(1000, s));
+    TEST_ASSERT_FALSE(c.take(1000, s));   // same tick: nothing new
+    TEST_ASSERT_EQUAL_UINT32(4, c.updates());
+    TEST_ASSERT_EQUAL_UINT32(1, c.emits());
+
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, s.value[VESSEL_STW]);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, s.value[VESSEL_AWA]);
+    TEST_ASSERT_TRUE(s.is_fresh(VESSEL_SOG));
+}
+
+// ============================================================================
+// TEST: Decimation
+// ============================================================================
+
+void test_decimation_keeps_latest_value(void) {
+    VesselStateCoalescer c(1000);
+    VesselState s;
+
+    c.update(VESSEL_STW, 2.0f);
+    TEST_ASSERT_TRUE(c.take(1000, s));
+
+    // 10 Hz server: nine more deltas inside the period
+    for (int i = 1; i <= 9; i++) {
+        c.update(VESSEL_STW, 2.0f + 0.1f * i);
+        TEST_ASSERT_FALSE(c.take(1000 + 100 * i, s));
+    }
+
+    TEST_ASSERT_TRUE(c.take(2000, s));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.9f, s.value[VESSEL_STW]);
+    TEST_ASSERT_EQUAL_UINT32(2, c.emits());
+}
+
+void test_fresh_marks_only_updated_fields(void) {
+    VesselStateCoalescer c(0);
+    VesselState s;
+
+    c.update(VESSEL_STW, 2.0f);
+    c.update(VESSEL_AWS, 8.0f);
+    TEST_ASSERT_TRUE(c.take(1000, s));
+
+    c.update(VESSEL_SOG, 2.1f);
+    TEST_ASSERT_TRUE(c.take(1010, s));
+
+    TEST_ASSERT_TRUE(s.is_fresh(VESSEL_SOG));
+    TEST_ASSERT_FALSE(s.is_fresh(VESSEL_STW));
+    TEST_ASSERT_FALSE(s.is_fresh(VESSEL_AWS));
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, s.value[VESSEL_STW]);   // still carried
+}
+
+void test_null_value_is_forwarded_as_nan(void) {
+    VesselStateCoalescer c(0);
+    VesselState s;
+
+    c.update(VESSEL_AWA, NAN);   // "value": null on the server
+    TEST_ASSERT_TRUE(c.take(1000, s));
+
+    TEST_ASSERT_TRUE(s.is_fresh(VESSEL_AWA));
+    TEST_ASSERT_TRUE(std::isnan(s.value[VESSEL_AWA]));
+}
+
+// ============================================================================
+// MAIN - Run all tests
+// ============================================================================
+
+void setup() {
+    delay(2000);
+
+    UNITY_BEGIN();
+
+    // Coalescing tests
+    RUN_TEST(test_nothing_to_emit_without_updates);
+    RUN_TEST(test_burst_of_deltas_is_one_update);
+
+    // Decimation tests
+    RUN_TEST(test_decimation_keeps_latest_value);
+    RUN_TEST(test_fresh_marks_only_updated_fields);
+    RUN_TEST(test_null_value_is_forwarded_as_nan);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing
+}
@@ -0,0 +1,394 @@
+// ============================================================================
+// log_eval — host batch evaluation of the fuel / load model over logged data
+// ============================================================================
+//
+// • Runs engine_eval_batch() (src/engine_eval.h: the firmware's model in
+//   branchless form, same results as engine_eval() within float rounding)
+//   over a recorded log: curve / wind-coefficient calibration without a
+//   board or a boat
+// • Input, by extension:
+//     .bin  /api/datalog download (data_log.h): RPM from rev/s; STW / SOG /
+//           wind are not logged → NaN (baseline curve, no STW / wind
+//           correction, as on the device when they are stale); logged fuel
+//           + load are the reference
+//     .csv  header row, any of: rpm | rev_s, stw_kts, sog_kts, aws_kts,
+//           awa_rad | awa_deg, fuel_lph (reference, e.g. a flow meter),
+//           load (reference); missing columns / empty cells → NaN
+// • Prints samples, running share, mean fuel / load, RMS and bias vs the
+//   reference, and the batch throughput (M samples/s)
+// • --sweep <coeff>=<from>:<to>:<step> re-evaluates once per value and
+//   prints one line each (e.g. head=0.2:0.4:0.05 against a flow meter)
+//
+// Build (no board needed):
+//   pio run -e log_eval && .pio/build/log_eval/program engine_log.bin
+// or
+//   g++ -std=gnu++11 -O3 -fno-trapping-math -o log_eval tools/log_eval/log_eval.cpp
+// ============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../../src/data_log.h"
+#include "../../src/engine_eval.h"
+
+// ============================================================================
+// Samples (structure of arrays)
+// ============================================================================
+struct LogData {
+  std::vector<float> rpm, stw, sog, aws, awa;
+  std::vector<float> ref_fuel, ref_load;   // NaN = no reference
+
+  size_t size() const { return rpm.size(); }
+
+  void push(float r, float s, float g, float w, float a, float f, float l) {
+    rpm.push_back(r);
+    stw.push_back(s);
+    sog.push_back(g);
+    aws.push_back(w);
+    awa.push_back(a);
+    ref_fuel.push_back(f);
+    ref_load.push_back(l);
+  }
+};
+
+static bool ends_with(const std::string& s, const char* suffix) {
+  const size_t n = strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+// ============================================================================
+// Binary data log
+// ============================================================================
+static bool read_bin(const char* path, LogData& d) {
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "log_eval: cannot open %s\n", path);
+    return false;
+  }
+
+  LogFileHeader h;
+  if (fread(&h, sizeof(h), 1, f) != 1 || h.magic != RingLog::MAGIC ||
+      h.version != LOG_FILE_VERSION || h.record_bytes != sizeof(LogRecord)) {
+    fprintf(stderr, "log_eval: %s is not a v%u data log\n", path,
+            static_cast<unsigned>(LOG_FILE_VERSION));
+    fclose(f);
+    return false;
+  }
+
+  LogRecord rec;
+  size_t bad = 0;
+  while (fread(&rec, sizeof(rec), 1, f) == 1) {
+    if (!rec.valid()) {
+      bad++;
+      continue;
+    }
+    const float rev_s = LogRecord::unscale(rec.rev_s, LOG_RES_REV_S);
+    d.push(rev_s * 60.0f, NAN, NAN, NAN, NAN,
+           LogRecord::unscale(rec.fuel_lph, LOG_RES_FUEL),
+           LogRecord::unscale(rec.load, LOG_RES_LOAD));
+  }
+  fclose(f);
+
+  if (bad) fprintf(stderr, "log_eval: %zu records failed CRC, skipped\n", bad);
+  return true;
+}
+
+// ============================================================================
+// CSV
+// ============================================================================
+enum CsvColumn {
+  CSV_RPM, CSV_REV_S, CSV_STW, CSV_SOG, CSV_AWS, CSV_AWA_RAD, CSV_AWA_DEG,
+  CSV_FUEL, CSV_LOAD, CSV_IGNORED
+};
+
+static CsvColumn csv_column(const std::string& name) {
+  static const char* const NAMES[] = {
+    "rpm", "rev_s", "stw_kts", "sog_kts", "aws_kts", "awa_rad", "awa_deg",
+    "fuel_lph", "load"
+  };
+  for (int i = 0; i < CSV_IGNORED; i++) {
+    if (name == NAMES[i]) return static_cast<CsvColumn>(i);
+  }
+  return CSV_IGNORED;
+}
+
+static std::vector<std::string> split_csv(const std::string& line) {
+  std::vector<std::string> out;
+  std::string cell;
+  for (char c : line) {
+    if (c == ',') {
+      out.push_back(cell);
+      cell.clear();
+    } else if (c != '\r' && c != ' ' && c != '"') {
+      cell += c;
+    }
+  }
+  out.push_back(cell);
+  return out;
+}
+
+static float parse_cell(const std::string& s) {
+  if (s.empty()) return NAN;
+  char* end = nullptr;
+  const float v = strtof(s.c_str(), &end);
+  return (end && *end == '\0') ? v : NAN;   // "nan", "n/a", "-" → NaN
+}
+
+static bool read_csv(const char* path, LogData& d) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "log_eval: cannot open %s\n", path);
+    return false;
+  }
+
+  std::vector<CsvColumn> cols;
+  std::string line;
+  char buf[512];
+  bool header = true;
+
+  while (fgets(buf, sizeof(buf), f)) {
+    line += buf;
+    if (line.empty() || line[line.size() - 1] != '\n') continue;   // long line
+    line.erase(line.size() - 1);
+
+    const std::vector<std::string> cells = split_csv(line);
+    line.clear();
+
+    if (header) {
+      for (const std::string& c : cells) cols.push_back(csv_column(c));
+      header = false;
+      continue;
+    }
+
+    float v[CSV_IGNORED];
+    for (int i = 0; i < CSV_IGNORED; i++) v[i] = NAN;
+    for (size_t i = 0; i < cells.size() && i < cols.size(); i++) {
+      if (cols[i] != CSV_IGNORED) v[cols[i]] = parse_cell(cells[i]);
+    }
+
+    const float rpm = std::isnan(v[CSV_RPM]) ? v[CSV_REV_S] * 60.0f : v[CSV_RPM];
+    const float awa = std::isnan(v[CSV_AWA_RAD])
+                          ? v[CSV_AWA_DEG] * (3.14159265f / 180.0f)
+                          : v[CSV_AWA_RAD];
+    d.push(rpm, v[CSV_STW], v[CSV_SOG], v[CSV_AWS], awa, v[CSV_FUEL],
+           v[CSV_LOAD]);
+  }
+  fclose(f);
+
+  bool has_rpm = false;
+  for (CsvColumn c : cols) has_rpm |= (c == CSV_RPM || c == CSV_REV_S);
+  if (!has_rpm) {
+    fprintf(stderr, "log_eval: %s has no rpm / rev_s column\n", path);
+    return false;
+  }
+  return true;
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+struct Summary {
+  size_t running   = 0;
+  double fuel_sum  = 0.0;
+  double load_sum  = 0.0;
+  size_t ref_fuel_n = 0, ref_load_n = 0;
+  double fuel_err2 = 0.0, fuel_bias = 0.0;
+  double load_err2 = 0.0;
+};
+
+static Summary summarize(const LogData& d, const std::vector<float>& fuel,
+                         const std::vector<float>& load) {
+  Summary s;
+  for (size_t i = 0; i < d.size(); i++) {
+    s.running  += engine_running(d.rpm[i]) ? 1 : 0;
+    s.fuel_sum += fuel[i];
+    s.load_sum += load[i];
+
+    if (!std::isnan(d.ref_fuel[i])) {
+      const double e = fuel[i] - d.ref_fuel[i];
+      s.fuel_err2 += e * e;
+      s.fuel_bias += e;
+      s.ref_fuel_n++;
+    }
+    if (!std::isnan(d.ref_load[i])) {
+      const double e = load[i] - d.ref_load[i];
+      s.load_err2 += e * e;
+      s.ref_load_n++;
+    }
+  }
+  return s;
+}
+
+static double rms(double err2, size_t n) { return n ? std::sqrt(err2 / n) : NAN; }
+
+// ============================================================================
+// Options
+// ============================================================================
+static float* wind_coeff(WindLoadCoeffs& k, const std::string& name) {
+  if (name == "min_kts")    return &k.min_kts;
+  if (name == "max_kts")    return &k.max_kts;
+  if (name == "head")       return &k.head;
+  if (name == "tail")       return &k.tail;
+  if (name == "cross")      return &k.cross;
+  if (name == "min_factor") return &k.min_factor;
+  if (name == "max_factor") return &k.max_factor;
+  return nullptr;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: log_eval [options] <engine_log.bin | samples.csv>\n"
+          "  --no-stw                  SOG only (UI \"use STW\" off)\n"
+          "  --wind <coeff>=<value>    min_kts max_kts head tail cross\n"
+          "                            min_factor max_factor\n"
+          "  --sweep <coeff>=<from>:<to>:<step>\n"
+          "  --out <file.csv>          per-sample rpm, fuel, load, reference\n"
+          "  --repeat <n>              batch passes for the throughput figure\n");
+}
+
+int main(int argc, char** argv) {
+  EngineEvalConfig cfg;
+  const char* in_path  = nullptr;
+  const char* out_path = nullptr;
+  unsigned    repeat   = 20;
+
+  std::string sweep_name;
+  float sweep_from = 0.0f, sweep_to = 0.0f, sweep_step = 0.0f;
+
+  for (int i = 1; i < argc; i++) {
+    const std::string a = argv[i];
+    const bool has_arg = i + 1 < argc;
+
+    if (a == "--no-stw") {
+      cfg.use_stw = false;
+    } else if ((a == "--wind" || a == "--sweep") && has_arg) {
+      const std::string spec = argv[++i];
+      const size_t eq = spec.find('=');
+      const std::string name = spec.substr(0, eq);
+      float* c = (eq == std::string::npos) ? nullptr : wind_coeff(cfg.wind, name);
+      if (!c) {
+        fprintf(stderr, "log_eval: unknown coefficient '%s'\n", name.c_str());
+        return 2;
+      }
+      if (a == "--wind") {
+        *c = strtof(spec.c_str() + eq + 1, nullptr);
+      } else if (sscanf(spec.c_str() + eq + 1, "%f:%f:%f", &sweep_from,
+                        &sweep_to, &sweep_step) != 3 || !(sweep_step > 0.0f)) {
+        fprintf(stderr, "log_eval: sweep needs <from>:<to>:<step>\n");
+        return 2;
+      } else {
+        sweep_name = name;
+      }
+    } else if (a == "--out" && has_arg) {
+      out_path = argv[++i];
+    } else if (a == "--repeat" && has_arg) {
+      repeat = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+      if (repeat < 1) repeat = 1;
+    } else if (a[0] != '-' && !in_path) {
+      in_path = argv[i];
+    } else {
+      usage();
+      return 2;
+    }
+  }
+
+  if (!in_path) {
+    usage();
+    return 2;
+  }
+
+  LogData d;
+  const bool ok = ends_with(in_path, ".csv") ? read_csv(in_path, d)
+                                             : read_bin(in_path, d);
+  if (!ok) return 1;
+  if (d.size() == 0) {
+    fprintf(stderr, "log_eval: %s has no samples\n", in_path);
+    return 1;
+  }
+
+  EngineCurveTable table;
+  if (!table.build_default()) {
+    fprintf(stderr, "log_eval: curve axis exceeds %u points, %zu dropped\n",
+            static_cast<unsigned>(EngineCurveTable::MAX_AXIS_POINTS),
+            table.dropped());
+    return 1;
+  }
+
+  const size_t n = d.size();
+  std::vector<float> fuel(n), load(n);
+  const EngineBatchInputs  in  = { d.rpm.data(), d.stw.data(), d.sog.data(),
+                                   d.aws.data(), d.awa.data() };
+  const EngineBatchOutputs out = { fuel.data(), load.data() };
+
+  // --------------------------------------------------------------------------
+  // Throughput (current coefficients)
+  // --------------------------------------------------------------------------
+  typedef std::chrono::steady_clock Clock;
+  const Clock::time_point t0 = Clock::now();
+  for (unsigned r = 0; r < repeat; r++) engine_eval_batch(table, cfg, in, out, n);
+  const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  const Summary s = summarize(d, fuel, load);
+
+  printf("samples      %zu (%.1f%% running)\n", n, 100.0 * s.running / n);
+  printf("mean fuel    %.3f L/h\n", s.fuel_sum / n);
+  printf("mean load    %.3f\n", s.load_sum / n);
+  if (s.ref_fuel_n) {
+    printf("fuel vs ref  rms %.3f L/h  bias %+.3f L/h  (%zu samples)\n",
+           rms(s.fuel_err2, s.ref_fuel_n), s.fuel_bias / s.ref_fuel_n,
+           s.ref_fuel_n);
+  }
+  if (s.ref_load_n) {
+    printf("load vs ref  rms %.4f  (%zu samples)\n",
+           rms(s.load_err2, s.ref_load_n), s.ref_load_n);
+  }
+  printf("throughput   %.1f M samples/s (%u passes, %.3f s)\n",
+         (secs > 0.0) ? (static_cast<double>(n) * repeat / secs) / 1e6 : 0.0,
+         repeat, secs);
+
+  // --------------------------------------------------------------------------
+  // Per-sample output
+  // --------------------------------------------------------------------------
+  if (out_path) {
+    FILE* f = fopen(out_path, "w");
+    if (!f) {
+      fprintf(stderr, "log_eval: cannot write %s\n", out_path);
+      return 1;
+    }
+    fprintf(f, "rpm,fuel_lph,load,ref_fuel_lph,ref_load\n");
+    for (size_t i = 0; i < n; i++) {
+      fprintf(f, "%.1f,%.3f,%.4f,%.3f,%.4f\n", d.rpm[i], fuel[i], load[i],
+              d.ref_fuel[i], d.ref_load[i]);
+    }
+    fclose(f);
+  }
+
+  // --------------------------------------------------------------------------
+  // One-coefficient sweep
+  // --------------------------------------------------------------------------
+  if (!sweep_name.empty()) {
+    printf("\n%-10s %10s %10s %12s %10s\n", sweep_name.c_str(), "fuel L/h",
+           "load", "fuel rms", "bias");
+
+    EngineEvalConfig c = cfg;
+    float* coeff = wind_coeff(c.wind, sweep_name);
+    const int steps =
+        static_cast<int>(std::floor((sweep_to - sweep_from) / sweep_step + 1e-4f));
+
+    for (int k = 0; k <= steps; k++) {
+      *coeff = sweep_from + k * sweep_step;
+      engine_eval_batch(table, c, in, out, n);
+      const Summary r = summarize(d, fuel, load);
+      printf("%-10.4f %10.3f %10.4f %12.4f %+10.4f\n", *coeff, r.fuel_sum / n,
+             r.load_sum / n, rms(r.fuel_err2, r.ref_fuel_n),
+             r.ref_fuel_n ? r.fuel_bias / r.ref_fuel_n : NAN);
+    }
+  }
+
+  return 0;
+}